@@ -0,0 +1,186 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Arena.cpp
+ *
+ * @brief Implementation file for the Arena class
+ *
+ * @details Implements the chunked arena and the arena of the running
+ *          statement, which startEvent releases when the statement ends
+ *
+ * @Note Requires Arena.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include "Arena.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef ARENA_CPP
+#define ARENA_CPP
+
+/**
+ * @brief statementArena
+ *
+ * @details returns the arena of the statement running on this thread
+ *
+ * @return Arena &
+ *
+ * @note None
+ */
+Arena &statementArena()
+{
+	static thread_local Arena arena;
+	return arena;
+}
+
+/**
+ * @brief Arena constructor
+ *
+ * @details no chunk is allocated until memory is asked for
+ *
+ * @note None
+ */
+Arena::Arena()
+{
+	current = NULL;
+	remaining = 0;
+}
+
+/**
+ * @brief Arena destructor
+ *
+ * @details frees every chunk
+ *
+ * @note None
+ */
+Arena::~Arena()
+{
+	release();
+	if( !chunks.empty() )
+	{
+		delete[] chunks[ 0 ];
+	}
+}
+
+/**
+ * @brief Arena allocate
+ *
+ * @details returns memory for size bytes that lives until release
+ *
+ * @par Algorithm the memory is taken from the end of the current chunk,
+ *      rounded up to ARENA_ALIGNMENT. A new chunk is started when the
+ *      current one is full, a request larger than a quarter of a chunk gets
+ *      a chunk of its own so the current chunk keeps its space
+ *
+ * @param [in] size_t size
+ *
+ * @return void *
+ *
+ * @note None
+ */
+void * Arena::allocate( size_t size )
+{
+	size = ( size + ARENA_ALIGNMENT - 1 ) & ~( ARENA_ALIGNMENT - 1 );
+	if( size > ARENA_CHUNK_SIZE / 4 )
+	{
+		char * chunk = new char[ size ];
+		largeChunks.push_back( chunk );
+		return chunk;
+	}
+	if( size > remaining )
+	{
+		current = new char[ ARENA_CHUNK_SIZE ];
+		remaining = ARENA_CHUNK_SIZE;
+		chunks.push_back( current );
+	}
+	void * memory = current;
+	current += size;
+	remaining -= size;
+	return memory;
+}
+
+/**
+ * @brief Arena copy
+ *
+ * @details copies bytes into the arena
+ *
+ * @param [in] const char * data
+ *
+ * @param [in] size_t length
+ *
+ * @return const char * the copy
+ *
+ * @note None
+ */
+const char * Arena::copy( const char * data, size_t length )
+{
+	char * memory = static_cast< char * >( allocate( length == 0 ? 1 : length ) );
+	memcpy( memory, data, length );
+	return memory;
+}
+
+/**
+ * @brief Arena release
+ *
+ * @details gives back everything allocated at once, the first chunk is kept
+ *          for the next statement
+ *
+ * @return None
+ *
+ * @note objects placed in the arena must already be destroyed
+ */
+void Arena::release()
+{
+	int chunkSize = chunks.size();
+	for( int index = 1; index < chunkSize; index++ )
+	{
+		delete[] chunks[ index ];
+	}
+	int largeSize = largeChunks.size();
+	for( int index = 0; index < largeSize; index++ )
+	{
+		delete[] largeChunks[ index ];
+	}
+	largeChunks.clear();
+
+	if( chunkSize > 0 )
+	{
+		chunks.resize( 1 );
+		current = chunks[ 0 ];
+		remaining = ARENA_CHUNK_SIZE;
+	}
+}
+
+/**
+ * @brief ArenaStringHash
+ *
+ * @details FNV-1a hash of the bytes of a value
+ *
+ * @param [in] const ArenaString &value
+ *
+ * @return size_t
+ *
+ * @note None
+ */
+size_t ArenaStringHash::operator()( const ArenaString &value ) const
+{
+	size_t hash = 14695981039346656037ULL;
+	for( size_t index = 0; index < value.length; index++ )
+	{
+		hash ^= (unsigned char) value.data[ index ];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool ArenaStringEqual::operator()( const ArenaString &left, const ArenaString &right ) const
+{
+	return left.length == right.length && memcmp( left.data, right.data, left.length ) == 0;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,101 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Arena.h
+ *
+ * @brief Definition file for the Arena class
+ *
+ * @details Specifies the arena memory of a statement. Row buffers, stored
+ *          tuples and parse nodes are carved out of large chunks and all of
+ *          them are released at once when the statement ends, so a query
+ *          makes a few chunk allocations instead of one per value
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef ARENA_H
+#define ARENA_H
+
+//bytes of a chunk, larger requests get a chunk of their own
+const size_t ARENA_CHUNK_SIZE = 1 << 16;
+//every allocation is aligned for any type
+const size_t ARENA_ALIGNMENT = alignof( max_align_t );
+
+class Arena{
+	public:
+		Arena();
+		~Arena();
+		void * allocate( size_t size );
+		const char * copy( const char * data, size_t length );
+		void release();
+
+	private:
+		//chunks of ARENA_CHUNK_SIZE, the last one is being filled
+		vector< char * > chunks;
+		vector< char * > largeChunks;
+		char * current;
+		size_t remaining;
+
+		Arena( const Arena &other );
+		Arena &operator=( const Arena &other );
+};
+
+//a value copied into an arena
+struct ArenaString{
+	const char * data;
+	size_t length;
+};
+
+struct ArenaStringHash{
+	size_t operator()( const ArenaString &value ) const;
+};
+
+struct ArenaStringEqual{
+	bool operator()( const ArenaString &left, const ArenaString &right ) const;
+};
+
+//allocator placing the elements of a container in an arena, memory is only
+//given back when the arena is released
+template< class T >
+class ArenaAllocator{
+	public:
+		typedef T value_type;
+		Arena * arena;
+
+		ArenaAllocator( Arena * owner )
+		{
+			arena = owner;
+		}
+		template< class U >
+		ArenaAllocator( const ArenaAllocator< U > &other )
+		{
+			arena = other.arena;
+		}
+		T * allocate( size_t count )
+		{
+			return static_cast< T * >( arena->allocate( count * sizeof( T ) ) );
+		}
+		void deallocate( T * memory, size_t count )
+		{
+		}
+		template< class U >
+		bool operator==( const ArenaAllocator< U > &other ) const
+		{
+			return arena == other.arena;
+		}
+		template< class U >
+		bool operator!=( const ArenaAllocator< U > &other ) const
+		{
+			return arena != other.arena;
+		}
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,298 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Catalog.cpp
+ *
+ * @brief Implementation file for the Catalog class
+ *
+ * @details Implements reading and writing the catalog files
+ *
+ * @Note Requires Catalog.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "Catalog.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CATALOG_CPP
+#define CATALOG_CPP
+
+//declaration of the helper functions
+bool writeDurable( const vector< string > &filePaths, const vector< string > &texts, bool append );
+
+/**
+ * @brief Catalog loadDatabases
+ *
+ * @details reads the databases from the catalog of the database system,
+ *          their tables are read when each is first used
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [out] vector< Database > &dbms
+ *
+ * @return bool false if there is no complete catalog, dbms is then empty
+ *
+ * @note None
+ */
+bool Catalog::loadDatabases( string databaseSystemPath, vector< Database > &dbms )
+{
+	dbms.clear();
+	istringstream in;
+	if( !readCatalog( databaseSystemPath + "/" + CATALOG_FILE_NAME, in ) )
+	{
+		return false;
+	}
+
+	string line;
+	while( getline( in, line ) )
+	{
+		size_t tab = line.find( '\t' );
+		if( tab != string::npos && line.substr( 0, tab ) == "database" )
+		{
+			Database database;
+			database.databaseName = line.substr( tab + 1 );
+			dbms.push_back( database );
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Catalog saveDatabases
+ *
+ * @details writes the databases to the catalog of the database system
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [in] vector< Database > &dbms
+ *
+ * @return bool false if the catalog could not be written, the directory is
+ *         then read the next time the database system starts
+ *
+ * @note called holding the catalog exclusively
+ */
+bool Catalog::saveDatabases( string databaseSystemPath, vector< Database > &dbms )
+{
+	ostringstream out;
+	int dbSize = dbms.size();
+	for( int db = 0; db < dbSize; db++ )
+	{
+		out << "database\t" << dbms[ db ].databaseName << "\n";
+	}
+	return writeCatalog( databaseSystemPath + "/" + CATALOG_FILE_NAME, out.str() );
+}
+
+/**
+ * @brief Catalog loadTables
+ *
+ * @details reads the tables of a database from its catalog
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [out] Database &database
+ *
+ * @return bool false if there is no complete catalog, the database then
+ *         has no tables
+ *
+ * @note None
+ */
+bool Catalog::loadTables( string databaseSystemPath, Database &database )
+{
+	database.tablesClear();
+	istringstream in;
+	if( !readCatalog( databaseSystemPath + "/" + database.databaseName + "/" + CATALOG_FILE_NAME, in ) )
+	{
+		return false;
+	}
+
+	string line;
+	while( getline( in, line ) )
+	{
+		size_t tab = line.find( '\t' );
+		string keyword = line.substr( 0, tab );
+		string value = ( tab == string::npos ) ? "" : line.substr( tab + 1 );
+
+		if( keyword == "table" )
+		{
+			Table table;
+			table.tableName = value;
+			database.tableAdd( table );
+		}
+		else if( keyword == "view" && !database.databaseTable.empty() )
+		{
+			database.databaseTable.back().viewQuery = value;
+		}
+		else if( keyword == "statistics" && !database.databaseTable.empty() )
+		{
+			string statistics;
+			int lineCount = atoi( value.c_str() );
+			for( int index = 0; index < lineCount && getline( in, line ); index++ )
+			{
+				statistics += line + "\n";
+			}
+			istringstream statisticsIn( statistics );
+			database.databaseTable.back().statistics.read( statisticsIn );
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Catalog saveTables
+ *
+ * @details writes the tables of a database to its catalog
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [in] Database &database - its tables are loaded
+ *
+ * @return bool false if the catalog could not be written, the directory is
+ *         then read the next time the database is used
+ *
+ * @note called holding the catalog exclusively, or while the database is
+ *       loaded
+ */
+bool Catalog::saveTables( string databaseSystemPath, Database &database )
+{
+	ostringstream out;
+	int tblSize = database.databaseTable.size();
+	for( int tbl = 0; tbl < tblSize; tbl++ )
+	{
+		Table &table = database.databaseTable[ tbl ];
+		out << "table\t" << table.tableName << "\n";
+		if( !table.viewQuery.empty() )
+		{
+			out << "view\t" << table.viewQuery << "\n";
+		}
+		if( table.statistics.analyzed )
+		{
+			ostringstream statistics;
+			table.statistics.write( statistics );
+			string statisticsText = statistics.str();
+			int lineCount = 1;
+			for( unsigned int index = 0; index < statisticsText.size(); index++ )
+			{
+				lineCount += ( statisticsText[ index ] == '\n' );
+			}
+			out << "statistics\t" << lineCount << "\n" << statisticsText << "\n";
+		}
+	}
+	return writeCatalog( databaseSystemPath + "/" + database.databaseName + "/" + CATALOG_FILE_NAME, out.str() );
+}
+
+/**
+ * @brief Catalog invalidate
+ *
+ * @details removes the catalog of the database system, and of a database,
+ *          before the directories change
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [in] string databaseName - empty for none
+ *
+ * @return None
+ *
+ * @note called holding the catalog exclusively
+ */
+void Catalog::invalidate( string databaseSystemPath, string databaseName )
+{
+	remove( ( databaseSystemPath + "/" + CATALOG_FILE_NAME ).c_str() );
+	if( !databaseName.empty() )
+	{
+		remove( ( databaseSystemPath + "/" + databaseName + "/" + CATALOG_FILE_NAME ).c_str() );
+	}
+}
+
+/**
+ * @brief Catalog readCatalog
+ *
+ * @details reads a catalog file at once
+ *
+ * @param [in] string catalogPath
+ *
+ * @param [out] istringstream &in - the lines after the header, up to the
+ *              final "end"
+ *
+ * @return bool false if there is no file or it is incomplete
+ *
+ * @note None
+ */
+bool Catalog::readCatalog( string catalogPath, istringstream &in )
+{
+	int fd = ::open( catalogPath.c_str(), O_RDONLY );
+	struct stat fileInfo;
+	if( fd < 0 || fstat( fd, &fileInfo ) != 0 )
+	{
+		if( fd >= 0 )
+		{
+			::close( fd );
+		}
+		return false;
+	}
+
+	string text( fileInfo.st_size, '\0' );
+	size_t textRead = 0;
+	while( textRead < text.size() )
+	{
+		ssize_t bytes = ::read( fd, &text[ textRead ], text.size() - textRead );
+		if( bytes <= 0 )
+		{
+			break;
+		}
+		textRead += bytes;
+	}
+	::close( fd );
+	text.resize( textRead );
+
+	string header = CATALOG_HEADER + "\n";
+	string footer = "end\n";
+	if( text.size() < header.size() + footer.size() || text.compare( 0, header.size(), header ) != 0 ||
+		text.compare( text.size() - footer.size(), footer.size(), footer ) != 0 )
+	{
+		return false;
+	}
+	in.str( text.substr( header.size(), text.size() - header.size() - footer.size() ) );
+	return true;
+}
+
+/**
+ * @brief Catalog writeCatalog
+ *
+ * @details replaces a catalog file
+ *
+ * @par Algorithm the catalog is written to a hidden file and made durable,
+ *      then renamed over the catalog, so it is either the old catalog or
+ *      the new one
+ *
+ * @param [in] string catalogPath
+ *
+ * @param [in] string text - the lines between the header and "end"
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool Catalog::writeCatalog( string catalogPath, string text )
+{
+	string tempPath = catalogPath + ".tmp";
+	text = CATALOG_HEADER + "\n" + text + "end\n";
+	if( !writeDurable( vector< string >( 1, tempPath ), vector< string >( 1, text ), false ) ||
+		rename( tempPath.c_str(), catalogPath.c_str() ) != 0 )
+	{
+		remove( tempPath.c_str() );
+		return false;
+	}
+	return true;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,58 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Catalog.h
+ *
+ * @brief Definition file for the Catalog class
+ *
+ * @details Specifies the catalog files of the database system. The catalog
+ *          of the database system lists its databases, the catalog of a
+ *          database lists its tables, the select of each materialized view
+ *          and the statistics of each analyzed table. Each is one file read
+ *          at once: the databases when the database system starts, the
+ *          tables of a database when it is first used. Statements that
+ *          create, drop or analyze write the catalogs again after they
+ *          change anything, replacing them by a rename. The catalogs are
+ *          removed before such a statement changes the directories, so a
+ *          database system that stopped in between finds none and rebuilds
+ *          them by reading the directories, as it does the first time
+ *
+ *          The first line is CATALOG_HEADER, then a line per database,
+ *          table, view select and statistics, each a keyword, a tab and its
+ *          value. Statistics are followed by the number of lines given.
+ *          The last line is "end", a catalog without it is incomplete
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "Database.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CATALOG_H
+#define CATALOG_H
+
+//the catalog in the database system directory and in each database
+//directory, hidden so it is not taken for a database or table
+const string CATALOG_FILE_NAME = ".catalog";
+const string CATALOG_HEADER = "catalog 1";
+
+class Catalog{
+	public:
+		static bool loadDatabases( string databaseSystemPath, vector< Database > &dbms );
+		static bool saveDatabases( string databaseSystemPath, vector< Database > &dbms );
+		static bool loadTables( string databaseSystemPath, Database &database );
+		static bool saveTables( string databaseSystemPath, Database &database );
+		static void invalidate( string databaseSystemPath, string databaseName );
+
+	private:
+		static bool readCatalog( string catalogPath, istringstream &in );
+		static bool writeCatalog( string catalogPath, string text );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,326 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Codec.cpp
+ *
+ * @brief Implementation file for the block compression codecs
+ *
+ * @details Implements the none and lz codecs and looking codecs up by id
+ *          and by name
+ *
+ * @Note Requires Codec.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include "Codec.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CODEC_CPP
+#define CODEC_CPP
+
+//declaration of the helper functions
+bool caseInsCompare( string s1, string s2 );
+
+const int LZ_MIN_MATCH = 4;
+//the last literals of a block are never part of a match, and a match does
+//not start in the last bytes of a block, as in LZ4
+const int LZ_LAST_LITERALS = 5;
+const int LZ_MATCH_LIMIT = 12;
+const int LZ_MAX_OFFSET = 65535;
+const int LZ_HASH_BITS = 14;
+
+/**
+ * @brief findCodec
+ *
+ * @details returns the codec with an id
+ *
+ * @param [in] unsigned char codecId
+ *
+ * @return Codec * NULL if there is no such codec
+ *
+ * @note every thread has its own codecs, they keep buffers between blocks
+ */
+Codec * findCodec( unsigned char codecId )
+{
+	static thread_local NoneCodec noneCodec;
+	static thread_local LzCodec lzCodec;
+
+	if( codecId == CODEC_NONE )
+	{
+		return &noneCodec;
+	}
+	else if( codecId == CODEC_LZ )
+	{
+		return &lzCodec;
+	}
+	return NULL;
+}
+
+/**
+ * @brief findCodec
+ *
+ * @details returns the codec with a name, in any case
+ *
+ * @param [in] string codecName
+ *
+ * @return Codec * NULL if there is no such codec
+ *
+ * @note None
+ */
+Codec * findCodec( string codecName )
+{
+	for( int codecId = CODEC_NONE; codecId <= CODEC_LZ; codecId++ )
+	{
+		Codec * codec = findCodec( (unsigned char) codecId );
+		if( caseInsCompare( codec->name(), codecName ) )
+		{
+			return codec;
+		}
+	}
+	return NULL;
+}
+
+unsigned char NoneCodec::id()
+{
+	return CODEC_NONE;
+}
+
+string NoneCodec::name()
+{
+	return "none";
+}
+
+void NoneCodec::compress( const char * data, size_t size, string &output )
+{
+	output.append( data, size );
+}
+
+bool NoneCodec::decompress( const char * data, size_t size, size_t rawSize, string &output )
+{
+	if( size != rawSize )
+	{
+		return false;
+	}
+	output.assign( data, size );
+	return true;
+}
+
+unsigned char LzCodec::id()
+{
+	return CODEC_LZ;
+}
+
+string LzCodec::name()
+{
+	return "lz";
+}
+
+/**
+ * @brief LzCodec compress
+ *
+ * @details compresses a block in the LZ4 block format
+ *
+ * @par Algorithm greedy parse: each 4 byte sequence is hashed into a table
+ *      of the last position it was seen at. If the sequence at that position
+ *      matches, the match is extended as far as it goes and emitted with the
+ *      literals before it as one sequence: a token holding both lengths (15
+ *      meaning more length bytes follow), the literals, a 2 byte offset and
+ *      the rest of the match length. Otherwise the position becomes a
+ *      literal
+ *
+ * @param [in] const char * data, size_t size
+ *
+ * @param [out] string &output - the compressed data is appended
+ *
+ * @return None
+ *
+ * @note None
+ */
+void LzCodec::compress( const char * data, size_t size, string &output )
+{
+	const unsigned char * input = (const unsigned char *) data;
+	size_t anchor = 0;
+	size_t position = 0;
+
+	positions.assign( 1 << LZ_HASH_BITS, -1 );
+	while( size >= (size_t) LZ_MATCH_LIMIT && position + LZ_MATCH_LIMIT <= size )
+	{
+		unsigned int sequence;
+		memcpy( &sequence, input + position, sizeof( sequence ) );
+		unsigned int hash = ( sequence * 2654435761u ) >> ( 32 - LZ_HASH_BITS );
+		int candidate = positions[ hash ];
+		positions[ hash ] = position;
+
+		unsigned int candidateSequence = 0;
+		if( candidate >= 0 )
+		{
+			memcpy( &candidateSequence, input + candidate, sizeof( candidateSequence ) );
+		}
+		if( candidate < 0 || position - candidate > (size_t) LZ_MAX_OFFSET || candidateSequence != sequence )
+		{
+			position++;
+			continue;
+		}
+
+		size_t matchLength = LZ_MIN_MATCH;
+		size_t matchEnd = size - LZ_LAST_LITERALS;
+		while( position + matchLength < matchEnd && input[ candidate + matchLength ] == input[ position + matchLength ] )
+		{
+			matchLength++;
+		}
+
+		size_t literalLength = position - anchor;
+		size_t extraMatch = matchLength - LZ_MIN_MATCH;
+		output += (char) ( ( min( literalLength, (size_t) 15 ) << 4 ) | min( extraMatch, (size_t) 15 ) );
+		if( literalLength >= 15 )
+		{
+			appendLength( literalLength - 15, output );
+		}
+		output.append( data + anchor, literalLength );
+		size_t offset = position - candidate;
+		output += (char) ( offset & 0xff );
+		output += (char) ( offset >> 8 );
+		if( extraMatch >= 15 )
+		{
+			appendLength( extraMatch - 15, output );
+		}
+
+		position += matchLength;
+		anchor = position;
+	}
+
+	size_t literalLength = size - anchor;
+	output += (char) ( min( literalLength, (size_t) 15 ) << 4 );
+	if( literalLength >= 15 )
+	{
+		appendLength( literalLength - 15, output );
+	}
+	output.append( data + anchor, literalLength );
+}
+
+/**
+ * @brief LzCodec decompress
+ *
+ * @details decompresses a block compressed by compress
+ *
+ * @par Algorithm every length and offset is checked against the bounds of
+ *      the input and of the rawSize output before it is used, so a corrupt
+ *      block is reported rather than read or written past
+ *
+ * @param [in] const char * data, size_t size
+ *
+ * @param [in] size_t rawSize
+ *
+ * @param [out] string &output
+ *
+ * @return bool false if the block is not valid
+ *
+ * @note None
+ */
+bool LzCodec::decompress( const char * data, size_t size, size_t rawSize, string &output )
+{
+	const unsigned char * input = (const unsigned char *) data;
+	size_t inputPosition = 0;
+	size_t outputPosition = 0;
+
+	output.resize( rawSize );
+	while( inputPosition < size )
+	{
+		unsigned char token = input[ inputPosition++ ];
+		size_t literalLength = token >> 4;
+		if( literalLength == 15 )
+		{
+			unsigned char lengthByte;
+			do
+			{
+				if( inputPosition >= size )
+				{
+					return false;
+				}
+				lengthByte = input[ inputPosition++ ];
+				literalLength += lengthByte;
+			} while( lengthByte == 255 );
+		}
+		if( literalLength > size - inputPosition || literalLength > rawSize - outputPosition )
+		{
+			return false;
+		}
+		memcpy( &output[ 0 ] + outputPosition, data + inputPosition, literalLength );
+		inputPosition += literalLength;
+		outputPosition += literalLength;
+
+		//the last sequence has no match
+		if( inputPosition == size )
+		{
+			break;
+		}
+
+		if( size - inputPosition < 2 )
+		{
+			return false;
+		}
+		size_t offset = input[ inputPosition ] | ( input[ inputPosition + 1 ] << 8 );
+		inputPosition += 2;
+		size_t matchLength = token & 15;
+		if( matchLength == 15 )
+		{
+			unsigned char lengthByte;
+			do
+			{
+				if( inputPosition >= size )
+				{
+					return false;
+				}
+				lengthByte = input[ inputPosition++ ];
+				matchLength += lengthByte;
+			} while( lengthByte == 255 );
+		}
+		matchLength += LZ_MIN_MATCH;
+		if( offset == 0 || offset > outputPosition || matchLength > rawSize - outputPosition )
+		{
+			return false;
+		}
+
+		//byte by byte, a match may overlap the bytes it produces
+		char * target = &output[ 0 ] + outputPosition;
+		const char * source = target - offset;
+		for( size_t index = 0; index < matchLength; index++ )
+		{
+			target[ index ] = source[ index ];
+		}
+		outputPosition += matchLength;
+	}
+	return outputPosition == rawSize;
+}
+
+/**
+ * @brief LzCodec appendLength
+ *
+ * @details appends the part of a length that does not fit in a token, as
+ *          bytes of 255 followed by the remainder
+ *
+ * @param [in] size_t length
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void LzCodec::appendLength( size_t length, string &output )
+{
+	while( length >= 255 )
+	{
+		output += (char) 255;
+		length -= 255;
+	}
+	output += (char) length;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,69 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Codec.h
+ *
+ * @brief Definition file for the block compression codecs
+ *
+ * @details Specifies the interface the storage layer compresses the blocks
+ *          of a table file with, and the built in codecs: none, which
+ *          stores a block as it is, and lz, a fast byte oriented LZ77 codec
+ *          in the style of LZ4. A codec is identified in a table file by its
+ *          id and in statements by its name
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CODEC_H
+#define CODEC_H
+
+const unsigned char CODEC_NONE = 0;
+const unsigned char CODEC_LZ = 1;
+
+class Codec{
+	public:
+		virtual ~Codec()
+		{
+
+		}
+		virtual unsigned char id() = 0;
+		virtual string name() = 0;
+		//appends the compressed data to output
+		virtual void compress( const char * data, size_t size, string &output ) = 0;
+		//replaces output with the rawSize bytes data was compressed from,
+		//false if data is not valid
+		virtual bool decompress( const char * data, size_t size, size_t rawSize, string &output ) = 0;
+};
+
+class NoneCodec : public Codec{
+	public:
+		unsigned char id();
+		string name();
+		void compress( const char * data, size_t size, string &output );
+		bool decompress( const char * data, size_t size, size_t rawSize, string &output );
+};
+
+//LZ4 block format: sequences of literals followed by a match of at least
+//LZ_MIN_MATCH bytes at most 65535 bytes back
+class LzCodec : public Codec{
+	public:
+		unsigned char id();
+		string name();
+		void compress( const char * data, size_t size, string &output );
+		bool decompress( const char * data, size_t size, size_t rawSize, string &output );
+
+	private:
+		//last position of each hashed 4 byte sequence, reused between blocks
+		vector< int > positions;
+
+		void appendLength( size_t length, string &output );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -71,7 +71,7 @@ bool caseInsCompare( string s1, string s2 )
  */
 Database::Database()
 {
-
+	tablesLoaded = false;
 }
 
 /**
@@ -178,21 +178,12 @@ void Database::databaseUse()
 /**
  * @brief tableExists
  *
- * @details goes through tables to see if passed in table exists in current database	
- *          
- * @pre number of tables is found for current database
- *
- * @post if table exists, a boolean value of true is returned
- *
- * @par Algorithm Go through the tables and check if the tableName matches a table
- * 		stored in the database
- *      
- * @exception None
+ * @details finds a table of the database by name, in any case
  *
- * @param [in] string tblName - name of the table to see if it exists
+ * @param [in/out] string &tblName - name of the table, set to the name it
+ *                 was created with if it exists
  *
- * @param [in] int &tblReturn, the index at which the table was found in the vector of database tables is stored
- * @param [out] 
+ * @param [out] int &tblReturn - position of the table in databaseTable
  *
  * @return bool true if found, else false
  *
@@ -200,17 +191,64 @@ void Database::databaseUse()
  */
 bool Database::tableExists( string &tblName, int &tblReturn )
 {
-	int tblSize = databaseTable.size();
-	for( int index = 0; index < tblSize; index++ )
+	int position = tableIndex.find( tblName );
+	if( position < 0 )
 	{
-		if( caseInsCompare( databaseTable[ index ].tableName, tblName ) )
-		{
-			tblReturn = index;
-			tblName = databaseTable[ index ].tableName;
-			return true;
-		}
+		return false;
 	}
-	return false;
+	tblReturn = position;
+	tblName = databaseTable[ position ].tableName;
+	return true;
+}
+
+/**
+ * @brief tableAdd
+ *
+ * @details adds a table after the tables of the database
+ *
+ * @param [in] Table &table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Database::tableAdd( Table &table )
+{
+	tableIndex.add( table.tableName, databaseTable.size() );
+	databaseTable.push_back( table );
+}
+
+/**
+ * @brief tableRemove
+ *
+ * @details removes a table of the database, the tables after it move down
+ *          a position
+ *
+ * @param [in] int tblReturn - position of the table in databaseTable
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Database::tableRemove( int tblReturn )
+{
+	tableIndex.remove( databaseTable[ tblReturn ].tableName );
+	databaseTable.erase( databaseTable.begin() + tblReturn );
+}
+
+/**
+ * @brief tablesClear
+ *
+ * @details removes every table of the database
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Database::tablesClear()
+{
+	tableIndex.clear();
+	databaseTable.clear();
 }
 
 // Terminating precompiler directives  ////////////////////////////////////////
@@ -16,7 +16,8 @@
 
 using namespace std;
 
-#include "Table.cpp"
+#include "Table.h"
+#include "NameIndex.h"
 
 // Precompiler directives /////////////////////////////////////////////////////
 #ifndef DATABASE_H
@@ -25,7 +26,11 @@ using namespace std;
 class Database{
 	public: 
 		string databaseName;
+		//tables are added and removed with tableAdd and tableRemove, which
+		//keep them in tableIndex
 		vector <Table> databaseTable;
+		//false until the tables are read, when the database is first used
+		bool tablesLoaded;
 
 		Database();
 		~Database();
@@ -34,6 +39,13 @@ class Database{
 		void databaseAlter( string input );
 		void databaseUse();
 		bool tableExists( string &tblName, int &tblReturn );
+		void tableAdd( Table &table );
+		void tableRemove( int tblReturn );
+		void tablesClear();
+
+	private:
+		//positions of the tables in databaseTable by name
+		NameIndex tableIndex;
 };
 
 // Terminating precompiler directives  ////////////////////////////////////////
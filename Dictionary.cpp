@@ -0,0 +1,214 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Dictionary.cpp
+ *
+ * @brief Implementation file for the dictionaries of encoded attributes
+ *
+ * @details Implements looking up and adding values, and the saving and
+ *          loading of the dictionaries of a table
+ *
+ * @Note Requires Dictionary.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include "Dictionary.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef DICTIONARY_CPP
+#define DICTIONARY_CPP
+
+/**
+ * @brief getDictionaryPath
+ *
+ * @details returns the path of the file holding the dictionaries of a
+ *          table, hidden next to the table file like its statistics
+ *
+ * @param [in] string tableFilePath - full path to the table file
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getDictionaryPath( string tableFilePath )
+{
+	size_t slash = tableFilePath.rfind( '/' );
+	if( slash == string::npos )
+	{
+		return "." + tableFilePath + ".dict";
+	}
+	return tableFilePath.substr( 0, slash + 1 ) + "." + tableFilePath.substr( slash + 1 ) + ".dict";
+}
+
+/**
+ * @brief Dictionary lookup
+ *
+ * @details returns the code of a value
+ *
+ * @param [in] const char * data, size_t length - the stored text
+ *
+ * @return int the code, -1 if the value is not in the dictionary
+ *
+ * @note None
+ */
+int Dictionary::lookup( const char * data, size_t length ) const
+{
+	lookupKey.assign( data, length );
+	unordered_map< string, int >::const_iterator found = codes.find( lookupKey );
+	return ( found == codes.end() ) ? -1 : found->second;
+}
+
+int Dictionary::lookup( const string &value ) const
+{
+	unordered_map< string, int >::const_iterator found = codes.find( value );
+	return ( found == codes.end() ) ? -1 : found->second;
+}
+
+/**
+ * @brief Dictionary add
+ *
+ * @details returns the code of a value, adding it to the dictionary if it
+ *          is not in it yet
+ *
+ * @param [in] const string &value
+ *
+ * @return int the code
+ *
+ * @note codes are never reused, so adding a value keeps every stored code
+ *       valid
+ */
+int Dictionary::add( const string &value )
+{
+	int code = lookup( value );
+	if( code < 0 )
+	{
+		code = values.size();
+		values.push_back( value );
+		codes[ value ] = code;
+	}
+	return code;
+}
+
+/**
+ * @brief TableDictionary load
+ *
+ * @details reads dictionaries saved by save
+ *
+ * @param [in] string filePath - full path to the dictionary file
+ *
+ * @return bool false if the table has no encoded attributes
+ *
+ * @note None
+ */
+bool TableDictionary::load( string filePath )
+{
+	string line;
+	dictionaries.clear();
+
+	ifstream fin( filePath.c_str() );
+	while( getline( fin, line ) )
+	{
+		if( line.empty() )
+		{
+			continue;
+		}
+
+		Dictionary dictionary;
+		size_t start = 0;
+		size_t tab = line.find( '\t' );
+		dictionary.attributeName = line.substr( 0, tab );
+		while( tab != string::npos )
+		{
+			start = tab + 1;
+			tab = line.find( '\t', start );
+			dictionary.add( line.substr( start, tab == string::npos ? string::npos : tab - start ) );
+		}
+		dictionaries.push_back( dictionary );
+	}
+	fin.close();
+	return !dictionaries.empty();
+}
+
+/**
+ * @brief TableDictionary save
+ *
+ * @details writes the dictionaries to a file, or removes the file if no
+ *          attribute is encoded
+ *
+ * @par Algorithm one line per encoded attribute: its name then its values
+ *      in code order, separated by tabs. Stored values never hold a tab or
+ *      a newline. The file is written next to its final path then renamed
+ *      over it, so a reader never sees part of it
+ *
+ * @param [in] string filePath - full path to the dictionary file
+ *
+ * @return bool false if the file could not be written
+ *
+ * @note None
+ */
+bool TableDictionary::save( string filePath )
+{
+	if( dictionaries.empty() )
+	{
+		remove( filePath.c_str() );
+		return true;
+	}
+
+	string tempFilePath = filePath + ".tmp";
+	ofstream fout( tempFilePath.c_str() );
+	int dictionarySize = dictionaries.size();
+	for( int index = 0; index < dictionarySize; index++ )
+	{
+		Dictionary &dictionary = dictionaries[ index ];
+		if( index > 0 )
+		{
+			fout << "\n";
+		}
+		fout << dictionary.attributeName;
+
+		int valueSize = dictionary.values.size();
+		for( int code = 0; code < valueSize; code++ )
+		{
+			fout << "\t" << dictionary.values[ code ];
+		}
+	}
+	fout.close();
+	if( fout.fail() )
+	{
+		remove( tempFilePath.c_str() );
+		return false;
+	}
+	return rename( tempFilePath.c_str(), filePath.c_str() ) == 0;
+}
+
+/**
+ * @brief TableDictionary find
+ *
+ * @details returns the dictionary of an attribute
+ *
+ * @param [in] string attributeName
+ *
+ * @return Dictionary * NULL if the attribute is not encoded
+ *
+ * @note None
+ */
+Dictionary * TableDictionary::find( string attributeName )
+{
+	int dictionarySize = dictionaries.size();
+	for( int index = 0; index < dictionarySize; index++ )
+	{
+		if( dictionaries[ index ].attributeName == attributeName )
+		{
+			return &dictionaries[ index ];
+		}
+	}
+	return NULL;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,59 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Dictionary.h
+ *
+ * @brief Definition file for the dictionaries of encoded attributes
+ *
+ * @details Specifies the per table dictionaries of varchar attributes with
+ *          few distinct values. Such an attribute is stored in the table file
+ *          as the code of each value, the values themselves are kept once in
+ *          a hidden file next to the table. ANALYZE chooses which attributes
+ *          are encoded from their distinct counts
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+//string attributes with at most this many distinct values are encoded
+const int DICTIONARY_MAX_VALUES = 256;
+//and only if each value is stored this many times on average
+const int DICTIONARY_MIN_REPEATS = 4;
+
+class Dictionary{
+	public:
+		string attributeName;
+		//stored text of each value by code, quotes included
+		vector< string > values;
+
+		int lookup( const char * data, size_t length ) const;
+		int lookup( const string &value ) const;
+		int add( const string &value );
+
+	private:
+		unordered_map< string, int > codes;
+		//key of the last lookup, reused so that looking up does not allocate
+		mutable string lookupKey;
+};
+
+class TableDictionary{
+	public:
+		//one per encoded attribute, not added to once handed out
+		vector< Dictionary > dictionaries;
+
+		bool load( string filePath );
+		bool save( string filePath );
+		Dictionary * find( string attributeName );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
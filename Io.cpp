@@ -0,0 +1,485 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Io.cpp
+ *
+ * @brief Implementation file for asynchronous file reads and writes
+ *
+ * @details Implements the io_uring queue of a thread and the pool of
+ *          threads used in its place
+ *
+ * @Note Requires Io.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "Io.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef IO_CPP
+#define IO_CPP
+
+int IoQueue::backend = IO_BACKEND_URING;
+
+/**
+ * @brief runRequest
+ *
+ * @details carries out a request, waiting for it
+ *
+ * @param [in] IoRequest &request
+ *
+ * @return None
+ *
+ * @note None
+ */
+void runRequest( IoRequest &request )
+{
+	long long result;
+	do
+	{
+		if( request.operation == IO_READ )
+		{
+			result = pread( request.fd, request.data, request.size, request.offset );
+		}
+		else if( request.operation == IO_WRITE )
+		{
+			result = pwrite( request.fd, request.data, request.size, request.offset );
+		}
+		else
+		{
+			result = fsync( request.fd );
+		}
+	} while( result < 0 && errno == EINTR );
+	request.result = result < 0 ? -errno : result;
+}
+
+/**
+ * @brief getIoPool
+ *
+ * @details returns the pool shared by the queues not using io_uring, its
+ *          threads are started when it is first used
+ *
+ * @return IoPool &
+ *
+ * @note None
+ */
+IoPool &getIoPool()
+{
+	static IoPool pool;
+	return pool;
+}
+
+IoPool::IoPool()
+{
+	stopping = false;
+	for( int index = 0; index < IO_POOL_THREADS; index++ )
+	{
+		workers.push_back( thread( &IoPool::work, this ) );
+	}
+}
+
+IoPool::~IoPool()
+{
+	{
+		lock_guard< mutex > state( stateMutex );
+		stopping = true;
+		submitted.notify_all();
+	}
+	int workerSize = workers.size();
+	for( int index = 0; index < workerSize; index++ )
+	{
+		workers[ index ].join();
+	}
+}
+
+void IoPool::submit( IoRequest &request )
+{
+	lock_guard< mutex > state( stateMutex );
+	request.done = false;
+	requests.push_back( &request );
+	submitted.notify_one();
+}
+
+void IoPool::wait( IoRequest &request )
+{
+	unique_lock< mutex > state( stateMutex );
+	while( !request.done )
+	{
+		completed.wait( state );
+	}
+}
+
+/**
+ * @brief IoPool work
+ *
+ * @details carries out requests in the order they were submitted until the
+ *          pool is destroyed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void IoPool::work()
+{
+	unique_lock< mutex > state( stateMutex );
+	while( true )
+	{
+		while( requests.empty() && !stopping )
+		{
+			submitted.wait( state );
+		}
+		if( requests.empty() )
+		{
+			return;
+		}
+
+		IoRequest * request = requests.front();
+		requests.pop_front();
+		state.unlock();
+		runRequest( *request );
+		state.lock();
+		request->done = true;
+		completed.notify_all();
+	}
+}
+
+/**
+ * @brief IoQueue constructor
+ *
+ * @details opens an io_uring unless the thread pool is used
+ *
+ * @note None
+ */
+IoQueue::IoQueue()
+{
+	ringFd = -1;
+	submissionRing = MAP_FAILED;
+	completionRing = MAP_FAILED;
+	submissionEntries = MAP_FAILED;
+	inFlight = 0;
+	ringEntries = 0;
+	if( backend == IO_BACKEND_URING && !openRing() )
+	{
+		closeRing();
+	}
+}
+
+IoQueue::~IoQueue()
+{
+	while( inFlight > 0 && reap( true ) )
+	{
+
+	}
+	closeRing();
+}
+
+/**
+ * @brief IoQueue forThread
+ *
+ * @details returns the queue of the calling thread, each session has its own
+ *
+ * @return IoQueue &
+ *
+ * @note None
+ */
+IoQueue &IoQueue::forThread()
+{
+	static thread_local IoQueue queue;
+	return queue;
+}
+
+/**
+ * @brief IoQueue setBackend
+ *
+ * @details chooses io_uring or the thread pool for queues opened from now on
+ *
+ * @param [in] int backend - IO_BACKEND_URING or IO_BACKEND_THREADS
+ *
+ * @return None
+ *
+ * @note called before any session starts
+ */
+void IoQueue::setBackend( int ioBackend )
+{
+	backend = ioBackend;
+}
+
+bool IoQueue::usesRing()
+{
+	return ringFd >= 0;
+}
+
+/**
+ * @brief IoQueue openRing
+ *
+ * @details sets up an io_uring and maps its rings
+ *
+ * @return bool false if the kernel does not offer io_uring
+ *
+ * @note None
+ */
+bool IoQueue::openRing()
+{
+	struct io_uring_params params;
+	memset( &params, 0, sizeof( params ) );
+	ringFd = syscall( __NR_io_uring_setup, IO_RING_ENTRIES, &params );
+	if( ringFd < 0 )
+	{
+		return false;
+	}
+
+	submissionRingSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+	completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+	bool singleMap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+	if( singleMap )
+	{
+		submissionRingSize = max( submissionRingSize, completionRingSize );
+		completionRingSize = submissionRingSize;
+	}
+
+	submissionRing = mmap( NULL, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ringFd, IORING_OFF_SQ_RING );
+	if( submissionRing == MAP_FAILED )
+	{
+		return false;
+	}
+	if( !singleMap )
+	{
+		completionRing = mmap( NULL, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ringFd, IORING_OFF_CQ_RING );
+		if( completionRing == MAP_FAILED )
+		{
+			return false;
+		}
+	}
+	submissionEntriesSize = params.sq_entries * sizeof( struct io_uring_sqe );
+	submissionEntries = mmap( NULL, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ringFd, IORING_OFF_SQES );
+	if( submissionEntries == MAP_FAILED )
+	{
+		return false;
+	}
+
+	char * submission = (char *) submissionRing;
+	char * completion = (char *) ( singleMap ? submissionRing : completionRing );
+	submissionTail = (unsigned *) ( submission + params.sq_off.tail );
+	submissionMask = (unsigned *) ( submission + params.sq_off.ring_mask );
+	submissionArray = (unsigned *) ( submission + params.sq_off.array );
+	completionHead = (unsigned *) ( completion + params.cq_off.head );
+	completionTail = (unsigned *) ( completion + params.cq_off.tail );
+	completionMask = (unsigned *) ( completion + params.cq_off.ring_mask );
+	completions = completion + params.cq_off.cqes;
+	ringEntries = params.sq_entries;
+	return true;
+}
+
+void IoQueue::closeRing()
+{
+	if( submissionEntries != MAP_FAILED )
+	{
+		munmap( submissionEntries, submissionEntriesSize );
+	}
+	if( completionRing != MAP_FAILED )
+	{
+		munmap( completionRing, completionRingSize );
+	}
+	if( submissionRing != MAP_FAILED )
+	{
+		munmap( submissionRing, submissionRingSize );
+	}
+	if( ringFd >= 0 )
+	{
+		close( ringFd );
+	}
+	submissionRing = MAP_FAILED;
+	completionRing = MAP_FAILED;
+	submissionEntries = MAP_FAILED;
+	ringFd = -1;
+}
+
+/**
+ * @brief IoQueue submit
+ *
+ * @details starts a request without waiting for it
+ *
+ * @param [in] IoRequest &request
+ *
+ * @return None
+ *
+ * @note None
+ */
+void IoQueue::submit( IoRequest &request )
+{
+	request.done = false;
+	if( ringFd < 0 )
+	{
+		getIoPool().submit( request );
+		return;
+	}
+
+	//a full ring makes room by taking completions first
+	while( inFlight >= ringEntries && reap( true ) )
+	{
+
+	}
+	submitToRing( request );
+}
+
+/**
+ * @brief IoQueue submitToRing
+ *
+ * @details places a request in the submission ring and enters it
+ *
+ * @par Algorithm the entry is filled before the tail is moved past it with
+ *      a release store, so the kernel never sees it half written. The
+ *      request is found again from the completion by its address
+ *
+ * @param [in] IoRequest &request
+ *
+ * @return None
+ *
+ * @note None
+ */
+void IoQueue::submitToRing( IoRequest &request )
+{
+	unsigned tail = *submissionTail;
+	unsigned index = tail & *submissionMask;
+	struct io_uring_sqe * entry = (struct io_uring_sqe *) submissionEntries + index;
+	memset( entry, 0, sizeof( *entry ) );
+	entry->fd = request.fd;
+	entry->user_data = (unsigned long long) &request;
+	if( request.operation == IO_FSYNC )
+	{
+		entry->opcode = IORING_OP_FSYNC;
+	}
+	else
+	{
+		entry->opcode = request.operation == IO_READ ? IORING_OP_READ : IORING_OP_WRITE;
+		entry->addr = (unsigned long long) request.data;
+		entry->len = request.size;
+		entry->off = request.offset;
+	}
+	submissionArray[ index ] = index;
+	__atomic_store_n( submissionTail, tail + 1, __ATOMIC_RELEASE );
+	inFlight++;
+
+	long result;
+	do
+	{
+		result = syscall( __NR_io_uring_enter, ringFd, 1, 0, 0, NULL, 0 );
+	} while( result < 0 && errno == EINTR );
+	if( result < 0 )
+	{
+		//the kernel did not take it, the request is carried out here
+		__atomic_store_n( submissionTail, tail, __ATOMIC_RELEASE );
+		inFlight--;
+		runRequest( request );
+		request.done = true;
+	}
+}
+
+/**
+ * @brief IoQueue reap
+ *
+ * @details marks the requests whose completions arrived as done
+ *
+ * @param [in] bool block - waits for a completion if none arrived
+ *
+ * @return bool false if there was nothing to wait for
+ *
+ * @note None
+ */
+bool IoQueue::reap( bool block )
+{
+	while( true )
+	{
+		unsigned head = *completionHead;
+		unsigned tail = __atomic_load_n( completionTail, __ATOMIC_ACQUIRE );
+		if( head != tail )
+		{
+			while( head != tail )
+			{
+				struct io_uring_cqe * completion = (struct io_uring_cqe *) completions + ( head & *completionMask );
+				IoRequest * request = (IoRequest *) completion->user_data;
+				request->result = completion->res;
+				request->done = true;
+				inFlight--;
+				head++;
+			}
+			__atomic_store_n( completionHead, head, __ATOMIC_RELEASE );
+			return true;
+		}
+		if( !block || inFlight == 0 )
+		{
+			return false;
+		}
+		long result = syscall( __NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0 );
+		if( result < 0 && errno != EINTR )
+		{
+			return false;
+		}
+	}
+}
+
+/**
+ * @brief IoQueue wait
+ *
+ * @details waits until a submitted request is done. A write cut short is
+ *          submitted again for the rest of its bytes
+ *
+ * @param [in] IoRequest &request
+ *
+ * @return None
+ *
+ * @note request.result holds all the bytes written by then. The bytes are
+ *       counted in the metrics
+ */
+void IoQueue::wait( IoRequest &request )
+{
+	long long written = 0;
+	while( true )
+	{
+		if( ringFd < 0 )
+		{
+			getIoPool().wait( request );
+		}
+		while( !request.done && reap( true ) )
+		{
+
+		}
+		if( request.operation != IO_WRITE || request.result <= 0 || (size_t) request.result >= request.size )
+		{
+			break;
+		}
+		written += request.result;
+		request.data += request.result;
+		request.offset += request.result;
+		request.size -= request.result;
+		submit( request );
+	}
+	if( request.result >= 0 )
+	{
+		request.result += written;
+		if( request.operation != IO_FSYNC )
+		{
+			Metrics::count( request.operation == IO_READ ? METRIC_BYTES_READ : METRIC_BYTES_WRITTEN, request.result );
+		}
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,118 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Io.h
+ *
+ * @brief Definition file for asynchronous file reads and writes
+ *
+ * @details Specifies the queue a thread submits reads, writes and syncs of
+ *          table files to without waiting for each of them, so that several
+ *          are outstanding at once. The queue is an io_uring set up with the
+ *          raw system calls. Where io_uring is not available, or
+ *          --io threads is given, the requests are carried out by a pool of
+ *          threads shared by every queue
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef IO_H
+#define IO_H
+
+//operations of a request
+const int IO_READ = 0;
+const int IO_WRITE = 1;
+const int IO_FSYNC = 2;
+
+//backends of the queues
+const int IO_BACKEND_URING = 0;
+const int IO_BACKEND_THREADS = 1;
+
+//requests a thread's io_uring holds at once
+const unsigned IO_RING_ENTRIES = 64;
+//threads carrying out requests when io_uring is not used
+const int IO_POOL_THREADS = 4;
+
+//a read, write or sync of a file. The data must stay put until the request
+//is waited for
+struct IoRequest{
+	int operation;
+	int fd;
+	char * data;
+	size_t size;
+	long long offset;
+	//bytes read or written, or -errno
+	long long result;
+	bool done;
+};
+
+//threads carrying out the requests of every queue not using io_uring
+class IoPool{
+	public:
+		IoPool();
+		~IoPool();
+		void submit( IoRequest &request );
+		void wait( IoRequest &request );
+
+	private:
+		mutex stateMutex;
+		condition_variable submitted;
+		condition_variable completed;
+		deque< IoRequest * > requests;
+		vector< thread > workers;
+		bool stopping;
+
+		IoPool( const IoPool &other );
+		IoPool &operator=( const IoPool &other );
+		void work();
+};
+
+class IoQueue{
+	public:
+		IoQueue();
+		~IoQueue();
+		static IoQueue &forThread();
+		static void setBackend( int backend );
+		bool usesRing();
+		void submit( IoRequest &request );
+		void wait( IoRequest &request );
+
+	private:
+		int ringFd;
+		//mappings of the submission and completion rings and their entries
+		void * submissionRing;
+		size_t submissionRingSize;
+		void * completionRing;
+		size_t completionRingSize;
+		void * submissionEntries;
+		size_t submissionEntriesSize;
+		unsigned * submissionTail;
+		unsigned * submissionMask;
+		unsigned * submissionArray;
+		unsigned * completionHead;
+		unsigned * completionTail;
+		unsigned * completionMask;
+		void * completions;
+		unsigned inFlight;
+		unsigned ringEntries;
+		static int backend;
+
+		IoQueue( const IoQueue &other );
+		IoQueue &operator=( const IoQueue &other );
+		bool openRing();
+		void closeRing();
+		void submitToRing( IoRequest &request );
+		bool reap( bool block );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
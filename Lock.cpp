@@ -0,0 +1,427 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Lock.cpp
+ *
+ * @brief Implementation file for the locks of concurrent sessions
+ *
+ * @details Implements the read-write lock, the lock manager granting
+ *          database and table locks, and the locks of a statement
+ *
+ * @Note Requires Lock.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cctype>
+#include "Lock.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef LOCK_CPP
+#define LOCK_CPP
+
+//whether a lock in the mode of the row can be granted beside one in the
+//mode of the column
+const bool LOCK_COMPATIBLE[ LOCK_MODES ][ LOCK_MODES ] = {
+	{ true, true, false },
+	{ true, true, false },
+	{ false, false, false } };
+
+//locks of every session
+LockManager tableLocks;
+
+/**
+ * @brief getLockName
+ *
+ * @details returns the name a database or table is locked by, in lower case
+ *          as names are looked up in any case
+ *
+ * @param [in] string name
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getLockName( string name )
+{
+	int nameSize = name.size();
+	for( int index = 0; index < nameSize; index++ )
+	{
+		name[ index ] = tolower( name[ index ] );
+	}
+	return name;
+}
+
+ReadWriteLock::ReadWriteLock()
+{
+	readers = 0;
+	waitingWriters = 0;
+	writing = false;
+}
+
+void ReadWriteLock::lock()
+{
+	unique_lock< mutex > state( stateMutex );
+	waitingWriters++;
+	while( writing || readers > 0 )
+	{
+		changed.wait( state );
+	}
+	waitingWriters--;
+	writing = true;
+}
+
+void ReadWriteLock::unlock()
+{
+	lock_guard< mutex > state( stateMutex );
+	writing = false;
+	changed.notify_all();
+}
+
+void ReadWriteLock::lockShared()
+{
+	unique_lock< mutex > state( stateMutex );
+	while( writing || waitingWriters > 0 )
+	{
+		changed.wait( state );
+	}
+	readers++;
+}
+
+void ReadWriteLock::unlockShared()
+{
+	lock_guard< mutex > state( stateMutex );
+	readers--;
+	if( readers == 0 )
+	{
+		changed.notify_all();
+	}
+}
+
+ReadWriteGuard::ReadWriteGuard( ReadWriteLock &lock, bool exclusive ) : held( lock )
+{
+	heldExclusive = exclusive;
+	locked = false;
+	this->lock();
+}
+
+ReadWriteGuard::~ReadWriteGuard()
+{
+	unlock();
+}
+
+/**
+ * @brief ReadWriteGuard unlock
+ *
+ * @details releases the lock before the scope ends, lock takes it again
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ReadWriteGuard::unlock()
+{
+	if( !locked )
+	{
+		return;
+	}
+	locked = false;
+	if( heldExclusive )
+	{
+		held.unlock();
+	}
+	else
+	{
+		held.unlockShared();
+	}
+}
+
+void ReadWriteGuard::lock()
+{
+	if( locked )
+	{
+		return;
+	}
+	locked = true;
+	if( heldExclusive )
+	{
+		held.lock();
+	}
+	else
+	{
+		held.lockShared();
+	}
+}
+
+/**
+ * @brief LockManager acquire
+ *
+ * @details waits until a lock on the resource can be granted in the mode,
+ *          for at most waitSeconds. Waits are counted in the metrics
+ *
+ * @param [in] const string &resource
+ *
+ * @param [in] int mode - one of the LOCK_ constants
+ *
+ * @param [in] int waitSeconds - 0 to be refused at once
+ *
+ * @return bool true if the lock was granted
+ *
+ * @note None
+ */
+bool LockManager::acquire( const string &resource, int mode, int waitSeconds )
+{
+	chrono::steady_clock::time_point requested = chrono::steady_clock::now();
+	chrono::steady_clock::time_point deadline = requested + chrono::seconds( waitSeconds );
+	bool waited = false;
+	unique_lock< mutex > state( stateMutex );
+	while( true )
+	{
+		//looked up again after every wait, a release may have erased it
+		vector< int > &counts = granted[ resource ];
+		counts.resize( LOCK_MODES, 0 );
+
+		bool compatible = true;
+		for( int other = 0; other < LOCK_MODES; other++ )
+		{
+			compatible = compatible && ( counts[ other ] == 0 || LOCK_COMPATIBLE[ mode ][ other ] );
+		}
+		if( compatible )
+		{
+			counts[ mode ]++;
+			if( waited )
+			{
+				Metrics::count( METRIC_LOCK_WAITS );
+				Metrics::observe( HISTOGRAM_LOCK_WAIT,
+					chrono::duration< double >( chrono::steady_clock::now() - requested ).count() );
+			}
+			return true;
+		}
+		if( waitSeconds == 0 || released.wait_until( state, deadline ) == cv_status::timeout )
+		{
+			//the entry may only have been made by the lookup above
+			map< string, vector< int > >::iterator found = granted.find( resource );
+			bool unused = true;
+			for( int other = 0; found != granted.end() && other < LOCK_MODES; other++ )
+			{
+				unused = unused && found->second[ other ] == 0;
+			}
+			if( found != granted.end() && unused )
+			{
+				granted.erase( found );
+			}
+			if( waitSeconds > 0 )
+			{
+				Metrics::count( METRIC_LOCK_TIMEOUTS );
+				Metrics::observe( HISTOGRAM_LOCK_WAIT, waitSeconds );
+			}
+			return false;
+		}
+		waited = true;
+	}
+}
+
+/**
+ * @brief LockManager release
+ *
+ * @details gives back a lock granted by acquire
+ *
+ * @param [in] const string &resource
+ *
+ * @param [in] int mode
+ *
+ * @return None
+ *
+ * @note None
+ */
+void LockManager::release( const string &resource, int mode )
+{
+	lock_guard< mutex > state( stateMutex );
+	map< string, vector< int > >::iterator found = granted.find( resource );
+	if( found == granted.end() )
+	{
+		return;
+	}
+
+	found->second[ mode ]--;
+	bool unused = true;
+	for( int other = 0; other < LOCK_MODES; other++ )
+	{
+		unused = unused && found->second[ other ] == 0;
+	}
+	if( unused )
+	{
+		granted.erase( found );
+	}
+	released.notify_all();
+}
+
+StatementLocks::StatementLocks()
+{
+	waiting = true;
+	refusedMode = LOCK_EXCLUSIVE;
+}
+
+StatementLocks::~StatementLocks()
+{
+	releaseAll();
+}
+
+/**
+ * @brief StatementLocks lockResource
+ *
+ * @details locks a resource until the statement ends, unless it is held in
+ *          the mode already
+ *
+ * @param [in] const string &resource
+ *
+ * @param [in] int mode
+ *
+ * @return bool true if the resource is locked
+ *
+ * @note a transaction locks the same table for every statement
+ */
+bool StatementLocks::lockResource( const string &resource, int mode )
+{
+	int heldSize = held.size();
+	for( int index = 0; index < heldSize; index++ )
+	{
+		if( held[ index ].second == mode && held[ index ].first == resource )
+		{
+			return true;
+		}
+	}
+
+	if( !tableLocks.acquire( resource, mode, waiting ? LOCK_WAIT_SECONDS : 0 ) )
+	{
+		refusedResource = resource;
+		refusedMode = mode;
+		return false;
+	}
+	held.push_back( make_pair( resource, mode ) );
+	return true;
+}
+
+/**
+ * @brief StatementLocks lockDatabase
+ *
+ * @details locks a database until the statement ends
+ *
+ * @param [in] string databaseName
+ *
+ * @param [in] int mode
+ *
+ * @return bool true if the database is locked
+ *
+ * @note None
+ */
+bool StatementLocks::lockDatabase( string databaseName, int mode )
+{
+	return lockResource( getLockName( databaseName ), mode );
+}
+
+/**
+ * @brief StatementLocks lockTable
+ *
+ * @details locks a table until the statement ends
+ *
+ * @par Algorithm the database is locked first with the intent of the table
+ *      lock. Writers also lock the records of the table exclusively: every
+ *      write replaces or appends to the table file, so writers of one table
+ *      take turns while its readers carry on with their snapshots
+ *
+ * @param [in] string databaseName
+ *
+ * @param [in] string tableName
+ *
+ * @param [in] int mode - LOCK_INTENT_SHARED to read, LOCK_INTENT_EXCLUSIVE
+ *             to write the records, LOCK_EXCLUSIVE for DDL
+ *
+ * @return bool false if a lock was not granted in time, the locks granted
+ *         are kept until the statement ends
+ *
+ * @note None
+ */
+bool StatementLocks::lockTable( string databaseName, string tableName, int mode )
+{
+	string resource = getLockName( databaseName );
+	if( !lockResource( resource, mode == LOCK_INTENT_SHARED ? LOCK_INTENT_SHARED : LOCK_INTENT_EXCLUSIVE ) )
+	{
+		return false;
+	}
+
+	resource += "/" + getLockName( tableName );
+	if( !lockResource( resource, mode ) )
+	{
+		return false;
+	}
+	return mode != LOCK_INTENT_EXCLUSIVE || lockResource( resource + "/records", LOCK_EXCLUSIVE );
+}
+
+/**
+ * @brief StatementLocks setWaiting
+ *
+ * @details sets whether the locks asked for next wait for another session
+ *          to release them, or are refused at once
+ *
+ * @param [in] bool wait
+ *
+ * @return None
+ *
+ * @note a statement holding the catalog exclusively does not wait, every
+ *       other session would wait with it
+ */
+void StatementLocks::setWaiting( bool wait )
+{
+	waiting = wait;
+}
+
+/**
+ * @brief StatementLocks waitForRefused
+ *
+ * @details waits until the last lock refused could be granted, without
+ *          taking it
+ *
+ * @param [in] int waitSeconds
+ *
+ * @return bool false if it could not be granted in time
+ *
+ * @note None
+ */
+bool StatementLocks::waitForRefused( int waitSeconds )
+{
+	if( refusedResource.empty() || waitSeconds <= 0 || !tableLocks.acquire( refusedResource, refusedMode, waitSeconds ) )
+	{
+		return false;
+	}
+	tableLocks.release( refusedResource, refusedMode );
+	return true;
+}
+
+/**
+ * @brief StatementLocks releaseAll
+ *
+ * @details releases every lock, the last taken first
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatementLocks::releaseAll()
+{
+	while( !held.empty() )
+	{
+		tableLocks.release( held.back().first, held.back().second );
+		held.pop_back();
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
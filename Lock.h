@@ -0,0 +1,116 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Lock.h
+ *
+ * @brief Definition file for the locks of concurrent sessions
+ *
+ * @details Specifies the read-write lock, and the table locks a statement
+ *          takes. Readers never lock a table against writers: a select
+ *          reads a snapshot of the table files (see Storage.h), so it only
+ *          takes an intent lock that keeps DDL out of the table. Writers of
+ *          a table take turns, and DDL on a table waits for everyone
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef LOCK_H
+#define LOCK_H
+
+//modes of a lock: intent to read or to write what is inside a database or
+//table, and exclusive use of all of it
+const int LOCK_INTENT_SHARED = 0;
+const int LOCK_INTENT_EXCLUSIVE = 1;
+const int LOCK_EXCLUSIVE = 2;
+const int LOCK_MODES = 3;
+
+//longest wait for a lock, a transaction holds its locks across statements
+//so two of them may wait on each other and one has to give up
+const int LOCK_WAIT_SECONDS = 10;
+
+//lock held by many readers or one writer, a waiting writer holds back new
+//readers so that it is not starved
+class ReadWriteLock{
+	public:
+		ReadWriteLock();
+		void lock();
+		void unlock();
+		void lockShared();
+		void unlockShared();
+
+	private:
+		mutex stateMutex;
+		condition_variable changed;
+		int readers;
+		int waitingWriters;
+		bool writing;
+
+		ReadWriteLock( const ReadWriteLock &other );
+		ReadWriteLock &operator=( const ReadWriteLock &other );
+};
+
+//holds a ReadWriteLock for a scope
+class ReadWriteGuard{
+	public:
+		ReadWriteGuard( ReadWriteLock &lock, bool exclusive );
+		~ReadWriteGuard();
+		void unlock();
+		void lock();
+
+	private:
+		ReadWriteLock &held;
+		bool heldExclusive;
+		bool locked;
+
+		ReadWriteGuard( const ReadWriteGuard &other );
+		ReadWriteGuard &operator=( const ReadWriteGuard &other );
+};
+
+//granted locks on every resource, a resource is named by its path
+class LockManager{
+	public:
+		bool acquire( const string &resource, int mode, int waitSeconds );
+		void release( const string &resource, int mode );
+
+	private:
+		mutex stateMutex;
+		condition_variable released;
+		//count of granted locks in each mode
+		map< string, vector< int > > granted;
+};
+
+//locks of a statement or transaction, released when it ends
+class StatementLocks{
+	public:
+		StatementLocks();
+		~StatementLocks();
+		bool lockDatabase( string databaseName, int mode );
+		bool lockTable( string databaseName, string tableName, int mode );
+		void setWaiting( bool wait );
+		bool waitForRefused( int waitSeconds );
+		void releaseAll();
+
+	private:
+		vector< pair< string, int > > held;
+		//false to be refused a lock held by another at once
+		bool waiting;
+		//the last lock refused
+		string refusedResource;
+		int refusedMode;
+
+		bool lockResource( const string &resource, int mode );
+		StatementLocks( const StatementLocks &other );
+		StatementLocks &operator=( const StatementLocks &other );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
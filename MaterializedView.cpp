@@ -0,0 +1,837 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file MaterializedView.cpp
+ *
+ * @brief Implementation file for the MaterializedView class
+ *
+ * @details Implements creating materialized views and bringing them up to
+ *          date with the changes of the tables they read
+ *
+ * @Note Requires MaterializedView.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include "MaterializedView.h"
+#include "Storage.h"
+#include "Operator.h"
+#include "Row.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef MATERIALIZEDVIEW_CPP
+#define MATERIALIZEDVIEW_CPP
+
+//declaration of the helper functions
+string getNextWord( string &input );
+void convertToUC( string &input );
+bool caseInsCompare( string s1, string s2 );
+string getQueryType( string &input );
+string getWhereCondition( string &input );
+void getLimitCondition( string &input, QueryLimit &qLimit );
+bool getJoinTables( string input, vector< JoinTable > &joinTables );
+vector< string > tokenizeCondition( string input );
+string getAttributeLine( vector< Attribute > &attributes );
+string getTupleText( Row &tuple );
+string getTupleLine( Row &tuple );
+bool encodeValues( TableScan &scan, vector< string > &values );
+string getTempPath( string tableFilePath );
+string getDictionaryPath( string tableFilePath );
+bool publishTable( string tempFilePath, string filePath );
+bool appendTableLine( string filePath, const string &line );
+
+/**
+ * @brief getViewPath
+ *
+ * @details returns the path of the file holding the select of a
+ *          materialized view, it is hidden so that it is not loaded as a
+ *          table
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] string viewName
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getViewPath( string currentWorkingDirectory, string currentDatabase, string viewName )
+{
+	return currentWorkingDirectory + "/" + currentDatabase + "/." + viewName + ".view";
+}
+
+/**
+ * @brief splitRecord
+ *
+ * @details splits the text of a record into its values
+ *
+ * @param [in] const string &record
+ *
+ * @return vector< string >
+ *
+ * @note None
+ */
+vector< string > splitRecord( const string &record )
+{
+	vector< string > values;
+	size_t start = 0;
+	size_t tab = record.find( '\t' );
+	while( tab != string::npos )
+	{
+		values.push_back( record.substr( start, tab - start ) );
+		start = tab + 1;
+		tab = record.find( '\t', start );
+	}
+	values.push_back( record.substr( start ) );
+	return values;
+}
+
+/**
+ * @brief joinRecord
+ *
+ * @details joins the values of a record into a line
+ *
+ * @param [in] const vector< string > &values
+ *
+ * @return string
+ *
+ * @note None
+ */
+string joinRecord( const vector< string > &values )
+{
+	string line;
+	int valueSize = values.size();
+	for( int index = 0; index < valueSize; index++ )
+	{
+		line += values[ index ];
+		if( index != valueSize - 1 )
+		{
+			line += '\t';
+		}
+	}
+	return line;
+}
+
+/**
+ * @brief MaterializedView constructor
+ *
+ * @param [in] string currentWorkingDirectory, string currentDatabase
+ *
+ * @param [in] Database &viewDatabase - the database of the view, the
+ *             tables it reads are looked up in it
+ *
+ * @param [in] Table &viewTable - the view, its viewQuery is its select
+ *
+ * @note parse must succeed before the view is used
+ */
+MaterializedView::MaterializedView( string currentWorkingDirectory, string currentDatabase, Database &viewDatabase,
+	Table &viewTable ) : database( viewDatabase ), view( viewTable )
+{
+	databasePath = currentWorkingDirectory + "/" + currentDatabase + "/";
+	viewFilePath = databasePath + view.tableName;
+	definitionPath = getViewPath( currentWorkingDirectory, currentDatabase, view.tableName );
+	incremental = false;
+}
+
+/**
+ * @brief MaterializedView parse
+ *
+ * @details parses the select of the view and finds the tables it reads
+ *
+ * @par Algorithm the select is parsed the way a query is. The view is
+ *      brought up to date incrementally if its tables are inner joined,
+ *      each read once, and it has no limit; otherwise it is run again in
+ *      full
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool false if the select is not one the view can hold
+ *
+ * @note None
+ */
+bool MaterializedView::parse( string &errorMessage )
+{
+	string input = view.viewQuery;
+	string word = getNextWord( input );
+	convertToUC( word );
+	if( word != "SELECT" )
+	{
+		errorMessage = "its query is not a select";
+		return false;
+	}
+
+	getLimitCondition( input, qLimit );
+	queryType = getQueryType( input );
+	whereType = getWhereCondition( input );
+	if( queryType.empty() || !getJoinTables( input, joinTables ) )
+	{
+		errorMessage = "its select is incorrect";
+		return false;
+	}
+
+	incremental = ( qLimit.rowLimit == NO_LIMIT && qLimit.rowOffset == 0 );
+	int tableSize = joinTables.size();
+	for( int index = 0; index < tableSize; index++ )
+	{
+		int tblReturn;
+		if( !database.tableExists( joinTables[ index ].tableName, tblReturn ) )
+		{
+			errorMessage = "table " + joinTables[ index ].tableName + " does not exist";
+			return false;
+		}
+		joinTables[ index ].tableName = database.databaseTable[ tblReturn ].tableName;
+		joinTables[ index ].statistics = &database.databaseTable[ tblReturn ].statistics;
+		if( caseInsCompare( joinTables[ index ].tableName, view.tableName ) )
+		{
+			errorMessage = "it reads itself";
+			return false;
+		}
+
+		if( joinTables[ index ].joinType != JOIN_INNER )
+		{
+			incremental = false;
+		}
+		for( int other = 0; other < index; other++ )
+		{
+			if( joinTables[ other ].tableName == joinTables[ index ].tableName )
+			{
+				incremental = false;
+			}
+		}
+	}
+	return true;
+}
+
+bool MaterializedView::dependsOn( string tblName )
+{
+	int tableSize = joinTables.size();
+	for( int index = 0; index < tableSize; index++ )
+	{
+		if( caseInsCompare( joinTables[ index ].tableName, tblName ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void MaterializedView::getTables( vector< string > &tblNames )
+{
+	tblNames.clear();
+	int tableSize = joinTables.size();
+	for( int index = 0; index < tableSize; index++ )
+	{
+		tblNames.push_back( joinTables[ index ].tableName );
+	}
+}
+
+/**
+ * @brief MaterializedView getColumns
+ *
+ * @details returns the attributes of the view, those of the result of its
+ *          select. An attribute named like one before it is prefixed with
+ *          its table variable, or table, and an underscore
+ *
+ * @param [in] JoinPlanner &planner - planned with the select of the view
+ *
+ * @param [out] vector< Attribute > &columns
+ *
+ * @return None
+ *
+ * @note None
+ */
+void MaterializedView::getColumns( JoinPlanner &planner, vector< Attribute > &columns )
+{
+	columns = planner.root->attributes;
+
+	//the qualifier of each attribute selected, "" if it was not qualified
+	vector< string > qualifiers;
+	vector< string > selected = tokenizeCondition( queryType );
+	if( selected.size() == 1 && selected[ 0 ] == "*" )
+	{
+		qualifiers = planner.qualifiers;
+	}
+	else
+	{
+		int selectedSize = selected.size();
+		for( int index = 0; index < selectedSize; index++ )
+		{
+			if( selected[ index ] != "," )
+			{
+				size_t dot = selected[ index ].find( '.' );
+				qualifiers.push_back( dot == string::npos ? "" : selected[ index ].substr( 0, dot ) );
+			}
+		}
+	}
+
+	int columnSize = columns.size();
+	for( int index = 0; index < columnSize; index++ )
+	{
+		columns[ index ].dictionary = NULL;
+		for( int other = 0; other < index; other++ )
+		{
+			if( caseInsCompare( columns[ other ].attributeName, columns[ index ].attributeName ) )
+			{
+				string qualifier = index < (int) qualifiers.size() ? qualifiers[ index ] : "";
+				columns[ index ].attributeName = ( qualifier.empty() ? view.tableName : qualifier ) + "_" +
+					columns[ index ].attributeName;
+				other = -1;
+			}
+		}
+	}
+}
+
+/**
+ * @brief MaterializedView refresh
+ *
+ * @details runs the select of the view and replaces its records with the
+ *          result
+ *
+ * @par Algorithm the view keeps its codec, and its dictionaries if its
+ *      attributes are unchanged. They are dropped if the attributes changed,
+ *      such as after a table it reads was altered
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MaterializedView::refresh( string &errorMessage )
+{
+	JoinPlanner planner;
+	if( !planner.plan( databasePath, joinTables, whereType, queryType, qLimit, errorMessage ) )
+	{
+		return false;
+	}
+	vector< Attribute > columns;
+	getColumns( planner, columns );
+	string attributeLine = getAttributeLine( columns );
+
+	struct stat fileStatus;
+	bool exists = ( stat( viewFilePath.c_str(), &fileStatus ) == 0 );
+	TableScan current( viewFilePath );
+	bool sameAttributes = exists && getAttributeLine( current.attributes ) == attributeLine;
+	unsigned char codec = exists ? current.codec : DEFAULT_TABLE_CODEC;
+
+	string tempFilePath = getTempPath( viewFilePath );
+	TableWriter writer;
+	if( !writer.open( tempFilePath, codec, attributeLine ) )
+	{
+		errorMessage = "it could not be written";
+		return false;
+	}
+	Row tuple;
+	bool dictionaryChanged = false;
+	Operator * root = planner.root;
+	root->open();
+	while( root->next( tuple ) )
+	{
+		string record = getTupleText( tuple );
+		if( sameAttributes && !current.dictionary.dictionaries.empty() )
+		{
+			vector< string > values = splitRecord( record );
+			dictionaryChanged = encodeValues( current, values ) || dictionaryChanged;
+			record = joinRecord( values );
+		}
+		writer.writeLine( record );
+	}
+	root->close();
+
+	if( !writer.close() || ( dictionaryChanged && !current.dictionary.save( getDictionaryPath( viewFilePath ) ) ) ||
+		!publishTable( tempFilePath, viewFilePath ) )
+	{
+		remove( tempFilePath.c_str() );
+		errorMessage = "it could not be written";
+		return false;
+	}
+	if( !sameAttributes )
+	{
+		remove( getDictionaryPath( viewFilePath ).c_str() );
+	}
+	return true;
+}
+
+/**
+ * @brief MaterializedView run
+ *
+ * @details runs the select of the view with some records in place of one
+ *          of its tables
+ *
+ * @par Algorithm the records are written to a hidden file with the
+ *      attributes of the table, which the select reads instead of the
+ *      table. The file is removed once the select ran
+ *
+ * @param [in] int deltaTable - index of the table in the from clause
+ *
+ * @param [in] const vector< string > &deltaRecords - as getTupleText
+ *             formats them
+ *
+ * @param [out] vector< string > &records - the result, formatted the same
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MaterializedView::run( int deltaTable, const vector< string > &deltaRecords, vector< string > &records,
+	string &errorMessage )
+{
+	records.clear();
+	if( deltaRecords.empty() )
+	{
+		return true;
+	}
+
+	string deltaFilePath = databasePath + "." + view.tableName + ".delta";
+	TableScan table( databasePath + joinTables[ deltaTable ].tableName );
+	TableWriter writer;
+	bool written = writer.open( deltaFilePath, CODEC_NONE, getAttributeLine( table.attributes ) );
+	int recordSize = deltaRecords.size();
+	for( int index = 0; index < recordSize && written; index++ )
+	{
+		writer.writeLine( deltaRecords[ index ] );
+	}
+	if( !written || !writer.close() )
+	{
+		remove( deltaFilePath.c_str() );
+		errorMessage = "its changes could not be written";
+		return false;
+	}
+
+	vector< JoinTable > tables = joinTables;
+	tables[ deltaTable ].filePath = deltaFilePath;
+	JoinPlanner planner;
+	bool planned = planner.plan( databasePath, tables, whereType, queryType, qLimit, errorMessage );
+	if( planned )
+	{
+		Row tuple;
+		Operator * root = planner.root;
+		root->open();
+		while( root->next( tuple ) )
+		{
+			records.push_back( getTupleText( tuple ) );
+		}
+		root->close();
+	}
+	remove( deltaFilePath.c_str() );
+	return planned;
+}
+
+/**
+ * @brief MaterializedView removeRecords
+ *
+ * @details removes records from the view, each once
+ *
+ * @param [in] const vector< string > &records - as getTupleText formats
+ *             them
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool false if the view does not hold every record or could not
+ *         be written, it is then unchanged
+ *
+ * @note None
+ */
+bool MaterializedView::removeRecords( const vector< string > &records, string &errorMessage )
+{
+	if( records.empty() )
+	{
+		return true;
+	}
+	map< string, int > remaining;
+	int recordSize = records.size();
+	for( int index = 0; index < recordSize; index++ )
+	{
+		remaining[ records[ index ] ]++;
+	}
+
+	Row tuple;
+	int removed = 0;
+	TableScan scan( viewFilePath );
+	string tempFilePath = getTempPath( viewFilePath );
+	TableWriter writer;
+	writer.open( tempFilePath, scan.codec, getAttributeLine( scan.attributes ) );
+	scan.open();
+	while( scan.next( tuple ) )
+	{
+		map< string, int >::iterator found = remaining.find( getTupleText( tuple ) );
+		if( found != remaining.end() && found->second > 0 )
+		{
+			found->second--;
+			removed++;
+		}
+		else
+		{
+			writer.writeLine( getTupleLine( tuple ) );
+		}
+	}
+	scan.close();
+
+	if( !writer.close() || removed != recordSize || !publishTable( tempFilePath, viewFilePath ) )
+	{
+		remove( tempFilePath.c_str() );
+		errorMessage = removed != recordSize ? "it is out of date" : "it could not be written";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief MaterializedView addRecords
+ *
+ * @details appends records to the view
+ *
+ * @param [in] const vector< string > &records - as getTupleText formats
+ *             them
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MaterializedView::addRecords( const vector< string > &records, string &errorMessage )
+{
+	if( records.empty() )
+	{
+		return true;
+	}
+
+	//values of encoded attributes are stored as their codes, new values are
+	//added to the dictionary before the records refer to them
+	TableScan scan( viewFilePath );
+	bool dictionaryChanged = false;
+	vector< string > lines;
+	int recordSize = records.size();
+	for( int index = 0; index < recordSize; index++ )
+	{
+		vector< string > values = splitRecord( records[ index ] );
+		dictionaryChanged = encodeValues( scan, values ) || dictionaryChanged;
+		lines.push_back( joinRecord( values ) );
+	}
+	if( dictionaryChanged && !scan.dictionary.save( getDictionaryPath( viewFilePath ) ) )
+	{
+		errorMessage = "its dictionary could not be saved";
+		return false;
+	}
+
+	for( int index = 0; index < recordSize; index++ )
+	{
+		if( !appendTableLine( viewFilePath, lines[ index ] ) )
+		{
+			errorMessage = "it could not be written";
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief MaterializedView apply
+ *
+ * @details brings the view up to date with the changes a statement made
+ *          to one of its tables
+ *
+ * @par Algorithm the select is run with the records deleted in place of
+ *      the table, and its result removed from the view, then with the
+ *      records inserted, and its result added. A view that is not
+ *      incremental, or does not hold every record to remove, is refreshed
+ *
+ * @param [in] string tblName - the table changed
+ *
+ * @param [in] TableDelta &delta - its changes
+ *
+ * @param [out] TableDelta &viewDelta - the changes made to the view
+ *
+ * @param [out] bool &refreshed - true if the view was refreshed instead,
+ *              viewDelta is then empty
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MaterializedView::apply( string tblName, TableDelta &delta, TableDelta &viewDelta, bool &refreshed,
+	string &errorMessage )
+{
+	refreshed = false;
+	int deltaTable = 0;
+	int tableSize = joinTables.size();
+	while( deltaTable < tableSize && !caseInsCompare( joinTables[ deltaTable ].tableName, tblName ) )
+	{
+		deltaTable++;
+	}
+	if( deltaTable == tableSize )
+	{
+		return true;
+	}
+
+	if( incremental )
+	{
+		if( !run( deltaTable, delta.deleted, viewDelta.deleted, errorMessage ) ||
+			!run( deltaTable, delta.inserted, viewDelta.inserted, errorMessage ) )
+		{
+			return false;
+		}
+		if( removeRecords( viewDelta.deleted, errorMessage ) )
+		{
+			return addRecords( viewDelta.inserted, errorMessage );
+		}
+	}
+
+	viewDelta.deleted.clear();
+	viewDelta.inserted.clear();
+	refreshed = true;
+	return refresh( errorMessage );
+}
+
+/**
+ * @brief MaterializedView create
+ *
+ * @details creates a materialized view holding the result of a select and
+ *          adds it to the database
+ *
+ * @param [in] string currentWorkingDirectory, string currentDatabase
+ *
+ * @param [in] Database &database
+ *
+ * @param [in] string viewName
+ *
+ * @param [in] string query - the select
+ *
+ * @param [out] string &errorMessage
+ *
+ * @return bool
+ *
+ * @note the caller holds the catalog exclusively
+ */
+bool MaterializedView::create( string currentWorkingDirectory, string currentDatabase, Database &database,
+	string viewName, string query, string &errorMessage )
+{
+	Table view;
+	view.tableName = viewName;
+	view.viewQuery = query;
+	MaterializedView materialized( currentWorkingDirectory, currentDatabase, database, view );
+	if( !materialized.parse( errorMessage ) || !materialized.refresh( errorMessage ) )
+	{
+		return false;
+	}
+
+	//the select is kept on one line next to the view
+	string tempFilePath = materialized.definitionPath + ".tmp";
+	ofstream fout( tempFilePath.c_str() );
+	fout << query << endl;
+	fout.close();
+	if( fout.fail() || rename( tempFilePath.c_str(), materialized.definitionPath.c_str() ) != 0 )
+	{
+		remove( tempFilePath.c_str() );
+		remove( materialized.viewFilePath.c_str() );
+		errorMessage = "its query could not be saved";
+		return false;
+	}
+
+	database.tableAdd( view );
+	return true;
+}
+
+/**
+ * @brief MaterializedView update
+ *
+ * @details brings the views over a table up to date with its changes, and
+ *          in turn the views over those views
+ *
+ * @param [in] string currentWorkingDirectory, string currentDatabase
+ *
+ * @param [in] Database &database
+ *
+ * @param [in] string tblName - the table changed
+ *
+ * @param [in] TableDelta * delta - its changes, NULL to refresh the views
+ *             over it
+ *
+ * @return None
+ *
+ * @note the caller locked the views and the tables they read, see
+ *       findDependents. A view that could not be brought up to date is
+ *       reported and stays as it was
+ */
+void MaterializedView::update( string currentWorkingDirectory, string currentDatabase, Database &database,
+	string tblName, TableDelta * delta )
+{
+	if( delta != NULL && delta->inserted.empty() && delta->deleted.empty() )
+	{
+		return;
+	}
+
+	int tblSize = database.databaseTable.size();
+	for( int index = 0; index < tblSize; index++ )
+	{
+		Table &view = database.databaseTable[ index ];
+		if( view.viewQuery.empty() )
+		{
+			continue;
+		}
+		MaterializedView materialized( currentWorkingDirectory, currentDatabase, database, view );
+		string errorMessage;
+		if( !materialized.parse( errorMessage ) || !materialized.dependsOn( tblName ) )
+		{
+			continue;
+		}
+
+		TableDelta viewDelta;
+		bool refreshed = ( delta == NULL );
+		bool succeeded = refreshed ? materialized.refresh( errorMessage ) :
+			materialized.apply( tblName, *delta, viewDelta, refreshed, errorMessage );
+		if( !succeeded )
+		{
+			cout << "-- !Failed to refresh materialized view " << view.tableName << " because " << errorMessage << "." << endl;
+			continue;
+		}
+		update( currentWorkingDirectory, currentDatabase, database, view.tableName, refreshed ? NULL : &viewDelta );
+	}
+}
+
+/**
+ * @brief MaterializedView findDependents
+ *
+ * @details finds the views a change of a table reaches, those over it and
+ *          those over them, and the other tables they read
+ *
+ * @param [in] string currentWorkingDirectory, string currentDatabase
+ *
+ * @param [in] Database &database
+ *
+ * @param [in] string tblName
+ *
+ * @param [out] vector< string > &viewNames - the views to write
+ *
+ * @param [out] vector< string > &readTables - the tables to read
+ *
+ * @return None
+ *
+ * @note None
+ */
+void MaterializedView::findDependents( string currentWorkingDirectory, string currentDatabase, Database &database,
+	string tblName, vector< string > &viewNames, vector< string > &readTables )
+{
+	vector< string > changed( 1, tblName );
+	vector< string > reads;
+	viewNames.clear();
+	readTables.clear();
+	while( !changed.empty() )
+	{
+		string changedName = changed.back();
+		changed.pop_back();
+
+		int tblSize = database.databaseTable.size();
+		for( int index = 0; index < tblSize; index++ )
+		{
+			Table &view = database.databaseTable[ index ];
+			if( view.viewQuery.empty() )
+			{
+				continue;
+			}
+			MaterializedView materialized( currentWorkingDirectory, currentDatabase, database, view );
+			string errorMessage;
+			if( !materialized.parse( errorMessage ) || !materialized.dependsOn( changedName ) )
+			{
+				continue;
+			}
+
+			bool found = false;
+			int viewSize = viewNames.size();
+			for( int name = 0; name < viewSize && !found; name++ )
+			{
+				found = ( viewNames[ name ] == view.tableName );
+			}
+			if( !found )
+			{
+				viewNames.push_back( view.tableName );
+				changed.push_back( view.tableName );
+				int tableSize = materialized.joinTables.size();
+				for( int table = 0; table < tableSize; table++ )
+				{
+					reads.push_back( materialized.joinTables[ table ].tableName );
+				}
+			}
+		}
+	}
+
+	//tables written are not also read
+	int readSize = reads.size();
+	for( int index = 0; index < readSize; index++ )
+	{
+		bool skipped = caseInsCompare( reads[ index ], tblName );
+		int viewSize = viewNames.size();
+		for( int name = 0; name < viewSize && !skipped; name++ )
+		{
+			skipped = ( viewNames[ name ] == reads[ index ] );
+		}
+		int tableSize = readTables.size();
+		for( int table = 0; table < tableSize && !skipped; table++ )
+		{
+			skipped = ( readTables[ table ] == reads[ index ] );
+		}
+		if( !skipped )
+		{
+			readTables.push_back( reads[ index ] );
+		}
+	}
+}
+
+/**
+ * @brief MaterializedView hasDependents
+ *
+ * @details checks whether a materialized view reads a table
+ *
+ * @param [in] string currentWorkingDirectory, string currentDatabase
+ *
+ * @param [in] Database &database
+ *
+ * @param [in] string tblName
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MaterializedView::hasDependents( string currentWorkingDirectory, string currentDatabase, Database &database,
+	string tblName )
+{
+	vector< string > viewNames;
+	vector< string > readTables;
+	findDependents( currentWorkingDirectory, currentDatabase, database, tblName, viewNames, readTables );
+	return !viewNames.empty();
+}
+
+/**
+ * @brief MaterializedView load
+ *
+ * @details returns the select of a materialized view
+ *
+ * @param [in] string viewFilePath - see getViewPath
+ *
+ * @return string empty if the table is not a materialized view
+ *
+ * @note None
+ */
+string MaterializedView::load( string viewFilePath )
+{
+	string query;
+	ifstream fin( viewFilePath.c_str() );
+	getline( fin, query );
+	return query;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,75 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file MaterializedView.h
+ *
+ * @brief Definition file for the MaterializedView class
+ *
+ * @details Specifies the materialized views of a database. A view is a
+ *          table holding the result of a select of other tables, read like
+ *          any other table. Its select is kept next to it in a hidden file.
+ *          A statement changing a table brings the views over it up to
+ *          date with the records it inserted and deleted: the select is run
+ *          with those records in place of the table, and its result is
+ *          added to or removed from the view. Views over left outer joins
+ *          or reading a table twice are run again in full
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Database.h"
+#include "Planner.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef MATERIALIZEDVIEW_H
+#define MATERIALIZEDVIEW_H
+
+class MaterializedView{
+	public:
+		MaterializedView( string currentWorkingDirectory, string currentDatabase, Database &viewDatabase,
+			Table &viewTable );
+		bool parse( string &errorMessage );
+		bool dependsOn( string tblName );
+		void getTables( vector< string > &tblNames );
+		bool refresh( string &errorMessage );
+		bool apply( string tblName, TableDelta &delta, TableDelta &viewDelta, bool &refreshed, string &errorMessage );
+
+		static bool create( string currentWorkingDirectory, string currentDatabase, Database &database,
+			string viewName, string query, string &errorMessage );
+		static void update( string currentWorkingDirectory, string currentDatabase, Database &database,
+			string tblName, TableDelta * delta );
+		static void findDependents( string currentWorkingDirectory, string currentDatabase, Database &database,
+			string tblName, vector< string > &viewNames, vector< string > &readTables );
+		static bool hasDependents( string currentWorkingDirectory, string currentDatabase, Database &database,
+			string tblName );
+		static string load( string viewFilePath );
+
+	private:
+		//path to the database directory ending in a slash
+		string databasePath;
+		string viewFilePath;
+		string definitionPath;
+		Database &database;
+		Table &view;
+		vector< JoinTable > joinTables;
+		string whereType;
+		string queryType;
+		QueryLimit qLimit;
+		//false if the view is run again in full after every change
+		bool incremental;
+
+		MaterializedView( const MaterializedView &other );
+		MaterializedView &operator=( const MaterializedView &other );
+		bool run( int deltaTable, const vector< string > &deltaRecords, vector< string > &records,
+			string &errorMessage );
+		void getColumns( JoinPlanner &planner, vector< Attribute > &columns );
+		bool removeRecords( const vector< string > &records, string &errorMessage );
+		bool addRecords( const vector< string > &records, string &errorMessage );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,557 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Metrics.cpp
+ *
+ * @brief Implementation file for the metrics of the database system
+ *
+ * @details Implements the counters and histograms of every thread, summing
+ *          them, the statement clock and the writer of the metrics file
+ *
+ * @Note Requires Metrics.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef METRICS_CPP
+#define METRICS_CPP
+
+const char * const METRIC_NAMES[ METRIC_COUNT ] = { "rows_scanned", "rows_returned", "bytes_read",
+	"bytes_written", "page_cache_hits", "page_cache_misses", "lock_waits", "lock_timeouts", "result_cache_hits",
+	"result_cache_misses" };
+const char * const METRIC_HELP[ METRIC_COUNT ] = { "Records read by table scans.",
+	"Records output by queries.", "Bytes read from table files.", "Bytes written to table files.",
+	"Pages found in the page cache.", "Pages read from table files instead of the page cache.",
+	"Locks granted after waiting for them.", "Locks given up on after LOCK_WAIT_SECONDS.",
+	"Queries output from the result cache.", "Queries run because the result cache did not hold them." };
+const char * const STATEMENT_NAMES[ STATEMENT_TYPE_COUNT ] = { "select", "insert", "update", "delete",
+	"create", "drop", "alter", "use", "analyze", "explain", "set", "begin", "commit", "rollback", "show",
+	"other" };
+const char * const HISTOGRAM_NAMES[ HISTOGRAM_COUNT ] = { "statement_parse_seconds", "statement_plan_seconds",
+	"statement_execute_seconds", "statement_seconds", "lock_wait_seconds" };
+const char * const HISTOGRAM_HELP[ HISTOGRAM_COUNT ] = { "Seconds statements took to parse.",
+	"Seconds queries took to plan.", "Seconds statements took to execute.", "Seconds statements took.",
+	"Seconds waited for locks." };
+const char * const METRIC_PREFIX = "cs457_";
+//percentiles SHOW STATS estimates from the buckets
+const int STAT_PERCENTILES[ 3 ] = { 50, 95, 99 };
+
+//the metrics of the running threads, and the sum of those that ended
+struct MetricRegistry{
+	mutex stateMutex;
+	vector< ThreadMetrics * > threads;
+	MetricValues retired;
+};
+
+thread_local StatementClock * StatementClock::current = NULL;
+
+MetricRegistry &getMetricRegistry()
+{
+	static MetricRegistry registry;
+	return registry;
+}
+
+/**
+ * @brief addRelaxed
+ *
+ * @details adds to a value only the calling thread writes. Other threads
+ *          only read it, so a plain load and store is enough
+ *
+ * @param [in] atomic< long long > &value
+ *
+ * @param [in] long long amount
+ *
+ * @return None
+ *
+ * @note None
+ */
+inline void addRelaxed( atomic< long long > &value, long long amount )
+{
+	value.store( value.load( memory_order_relaxed ) + amount, memory_order_relaxed );
+}
+
+string formatNumber( double number )
+{
+	char buffer[ 32 ];
+	snprintf( buffer, sizeof( buffer ), "%.6g", number );
+	return buffer;
+}
+
+ThreadMetrics::ThreadMetrics()
+{
+	for( int index = 0; index < METRIC_COUNT; index++ )
+	{
+		counters[ index ].store( 0 );
+	}
+	for( int index = 0; index < STATEMENT_TYPE_COUNT; index++ )
+	{
+		statements[ index ].store( 0 );
+	}
+	for( int histogram = 0; histogram < HISTOGRAM_COUNT; histogram++ )
+	{
+		for( int bucket = 0; bucket <= METRIC_BUCKETS; bucket++ )
+		{
+			buckets[ histogram ][ bucket ].store( 0 );
+		}
+		nanoseconds[ histogram ].store( 0 );
+	}
+
+	MetricRegistry &registry = getMetricRegistry();
+	lock_guard< mutex > state( registry.stateMutex );
+	registry.threads.push_back( this );
+}
+
+/**
+ * @brief ThreadMetrics destructor
+ *
+ * @details keeps what an ending thread counted
+ *
+ * @note None
+ */
+ThreadMetrics::~ThreadMetrics()
+{
+	MetricRegistry &registry = getMetricRegistry();
+	lock_guard< mutex > state( registry.stateMutex );
+	addTo( registry.retired );
+	registry.threads.erase( find( registry.threads.begin(), registry.threads.end(), this ) );
+}
+
+void ThreadMetrics::addTo( MetricValues &values )
+{
+	for( int index = 0; index < METRIC_COUNT; index++ )
+	{
+		values.counters[ index ] += counters[ index ].load( memory_order_relaxed );
+	}
+	for( int index = 0; index < STATEMENT_TYPE_COUNT; index++ )
+	{
+		values.statements[ index ] += statements[ index ].load( memory_order_relaxed );
+	}
+	for( int histogram = 0; histogram < HISTOGRAM_COUNT; histogram++ )
+	{
+		for( int bucket = 0; bucket <= METRIC_BUCKETS; bucket++ )
+		{
+			values.buckets[ histogram ][ bucket ] += buckets[ histogram ][ bucket ].load( memory_order_relaxed );
+		}
+		values.nanoseconds[ histogram ] += nanoseconds[ histogram ].load( memory_order_relaxed );
+	}
+}
+
+/**
+ * @brief Metrics forThread
+ *
+ * @details returns the metrics of the calling thread, registered when it
+ *          first counts
+ *
+ * @return ThreadMetrics &
+ *
+ * @note None
+ */
+ThreadMetrics &Metrics::forThread()
+{
+	static thread_local ThreadMetrics metrics;
+	return metrics;
+}
+
+void Metrics::count( int counter, long long amount )
+{
+	addRelaxed( forThread().counters[ counter ], amount );
+}
+
+void Metrics::countStatement( int statementType )
+{
+	addRelaxed( forThread().statements[ statementType ], 1 );
+}
+
+/**
+ * @brief Metrics observe
+ *
+ * @details counts a duration in the first bucket of a histogram whose bound
+ *          it does not exceed
+ *
+ * @param [in] int histogram
+ *
+ * @param [in] double seconds
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Metrics::observe( int histogram, double seconds )
+{
+	ThreadMetrics &metrics = forThread();
+	int bucket = lower_bound( METRIC_BOUNDS, METRIC_BOUNDS + METRIC_BUCKETS, seconds ) - METRIC_BOUNDS;
+	addRelaxed( metrics.buckets[ histogram ][ bucket ], 1 );
+	addRelaxed( metrics.nanoseconds[ histogram ], (long long) ( seconds * 1000000000.0 ) );
+}
+
+/**
+ * @brief Metrics findStatementType
+ *
+ * @details returns the type counted for a statement's first word
+ *
+ * @param [in] string action - e.g. "SELECT"
+ *
+ * @return int STATEMENT_OTHER if it is not a statement
+ *
+ * @note None
+ */
+int Metrics::findStatementType( string action )
+{
+	for( unsigned int index = 0; index < action.size(); index++ )
+	{
+		action[ index ] = tolower( action[ index ] );
+	}
+	for( int index = 0; index < STATEMENT_OTHER; index++ )
+	{
+		if( action == STATEMENT_NAMES[ index ] )
+		{
+			return index;
+		}
+	}
+	return STATEMENT_OTHER;
+}
+
+/**
+ * @brief Metrics collect
+ *
+ * @details sums the metrics of every thread, the running ones are read as
+ *          they count
+ *
+ * @param [out] MetricValues &values
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Metrics::collect( MetricValues &values )
+{
+	MetricRegistry &registry = getMetricRegistry();
+	lock_guard< mutex > state( registry.stateMutex );
+	values = registry.retired;
+	int threadSize = registry.threads.size();
+	for( int index = 0; index < threadSize; index++ )
+	{
+		registry.threads[ index ]->addTo( values );
+	}
+}
+
+/**
+ * @brief Metrics getStatLines
+ *
+ * @details returns the metrics SHOW STATS outputs: the statements of each
+ *          type, the counters, the page cache hit rate and the count, total
+ *          and percentiles of each histogram
+ *
+ * @par Algorithm a percentile is the bound of the bucket it falls in, or
+ *      "inf" past the last bound
+ *
+ * @param [out] vector< string > &names
+ *
+ * @param [out] vector< string > &values
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Metrics::getStatLines( vector< string > &names, vector< string > &values )
+{
+	MetricValues metrics;
+	collect( metrics );
+
+	for( int index = 0; index < STATEMENT_TYPE_COUNT; index++ )
+	{
+		names.push_back( string( "statements_" ) + STATEMENT_NAMES[ index ] );
+		values.push_back( formatNumber( metrics.statements[ index ] ) );
+	}
+	for( int index = 0; index < METRIC_COUNT; index++ )
+	{
+		names.push_back( METRIC_NAMES[ index ] );
+		values.push_back( formatNumber( metrics.counters[ index ] ) );
+	}
+	long long pageReads = metrics.counters[ METRIC_PAGE_CACHE_HITS ] + metrics.counters[ METRIC_PAGE_CACHE_MISSES ];
+	names.push_back( "page_cache_hit_rate" );
+	values.push_back( formatNumber( pageReads > 0 ? (double) metrics.counters[ METRIC_PAGE_CACHE_HITS ] / pageReads : 0 ) );
+
+	for( int histogram = 0; histogram < HISTOGRAM_COUNT; histogram++ )
+	{
+		long long total = 0;
+		for( int bucket = 0; bucket <= METRIC_BUCKETS; bucket++ )
+		{
+			total += metrics.buckets[ histogram ][ bucket ];
+		}
+		string name = HISTOGRAM_NAMES[ histogram ];
+		names.push_back( name + "_count" );
+		values.push_back( formatNumber( total ) );
+		names.push_back( name + "_sum" );
+		values.push_back( formatNumber( metrics.nanoseconds[ histogram ] / 1000000000.0 ) );
+
+		for( int percentile = 0; percentile < 3; percentile++ )
+		{
+			long long rank = ( total * STAT_PERCENTILES[ percentile ] + 99 ) / 100;
+			long long seen = 0;
+			int bucket = 0;
+			while( bucket < METRIC_BUCKETS && seen + metrics.buckets[ histogram ][ bucket ] < rank )
+			{
+				seen += metrics.buckets[ histogram ][ bucket ];
+				bucket++;
+			}
+			char suffix[ 8 ];
+			snprintf( suffix, sizeof( suffix ), "_p%d", STAT_PERCENTILES[ percentile ] );
+			names.push_back( name + suffix );
+			values.push_back( total == 0 ? "0" : bucket < METRIC_BUCKETS ? formatNumber( METRIC_BOUNDS[ bucket ] ) : "inf" );
+		}
+	}
+}
+
+/**
+ * @brief Metrics getPrometheusText
+ *
+ * @details returns the metrics in the Prometheus text exposition format
+ *
+ * @return string
+ *
+ * @note None
+ */
+string Metrics::getPrometheusText()
+{
+	MetricValues metrics;
+	collect( metrics );
+	string text;
+
+	text += string( "# HELP " ) + METRIC_PREFIX + "statements_total Statements run, by type.\n";
+	text += string( "# TYPE " ) + METRIC_PREFIX + "statements_total counter\n";
+	for( int index = 0; index < STATEMENT_TYPE_COUNT; index++ )
+	{
+		text += string( METRIC_PREFIX ) + "statements_total{type=\"" + STATEMENT_NAMES[ index ] + "\"} " +
+			formatNumber( metrics.statements[ index ] ) + "\n";
+	}
+	for( int index = 0; index < METRIC_COUNT; index++ )
+	{
+		string name = string( METRIC_PREFIX ) + METRIC_NAMES[ index ] + "_total";
+		text += "# HELP " + name + " " + METRIC_HELP[ index ] + "\n";
+		text += "# TYPE " + name + " counter\n";
+		text += name + " " + formatNumber( metrics.counters[ index ] ) + "\n";
+	}
+	for( int histogram = 0; histogram < HISTOGRAM_COUNT; histogram++ )
+	{
+		string name = string( METRIC_PREFIX ) + HISTOGRAM_NAMES[ histogram ];
+		text += "# HELP " + name + " " + HISTOGRAM_HELP[ histogram ] + "\n";
+		text += "# TYPE " + name + " histogram\n";
+		long long total = 0;
+		for( int bucket = 0; bucket <= METRIC_BUCKETS; bucket++ )
+		{
+			total += metrics.buckets[ histogram ][ bucket ];
+			string bound = bucket < METRIC_BUCKETS ? formatNumber( METRIC_BOUNDS[ bucket ] ) : "+Inf";
+			text += name + "_bucket{le=\"" + bound + "\"} " + formatNumber( total ) + "\n";
+		}
+		text += name + "_sum " + formatNumber( metrics.nanoseconds[ histogram ] / 1000000000.0 ) + "\n";
+		text += name + "_count " + formatNumber( total ) + "\n";
+	}
+	return text;
+}
+
+/**
+ * @brief StatementClock constructor
+ *
+ * @details starts timing a statement in its parse phase and counts it
+ *
+ * @param [in] int statementType - see Metrics::findStatementType
+ *
+ * @note None
+ */
+StatementClock::StatementClock( int statementType )
+{
+	started = chrono::steady_clock::now();
+	phaseStarted = started;
+	phase = PHASE_PARSE;
+	for( int index = 0; index < PHASE_COUNT; index++ )
+	{
+		entered[ index ] = index == PHASE_PARSE;
+		phaseSeconds[ index ] = 0;
+	}
+	ThreadMetrics &metrics = Metrics::forThread();
+	scannedBefore = metrics.counters[ METRIC_ROWS_SCANNED ].load( memory_order_relaxed );
+	returnedBefore = metrics.counters[ METRIC_ROWS_RETURNED ].load( memory_order_relaxed );
+	previous = current;
+	current = this;
+	Metrics::countStatement( statementType );
+}
+
+/**
+ * @brief StatementClock destructor
+ *
+ * @details counts the time of each phase the statement entered. A statement
+ *          that never left its parse phase, such as a create, is parsed as
+ *          it is carried out, its time counts as executing
+ *
+ * @note None
+ */
+StatementClock::~StatementClock()
+{
+	switchPhase( phase );
+	if( !entered[ PHASE_PLAN ] && !entered[ PHASE_EXECUTE ] )
+	{
+		entered[ PHASE_PARSE ] = false;
+		entered[ PHASE_EXECUTE ] = true;
+		phaseSeconds[ PHASE_EXECUTE ] = phaseSeconds[ PHASE_PARSE ];
+	}
+	for( int index = 0; index < PHASE_COUNT; index++ )
+	{
+		if( entered[ index ] )
+		{
+			Metrics::observe( index, phaseSeconds[ index ] );
+		}
+	}
+	Metrics::observe( HISTOGRAM_STATEMENT, elapsed() );
+	current = previous;
+}
+
+/**
+ * @brief StatementClock enter
+ *
+ * @details moves the statement running on the thread, if any, to a phase
+ *
+ * @param [in] int phase - PHASE_PLAN or PHASE_EXECUTE
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatementClock::enter( int nextPhase )
+{
+	if( current != NULL )
+	{
+		current->switchPhase( nextPhase );
+	}
+}
+
+/**
+ * @brief StatementClock runningSeconds
+ *
+ * @details returns how long the statement running on the thread has run
+ *
+ * @return double 0 if no statement is running
+ *
+ * @note None
+ */
+double StatementClock::runningSeconds()
+{
+	return ( current == NULL ) ? 0 : current->elapsed();
+}
+
+void StatementClock::setPlan( string planSummary )
+{
+	if( current != NULL )
+	{
+		current->plan = planSummary;
+	}
+}
+
+void StatementClock::switchPhase( int nextPhase )
+{
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	phaseSeconds[ phase ] += chrono::duration< double >( now - phaseStarted ).count();
+	phaseStarted = now;
+	phase = nextPhase;
+	entered[ phase ] = true;
+}
+
+double StatementClock::elapsed()
+{
+	return chrono::duration< double >( chrono::steady_clock::now() - started ).count();
+}
+
+long long StatementClock::rowsScanned()
+{
+	return Metrics::forThread().counters[ METRIC_ROWS_SCANNED ].load( memory_order_relaxed ) - scannedBefore;
+}
+
+long long StatementClock::rowsReturned()
+{
+	return Metrics::forThread().counters[ METRIC_ROWS_RETURNED ].load( memory_order_relaxed ) - returnedBefore;
+}
+
+string StatementClock::getPlan()
+{
+	return plan;
+}
+
+MetricsWriter::MetricsWriter( string metricsFilePath, int intervalSeconds )
+{
+	filePath = metricsFilePath;
+	interval = intervalSeconds;
+	stopping = false;
+	if( interval > 0 )
+	{
+		writer = thread( &MetricsWriter::run, this );
+	}
+}
+
+MetricsWriter::~MetricsWriter()
+{
+	if( !writer.joinable() )
+	{
+		return;
+	}
+	{
+		lock_guard< mutex > state( stateMutex );
+		stopping = true;
+		stopped.notify_all();
+	}
+	writer.join();
+	write();
+}
+
+void MetricsWriter::run()
+{
+	unique_lock< mutex > state( stateMutex );
+	while( !stopping )
+	{
+		if( stopped.wait_for( state, chrono::seconds( interval ) ) == cv_status::timeout && !stopping )
+		{
+			state.unlock();
+			write();
+			state.lock();
+		}
+	}
+}
+
+/**
+ * @brief MetricsWriter write
+ *
+ * @details replaces the metrics file, a scraper never reads half of it
+ *
+ * @return None
+ *
+ * @note a file that could not be written is tried again next interval,
+ *       there is no session to report it to
+ */
+void MetricsWriter::write()
+{
+	string tempFilePath = filePath + ".tmp";
+	ofstream fout( tempFilePath.c_str() );
+	fout << Metrics::getPrometheusText();
+	fout.close();
+	if( !fout.fail() )
+	{
+		rename( tempFilePath.c_str(), filePath.c_str() );
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,165 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Metrics.h
+ *
+ * @brief Definition file for the metrics of the database system
+ *
+ * @details Specifies the counters and histograms of the statements run,
+ *          records scanned and returned, bytes read and written, the page
+ *          cache and lock waits. Every thread counts into its own set, which
+ *          only that thread writes, so counting takes no lock and no atomic
+ *          read-modify-write. The sets are summed when the metrics are shown
+ *          by SHOW STATS or written to the metrics file in the Prometheus
+ *          text format
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef METRICS_H
+#define METRICS_H
+
+//counters
+const int METRIC_ROWS_SCANNED = 0;
+const int METRIC_ROWS_RETURNED = 1;
+const int METRIC_BYTES_READ = 2;
+const int METRIC_BYTES_WRITTEN = 3;
+const int METRIC_PAGE_CACHE_HITS = 4;
+const int METRIC_PAGE_CACHE_MISSES = 5;
+const int METRIC_LOCK_WAITS = 6;
+const int METRIC_LOCK_TIMEOUTS = 7;
+const int METRIC_RESULT_CACHE_HITS = 8;
+const int METRIC_RESULT_CACHE_MISSES = 9;
+const int METRIC_COUNT = 10;
+
+//types of statements counted, anything else is STATEMENT_OTHER
+const int STATEMENT_TYPE_COUNT = 16;
+const int STATEMENT_OTHER = STATEMENT_TYPE_COUNT - 1;
+
+//histograms of seconds. A statement is parsed, planned if it is a query,
+//then executed
+const int HISTOGRAM_PARSE = 0;
+const int HISTOGRAM_PLAN = 1;
+const int HISTOGRAM_EXECUTE = 2;
+const int HISTOGRAM_STATEMENT = 3;
+const int HISTOGRAM_LOCK_WAIT = 4;
+const int HISTOGRAM_COUNT = 5;
+//upper bounds of the buckets in seconds, a last bucket takes the rest
+const int METRIC_BUCKETS = 13;
+const double METRIC_BOUNDS[ METRIC_BUCKETS ] = { 0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01,
+	0.05, 0.1, 0.5, 1, 5, 10 };
+
+//phases of a statement
+const int PHASE_PARSE = HISTOGRAM_PARSE;
+const int PHASE_PLAN = HISTOGRAM_PLAN;
+const int PHASE_EXECUTE = HISTOGRAM_EXECUTE;
+const int PHASE_COUNT = 3;
+
+//the metrics file is written this often unless --metrics-interval is given,
+//in the database system directory, hidden so it is not taken for a database
+const int METRICS_INTERVAL_SECONDS = 15;
+const string METRICS_FILE_NAME = ".metrics.prom";
+
+//values of the metrics summed over the threads
+struct MetricValues{
+	long long counters[ METRIC_COUNT ];
+	long long statements[ STATEMENT_TYPE_COUNT ];
+	long long buckets[ HISTOGRAM_COUNT ][ METRIC_BUCKETS + 1 ];
+	long long nanoseconds[ HISTOGRAM_COUNT ];
+};
+
+//the metrics one thread counts into
+class ThreadMetrics{
+	public:
+		atomic< long long > counters[ METRIC_COUNT ];
+		atomic< long long > statements[ STATEMENT_TYPE_COUNT ];
+		atomic< long long > buckets[ HISTOGRAM_COUNT ][ METRIC_BUCKETS + 1 ];
+		atomic< long long > nanoseconds[ HISTOGRAM_COUNT ];
+
+		ThreadMetrics();
+		~ThreadMetrics();
+		void addTo( MetricValues &values );
+
+	private:
+		ThreadMetrics( const ThreadMetrics &other );
+		ThreadMetrics &operator=( const ThreadMetrics &other );
+};
+
+class Metrics{
+	public:
+		static ThreadMetrics &forThread();
+		static void count( int counter, long long amount = 1 );
+		static void countStatement( int statementType );
+		static void observe( int histogram, double seconds );
+		static int findStatementType( string action );
+		static void collect( MetricValues &values );
+		static void getStatLines( vector< string > &names, vector< string > &values );
+		static string getPrometheusText();
+};
+
+//times the phases of the statement running on a thread, and counts the
+//records it scanned and returned for the slow query log
+class StatementClock{
+	public:
+		StatementClock( int statementType );
+		~StatementClock();
+		static void enter( int phase );
+		static double runningSeconds();
+		static void setPlan( string planSummary );
+		double elapsed();
+		long long rowsScanned();
+		long long rowsReturned();
+		string getPlan();
+
+	private:
+		chrono::steady_clock::time_point started;
+		chrono::steady_clock::time_point phaseStarted;
+		int phase;
+		bool entered[ PHASE_COUNT ];
+		double phaseSeconds[ PHASE_COUNT ];
+		long long scannedBefore;
+		long long returnedBefore;
+		//one line summary of the plan of a query, set only if it was slow
+		string plan;
+		StatementClock * previous;
+		static thread_local StatementClock * current;
+
+		StatementClock( const StatementClock &other );
+		StatementClock &operator=( const StatementClock &other );
+		void switchPhase( int nextPhase );
+};
+
+//writes the metrics file every interval until it is destroyed, and once more
+//then
+class MetricsWriter{
+	public:
+		MetricsWriter( string metricsFilePath, int intervalSeconds );
+		~MetricsWriter();
+
+	private:
+		string filePath;
+		int interval;
+		mutex stateMutex;
+		condition_variable stopped;
+		bool stopping;
+		thread writer;
+
+		MetricsWriter( const MetricsWriter &other );
+		MetricsWriter &operator=( const MetricsWriter &other );
+		void run();
+		void write();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,130 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file NameIndex.cpp
+ *
+ * @brief Implementation file for the NameIndex class
+ *
+ * @details Implements finding, adding and removing names
+ *
+ * @Note Requires NameIndex.h
+ */
+
+#include <iostream>
+#include <string>
+#include <cctype>
+#include "NameIndex.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef NAMEINDEX_CPP
+#define NAMEINDEX_CPP
+
+/**
+ * @brief NameIndex find
+ *
+ * @details finds the position of a name, in any case
+ *
+ * @param [in] const string &name
+ *
+ * @return int position, or -1 if the name is not in the index
+ *
+ * @note None
+ */
+int NameIndex::find( const string &name ) const
+{
+	unordered_map< string, int >::const_iterator found = positions.find( getKey( name ) );
+	if( found == positions.end() )
+	{
+		return -1;
+	}
+	return found->second;
+}
+
+/**
+ * @brief NameIndex add
+ *
+ * @details adds a name at a position
+ *
+ * @param [in] const string &name
+ *
+ * @param [in] int position
+ *
+ * @return None
+ *
+ * @note None
+ */
+void NameIndex::add( const string &name, int position )
+{
+	positions[ getKey( name ) ] = position;
+}
+
+/**
+ * @brief NameIndex remove
+ *
+ * @details removes a name, the names after it move down a position as they
+ *          do in the vector when it is erased
+ *
+ * @param [in] const string &name
+ *
+ * @return None
+ *
+ * @note goes through every name, only dropping does this
+ */
+void NameIndex::remove( const string &name )
+{
+	unordered_map< string, int >::iterator found = positions.find( getKey( name ) );
+	if( found == positions.end() )
+	{
+		return;
+	}
+	int position = found->second;
+	positions.erase( found );
+
+	for( unordered_map< string, int >::iterator entry = positions.begin(); entry != positions.end(); ++entry )
+	{
+		if( entry->second > position )
+		{
+			entry->second--;
+		}
+	}
+}
+
+/**
+ * @brief NameIndex clear
+ *
+ * @details removes every name
+ *
+ * @return None
+ *
+ * @note None
+ */
+void NameIndex::clear()
+{
+	positions.clear();
+}
+
+/**
+ * @brief NameIndex getKey
+ *
+ * @details returns a name in upper case
+ *
+ * @param [in] const string &name
+ *
+ * @return string
+ *
+ * @note None
+ */
+string NameIndex::getKey( const string &name )
+{
+	string key = name;
+	int size = key.size();
+	for( int index = 0; index < size; index++ )
+	{
+		key[ index ] = toupper( key[ index ] );
+	}
+	return key;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,41 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file NameIndex.h
+ *
+ * @brief Definition file for the NameIndex class
+ *
+ * @details Specifies the index of the databases of the database system and
+ *          of the tables of a database by name. Names are compared without
+ *          case, as caseInsCompare does, so each is hashed in upper case to
+ *          its position in the vector holding it. Finding a name takes the
+ *          same time however many there are
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+class NameIndex{
+	public:
+		int find( const string &name ) const;
+		void add( const string &name, int position );
+		void remove( const string &name );
+		void clear();
+
+	private:
+		//positions by upper case name
+		unordered_map< string, int > positions;
+
+		static string getKey( const string &name );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
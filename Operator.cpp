@@ -0,0 +1,1176 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Operator.cpp
+ *
+ * @brief Implementation file for the query operators
+ *
+ * @details Implements all member methods of the query operators. Every
+ *          operator pulls tuples from its child only when asked, so an
+ *          operator that stops asking (e.g. a satisfied limit) stops the
+ *          scans and joins beneath it as well. Also implements the counters
+ *          and output of EXPLAIN ANALYZE
+ *
+ * @Note Requires Operator.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <new>
+#include <algorithm>
+#include "Operator.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef OPERATOR_CPP
+#define OPERATOR_CPP
+
+//declaration of the parsing helpers
+string getNextWord( string &input );
+string getUntilTab( string &input );
+Arena &statementArena();
+int getValueType( string attributeType );
+string getDictionaryPath( string tableFilePath );
+
+//format of a stored right tuple value that is null
+const unsigned char STORED_NULL = 0xfe;
+
+//counted for EXPLAIN ANALYZE, per thread
+thread_local long long scanBytesRead = 0;
+thread_local long long allocationCount = 0;
+
+/**
+ * @brief operator new
+ *
+ * @details counts every allocation of the program for EXPLAIN ANALYZE
+ *
+ * @param [in] size_t size
+ *
+ * @return void * the allocated memory
+ *
+ * @exception bad_alloc if no memory is left
+ *
+ * @note not inlined, so that an optimized build does not pair the malloc
+ *       with the delete of a new expression
+ */
+__attribute__(( noinline )) void * operator new( size_t size )
+{
+	allocationCount++;
+	void * memory = malloc( size == 0 ? 1 : size );
+	if( memory == NULL )
+	{
+		throw bad_alloc();
+	}
+	return memory;
+}
+
+//not inlined, so the compiler does not pair the free with a new expression
+__attribute__(( noinline )) void operator delete( void * memory ) noexcept
+{
+	free( memory );
+}
+
+__attribute__(( noinline )) void operator delete( void * memory, size_t size ) noexcept
+{
+	free( memory );
+}
+
+/**
+ * @brief currentSeconds
+ *
+ * @details reads a monotonic clock
+ *
+ * @return double seconds since an arbitrary point
+ *
+ * @note None
+ */
+double currentSeconds()
+{
+	return chrono::duration< double >( chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/**
+ * @brief Operator default constructor
+ *
+ * @details base class constructor, nothing is estimated yet
+ *
+ * @note None
+ */
+Operator::Operator()
+{
+	estimatedRows = -1;
+}
+
+/**
+ * @brief Operator default destructor
+ *
+ * @details base class destructor, children are owned by the caller
+ *
+ * @note None
+ */
+Operator::~Operator()
+{
+
+}
+
+/**
+ * @brief Operator inputs
+ *
+ * @details returns the operators this operator pulls tuples from
+ *
+ * @return vector< Operator * > empty for a scan
+ *
+ * @note None
+ */
+vector< Operator * > Operator::inputs()
+{
+	return vector< Operator * >();
+}
+
+/**
+ * @brief Operator setAttributes
+ *
+ * @details sets the output attributes and the types and dictionaries of the
+ *          rows produced
+ *
+ * @param [in] const vector< Attribute > &newAttributes
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Operator::setAttributes( const vector< Attribute > &newAttributes )
+{
+	int attrSize = newAttributes.size();
+	attributes = newAttributes;
+	columnTypes.resize( attrSize );
+	columnDictionaries.resize( attrSize );
+	for( int index = 0; index < attrSize; index++ )
+	{
+		columnTypes[ index ] = getValueType( attributes[ index ].attributeType );
+		columnDictionaries[ index ] = attributes[ index ].dictionary;
+	}
+}
+
+/**
+ * @brief TableScan constructor
+ *
+ * @details reads the attribute line and the codec of the table file so
+ *          that the attributes are known before the scan is opened, and the
+ *          dictionaries of its encoded attributes
+ *
+ * @param [in] string scanFilePath - full path to the table file
+ *
+ * @note None
+ */
+TableScan::TableScan( string scanFilePath )
+{
+	string temp;
+	vector< Attribute > tableAttributes;
+	filePath = scanFilePath;
+
+	reader.open( filePath, temp );
+	codec = reader.codec;
+	reader.close();
+	dictionary.load( getDictionaryPath( filePath ) );
+
+	while( !temp.empty() )
+	{
+		Attribute tempAttribute;
+		tempAttribute.attributeName = getNextWord( temp );
+		tempAttribute.attributeType = getUntilTab( temp );
+		tempAttribute.dictionary = dictionary.find( tempAttribute.attributeName );
+		tableAttributes.push_back( tempAttribute );
+	}
+	setAttributes( tableAttributes );
+	columnCount = attributes.size();
+	layoutOffset = 0;
+}
+
+/**
+ * @brief TableScan setLayout
+ *
+ * @details places the scanned records inside a wider tuple, used when
+ *          several tables are joined so that every operator of the join
+ *          sees the attributes of all tables at the same indexes
+ *
+ * @param [in] vector< Attribute > &layoutAttributes - attributes of the wide
+ *             tuple
+ *
+ * @param [in] int offset - index of this table's first attribute in the wide
+ *             tuple
+ *
+ * @return None
+ *
+ * @note attributes not belonging to this table are left empty
+ */
+void TableScan::setLayout( vector< Attribute > &layoutAttributes, int offset )
+{
+	setAttributes( layoutAttributes );
+	layoutOffset = offset;
+}
+
+/**
+ * @brief TableScan destructor
+ *
+ * @details makes sure the table file is closed
+ *
+ * @note None
+ */
+TableScan::~TableScan()
+{
+	close();
+}
+
+/**
+ * @brief TableScan open
+ *
+ * @details opens the table file and skips past the attribute line
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::open()
+{
+	string temp;
+	reader.open( filePath, temp );
+	scanBytesRead += reader.bytesRead;
+}
+
+/**
+ * @brief TableScan next
+ *
+ * @details reads exactly one record from the table file
+ *
+ * @par Algorithm reads the next record into the reused line buffer, the
+ *      reader decompresses the blocks of a compressed table, and parses the text between tabs into the attributes starting at
+ *      layoutOffset, the other attributes of a wide layout are left null.
+ *      Encoded attributes are read as codes, not looked up by their text.
+ *      The row keeps its buffers between calls, so once they are large
+ *      enough a record is read without allocating
+ *
+ * @param [out] Row &tuple - the record read
+ *
+ * @return bool true if a record was read, false at end of file
+ *
+ * @note None
+ */
+bool TableScan::next( Row &tuple )
+{
+	long long bytesRead = reader.bytesRead;
+	while( reader.readLine( line ) )
+	{
+		scanBytesRead += reader.bytesRead - bytesRead;
+		tuple.reset( columnTypes, &columnDictionaries );
+		size_t start = 0;
+		size_t lineSize = line.size();
+		for( int index = 0; index < columnCount; index++ )
+		{
+			size_t tab = line.find( '\t', start );
+			if( tab == string::npos )
+			{
+				tab = lineSize;
+			}
+			tuple.setStored( layoutOffset + index, line.data() + start, tab - start );
+			start = min( tab + 1, lineSize );
+		}
+		Metrics::count( METRIC_ROWS_SCANNED );
+		return true;
+	}
+	scanBytesRead += reader.bytesRead - bytesRead;
+	return false;
+}
+
+/**
+ * @brief TableScan close
+ *
+ * @details closes the table file if it is open
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::close()
+{
+	reader.close();
+}
+
+string TableScan::name()
+{
+	return "Seq Scan on " + filePath.substr( filePath.find_last_of( '/' ) + 1 );
+}
+
+/**
+ * @brief FilterOperator constructor
+ *
+ * @details keeps the compiled condition, output attributes match the child
+ *
+ * @param [in] Operator * childOperator
+ *
+ * @param [in] ConditionKernel * filterCondition - owned by the caller, NULL
+ *             passes every tuple
+ *
+ * @note None
+ */
+FilterOperator::FilterOperator( Operator * childOperator, ConditionKernel * filterCondition )
+{
+	child = childOperator;
+	condition = filterCondition;
+	setAttributes( child->attributes );
+}
+
+FilterOperator::~FilterOperator()
+{
+
+}
+
+void FilterOperator::open()
+{
+	child->open();
+}
+
+/**
+ * @brief FilterOperator next
+ *
+ * @details pulls tuples from the child until one meets the where condition
+ *
+ * @param [out] Row &tuple
+ *
+ * @return bool true if a tuple was found, false when the child is exhausted
+ *
+ * @note None
+ */
+bool FilterOperator::next( Row &tuple )
+{
+	while( child->next( tuple ) )
+	{
+		if( condition == NULL || condition->evaluate( tuple ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FilterOperator::close()
+{
+	child->close();
+}
+
+string FilterOperator::name()
+{
+	return "Filter";
+}
+
+vector< Operator * > FilterOperator::inputs()
+{
+	return vector< Operator * >( 1, child );
+}
+
+/**
+ * @brief ProjectOperator constructor
+ *
+ * @details keeps only the attributes at the given indexes, in order
+ *
+ * @param [in] Operator * childOperator
+ *
+ * @param [in] vector< int > indexes
+ *
+ * @note None
+ */
+ProjectOperator::ProjectOperator( Operator * childOperator, vector< int > indexes )
+{
+	child = childOperator;
+	attributeIndexes = indexes;
+
+	vector< Attribute > projected;
+	int indexSize = attributeIndexes.size();
+	for( int index = 0; index < indexSize; index++ )
+	{
+		projected.push_back( child->attributes[ attributeIndexes[ index ] ] );
+	}
+	setAttributes( projected );
+}
+
+ProjectOperator::~ProjectOperator()
+{
+
+}
+
+void ProjectOperator::open()
+{
+	child->open();
+}
+
+/**
+ * @brief ProjectOperator next
+ *
+ * @details pulls one tuple from the child and keeps the projected attributes,
+ *          the child tuple buffer is reused between calls
+ *
+ * @param [out] Row &tuple
+ *
+ * @return bool true if a tuple was produced
+ *
+ * @note None
+ */
+bool ProjectOperator::next( Row &tuple )
+{
+	if( !child->next( childTuple ) )
+	{
+		return false;
+	}
+
+	int indexSize = attributeIndexes.size();
+	tuple.reset( columnTypes, &columnDictionaries );
+	for( int index = 0; index < indexSize; index++ )
+	{
+		tuple.copyValue( index, childTuple, attributeIndexes[ index ] );
+	}
+	return true;
+}
+
+void ProjectOperator::close()
+{
+	child->close();
+}
+
+string ProjectOperator::name()
+{
+	return "Project";
+}
+
+vector< Operator * > ProjectOperator::inputs()
+{
+	return vector< Operator * >( 1, child );
+}
+
+/**
+ * @brief JoinOperator constructor
+ *
+ * @details joins the left and right children. Both children produce tuples
+ *          of the same wide layout (see TableScan::setLayout), the right
+ *          child filling only rightColumns, so the output attributes are
+ *          those of the left child
+ *
+ * @param [in] Operator * left
+ *
+ * @param [in] Operator * right
+ *
+ * @param [in] vector< int > leftKeys - indexes of the equi-join attributes
+ *             filled by the left child, empty if the join has no equality
+ *             between the two sides
+ *
+ * @param [in] vector< int > rightKeys - the matching indexes filled by the
+ *             right child, in the same order as leftKeys
+ *
+ * @param [in] vector< int > rightColumnIndexes - indexes filled by the right
+ *             child
+ *
+ * @param [in] bool outerJoin - true for a left outer join
+ *
+ * @param [in] ConditionKernel * condition - rest of the join condition, NULL
+ *             if the equalities are the whole condition
+ *
+ * @note the operator must be destroyed before the statement arena is
+ *       released
+ */
+JoinOperator::JoinOperator( Operator * left, Operator * right, vector< int > leftKeys, vector< int > rightKeys,
+	vector< int > rightColumnIndexes, bool outerJoin, ConditionKernel * condition )
+	: arena( &statementArena() ),
+	  rightSlots( ArenaAllocator< RowSlot >( arena ) ),
+	  rightFormats( ArenaAllocator< unsigned char >( arena ) ),
+	  rightText( ArenaAllocator< const char * >( arena ) ),
+	  nextMatch( ArenaAllocator< int >( arena ) ),
+	  rightIndex( 0, ArenaStringHash(), ArenaStringEqual(), ArenaAllocator< pair< const ArenaString, MatchList > >( arena ) ),
+	  codeMatches( ArenaAllocator< MatchList >( arena ) )
+{
+	leftChild = left;
+	rightChild = right;
+	leftKeyIndexes = leftKeys;
+	rightKeyIndexes = rightKeys;
+	rightColumns = rightColumnIndexes;
+	leftOuter = outerJoin;
+	joinCondition = condition;
+	expectedRows = 0;
+	rightCount = 0;
+	matchPosition = -1;
+	leftMatched = false;
+	leftValid = false;
+	keyDictionary = NULL;
+	if( rightKeyIndexes.size() == 1 )
+	{
+		keyDictionary = rightChild->columnDictionaries[ rightKeyIndexes[ 0 ] ];
+	}
+
+	setAttributes( leftChild->attributes );
+}
+
+JoinOperator::~JoinOperator()
+{
+
+}
+
+/**
+ * @brief JoinOperator buildKey
+ *
+ * @details builds the hash key of a tuple in keyBuffer
+ *
+ * @par Algorithm the text of the key attributes is joined with tabs, which
+ *      can not be part of a stored value
+ *
+ * @param [in] Row &tuple
+ *
+ * @param [in] vector< int > &keyIndexes
+ *
+ * @return bool false if a key attribute is null, such a tuple matches
+ *         nothing
+ *
+ * @note None
+ */
+bool JoinOperator::buildKey( Row &tuple, vector< int > &keyIndexes )
+{
+	int keySize = keyIndexes.size();
+	keyBuffer.clear();
+	for( int index = 0; index < keySize; index++ )
+	{
+		if( tuple.isNull( keyIndexes[ index ] ) )
+		{
+			return false;
+		}
+		if( index > 0 )
+		{
+			keyBuffer += '\t';
+		}
+		tuple.appendText( keyIndexes[ index ], keyBuffer );
+	}
+	return true;
+}
+
+/**
+ * @brief JoinOperator leftKeyCode
+ *
+ * @details returns the code in keyDictionary of the key of leftTuple
+ *
+ * @par Algorithm a left key that is itself encoded is translated once per
+ *      code of its dictionary, so most left tuples are matched without
+ *      reading their text
+ *
+ * @return int the code, -1 if the key is null or not in keyDictionary
+ *
+ * @note None
+ */
+int JoinOperator::leftKeyCode()
+{
+	int keyIndex = leftKeyIndexes[ 0 ];
+	if( leftTuple.isNull( keyIndex ) )
+	{
+		return -1;
+	}
+
+	TextView key;
+	if( leftTuple.formats[ keyIndex ] == FORMAT_CODE )
+	{
+		int leftCode = leftTuple.slots[ keyIndex ].intValue;
+		if( leftCode >= (int) leftCodes.size() )
+		{
+			leftCodes.resize( leftCode + 1, -2 );
+		}
+		if( leftCodes[ leftCode ] == -2 )
+		{
+			key = leftTuple.getText( keyIndex, keyBuffer );
+			leftCodes[ leftCode ] = keyDictionary->lookup( key.data, key.length );
+		}
+		return leftCodes[ leftCode ];
+	}
+	key = leftTuple.getText( keyIndex, keyBuffer );
+	return keyDictionary->lookup( key.data, key.length );
+}
+
+/**
+ * @brief JoinOperator addMatch
+ *
+ * @details adds the right tuple being read to the tuples of its key
+ *
+ * @param [in] MatchList &matches - first is -1 for a key without tuples
+ *
+ * @return None
+ *
+ * @note None
+ */
+void JoinOperator::addMatch( MatchList &matches )
+{
+	if( matches.first < 0 )
+	{
+		matches.first = rightCount;
+	}
+	else
+	{
+		nextMatch[ matches.last ] = rightCount;
+	}
+	matches.last = rightCount;
+}
+
+/**
+ * @brief JoinOperator open
+ *
+ * @details reads the right child into the statement arena and hashes it on
+ *          the join key, the left child is streamed
+ *
+ * @par Algorithm only rightColumns of a right tuple are kept: the slot and
+ *      format of each value, plus one copy in the arena of the text of its
+ *      strings, so storing the right side takes a few chunk allocations
+ *      rather than one per value. Each key maps to the first and last right
+ *      tuples holding it, the tuples in between are chained through
+ *      nextMatch, so matches come out in table order. The hash table is
+ *      sized from expectedRows so that it is not rehashed while it is built.
+ *      When the key is a single encoded right attribute, the tuples are
+ *      found by the key's code in an array instead, only values that are
+ *      not codes go through the hash table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void JoinOperator::open()
+{
+	Row tuple;
+	int columnSize = rightColumns.size();
+
+	rightSlots.clear();
+	rightFormats.clear();
+	rightText.clear();
+	nextMatch.clear();
+	rightIndex.clear();
+	leftCodes.clear();
+	codeMatches.clear();
+	if( keyDictionary != NULL )
+	{
+		MatchList noMatches = { -1, -1 };
+		codeMatches.assign( keyDictionary->values.size(), noMatches );
+	}
+	rightCount = 0;
+	if( expectedRows > 0 )
+	{
+		rightSlots.reserve( (size_t) expectedRows * columnSize );
+		rightFormats.reserve( (size_t) expectedRows * columnSize );
+		rightText.reserve( (size_t) expectedRows );
+		if( !rightKeyIndexes.empty() )
+		{
+			nextMatch.reserve( (size_t) expectedRows );
+			rightIndex.reserve( (size_t) expectedRows );
+		}
+	}
+
+	rightChild->open();
+	while( rightChild->next( tuple ) )
+	{
+		textBuffer.clear();
+		for( int index = 0; index < columnSize; index++ )
+		{
+			int column = rightColumns[ index ];
+			RowSlot slot = tuple.slots[ column ];
+			unsigned char format = tuple.formats[ column ];
+			if( format == FORMAT_TEXT )
+			{
+				slot.text.offset = textBuffer.size();
+				textBuffer.append( tuple.text, tuple.slots[ column ].text.offset, slot.text.length );
+				if( tuple.isNull( column ) )
+				{
+					format = STORED_NULL;
+				}
+			}
+			rightSlots.push_back( slot );
+			rightFormats.push_back( format );
+		}
+		rightText.push_back( textBuffer.empty() ? NULL : arena->copy( textBuffer.data(), textBuffer.size() ) );
+
+		if( !rightKeyIndexes.empty() )
+		{
+			nextMatch.push_back( -1 );
+			if( keyDictionary != NULL && tuple.formats[ rightKeyIndexes[ 0 ] ] == FORMAT_CODE )
+			{
+				addMatch( codeMatches[ tuple.slots[ rightKeyIndexes[ 0 ] ].intValue ] );
+			}
+			else if( buildKey( tuple, rightKeyIndexes ) )
+			{
+				ArenaString key = { keyBuffer.data(), keyBuffer.size() };
+				HashIndex::iterator found = rightIndex.find( key );
+				if( found == rightIndex.end() )
+				{
+					MatchList matches = { -1, -1 };
+					key.data = arena->copy( keyBuffer.data(), keyBuffer.size() );
+					found = rightIndex.insert( make_pair( key, matches ) ).first;
+				}
+				addMatch( found->second );
+			}
+		}
+		rightCount++;
+	}
+	rightChild->close();
+
+	leftChild->open();
+	leftValid = false;
+}
+
+/**
+ * @brief JoinOperator next
+ *
+ * @details returns the next joined tuple
+ *
+ * @par Algorithm hash join: the current left tuple is looked up once and
+ *      its matching right tuples are returned one per call, only pulling a
+ *      new left tuple once the current one has no more matches. Without an
+ *      equality every right tuple is a match. The rest of the join condition
+ *      is checked on the joined tuple. For a left outer join an unmatched
+ *      left tuple is returned with the right attributes left null
+ *
+ * @param [out] Row &tuple
+ *
+ * @return bool true if a tuple was produced
+ *
+ * @note None
+ */
+bool JoinOperator::next( Row &tuple )
+{
+	int columnSize = rightColumns.size();
+
+	while( true )
+	{
+		if( leftValid )
+		{
+			while( matchPosition >= 0 )
+			{
+				size_t first = (size_t) matchPosition * columnSize;
+				const char * text = rightText[ matchPosition ];
+				if( rightKeyIndexes.empty() )
+				{
+					matchPosition = ( matchPosition + 1 < rightCount ) ? matchPosition + 1 : -1;
+				}
+				else
+				{
+					matchPosition = nextMatch[ matchPosition ];
+				}
+
+				tuple = leftTuple;
+				for( int index = 0; index < columnSize; index++ )
+				{
+					unsigned char format = rightFormats[ first + index ];
+					bool null = ( format == STORED_NULL );
+					tuple.setSlot( rightColumns[ index ], rightSlots[ first + index ], null ? FORMAT_TEXT : format,
+						null, text );
+				}
+				if( joinCondition == NULL || joinCondition->evaluate( tuple ) )
+				{
+					leftMatched = true;
+					return true;
+				}
+			}
+
+			if( leftOuter && !leftMatched )
+			{
+				leftMatched = true;
+				tuple = leftTuple;
+				return true;
+			}
+		}
+
+		if( !leftChild->next( leftTuple ) )
+		{
+			leftValid = false;
+			return false;
+		}
+		leftValid = true;
+		leftMatched = false;
+
+		int code;
+		if( rightKeyIndexes.empty() )
+		{
+			matchPosition = ( rightCount > 0 ) ? 0 : -1;
+		}
+		else if( keyDictionary != NULL && ( code = leftKeyCode() ) >= 0 )
+		{
+			matchPosition = ( code < (int) codeMatches.size() ) ? codeMatches[ code ].first : -1;
+		}
+		else if( rightIndex.empty() || !buildKey( leftTuple, leftKeyIndexes ) )
+		{
+			matchPosition = -1;
+		}
+		else
+		{
+			ArenaString key = { keyBuffer.data(), keyBuffer.size() };
+			HashIndex::iterator found = rightIndex.find( key );
+			matchPosition = ( found == rightIndex.end() ) ? -1 : found->second.first;
+		}
+	}
+}
+
+void JoinOperator::close()
+{
+	leftChild->close();
+	rightSlots.clear();
+	rightFormats.clear();
+	rightText.clear();
+	nextMatch.clear();
+	rightIndex.clear();
+	codeMatches.clear();
+	leftCodes.clear();
+	rightCount = 0;
+	matchPosition = -1;
+}
+
+string JoinOperator::name()
+{
+	string joinName = rightKeyIndexes.empty() ? "Nested Loop" : "Hash";
+	return joinName + ( leftOuter ? " Left Outer Join" : " Join" );
+}
+
+vector< Operator * > JoinOperator::inputs()
+{
+	vector< Operator * > children;
+	children.push_back( leftChild );
+	children.push_back( rightChild );
+	return children;
+}
+
+/**
+ * @brief LimitOperator constructor
+ *
+ * @details skips qLimit.rowOffset tuples then returns at most
+ *          qLimit.rowLimit tuples
+ *
+ * @param [in] Operator * childOperator
+ *
+ * @param [in] QueryLimit limit
+ *
+ * @note None
+ */
+LimitOperator::LimitOperator( Operator * childOperator, QueryLimit limit )
+{
+	child = childOperator;
+	qLimit = limit;
+	rowsReturned = 0;
+	offsetSkipped = false;
+	setAttributes( child->attributes );
+
+	stringstream text;
+	if( qLimit.rowLimit != NO_LIMIT )
+	{
+		text << qLimit.rowLimit;
+	}
+	if( qLimit.rowOffset > 0 )
+	{
+		text << ( qLimit.rowLimit != NO_LIMIT ? " " : "" ) << "offset " << qLimit.rowOffset;
+	}
+	detail = text.str();
+}
+
+LimitOperator::~LimitOperator()
+{
+
+}
+
+void LimitOperator::open()
+{
+	rowsReturned = 0;
+	offsetSkipped = false;
+	child->open();
+}
+
+/**
+ * @brief LimitOperator next
+ *
+ * @details returns the next tuple until the limit is reached
+ *
+ * @par Algorithm once the limit is reached the child is never pulled
+ *      again, so nothing below the limit reads further than needed
+ *
+ * @param [out] Row &tuple
+ *
+ * @return bool true if a tuple was produced
+ *
+ * @note None
+ */
+bool LimitOperator::next( Row &tuple )
+{
+	if( qLimit.rowLimit != NO_LIMIT && rowsReturned >= qLimit.rowLimit )
+	{
+		return false;
+	}
+
+	if( !offsetSkipped )
+	{
+		offsetSkipped = true;
+		for( int index = 0; index < qLimit.rowOffset; index++ )
+		{
+			if( !child->next( tuple ) )
+			{
+				return false;
+			}
+		}
+	}
+
+	if( !child->next( tuple ) )
+	{
+		return false;
+	}
+	rowsReturned++;
+	return true;
+}
+
+void LimitOperator::close()
+{
+	child->close();
+}
+
+string LimitOperator::name()
+{
+	return "Limit";
+}
+
+vector< Operator * > LimitOperator::inputs()
+{
+	return vector< Operator * >( 1, child );
+}
+
+/**
+ * @brief ProfileOperator constructor
+ *
+ * @details measures childOperator, output attributes match the child
+ *
+ * @param [in] Operator * childOperator
+ *
+ * @note None
+ */
+ProfileOperator::ProfileOperator( Operator * childOperator )
+{
+	child = childOperator;
+	setAttributes( child->attributes );
+	estimatedRows = child->estimatedRows;
+	actualRows = 0;
+	elapsedSeconds = 0;
+	bytesRead = 0;
+	allocations = 0;
+	startTime = 0;
+	startBytes = 0;
+	startAllocations = 0;
+}
+
+ProfileOperator::~ProfileOperator()
+{
+
+}
+
+void ProfileOperator::startMeasure()
+{
+	startBytes = scanBytesRead;
+	startAllocations = allocationCount;
+	startTime = currentSeconds();
+}
+
+void ProfileOperator::stopMeasure()
+{
+	elapsedSeconds += currentSeconds() - startTime;
+	bytesRead += scanBytesRead - startBytes;
+	allocations += allocationCount - startAllocations;
+}
+
+void ProfileOperator::open()
+{
+	startMeasure();
+	child->open();
+	stopMeasure();
+}
+
+/**
+ * @brief ProfileOperator next
+ *
+ * @details pulls a tuple from the child, adding the time, bytes read and
+ *          allocations of the call to the child's totals
+ *
+ * @param [out] Row &tuple
+ *
+ * @return bool true if a tuple was produced
+ *
+ * @note None
+ */
+bool ProfileOperator::next( Row &tuple )
+{
+	startMeasure();
+	bool produced = child->next( tuple );
+	stopMeasure();
+	if( produced )
+	{
+		actualRows++;
+	}
+	return produced;
+}
+
+void ProfileOperator::close()
+{
+	startMeasure();
+	child->close();
+	stopMeasure();
+}
+
+string ProfileOperator::name()
+{
+	return child->name();
+}
+
+vector< Operator * > ProfileOperator::inputs()
+{
+	return child->inputs();
+}
+
+/**
+ * @brief profileOperator
+ *
+ * @details places a ProfileOperator above an operator when profiling
+ *
+ * @param [in] Operator * op
+ *
+ * @param [in] bool profile - true for EXPLAIN ANALYZE
+ *
+ * @param [in] vector< Operator * > &owned - the profiling operator is
+ *             added, to be freed with the plan
+ *
+ * @return Operator * the operator the parent should pull from
+ *
+ * @note None
+ */
+Operator * profileOperator( Operator * op, bool profile, vector< Operator * > &owned )
+{
+	if( !profile )
+	{
+		return op;
+	}
+	Operator * profiler = new ProfileOperator( op );
+	owned.push_back( profiler );
+	return profiler;
+}
+
+/**
+ * @brief deleteOperators
+ *
+ * @details frees the operators of a plan
+ *
+ * @param [in] vector< Operator * > &owned
+ *
+ * @return None
+ *
+ * @note None
+ */
+void deleteOperators( vector< Operator * > &owned )
+{
+	int ownedSize = owned.size();
+	for( int index = 0; index < ownedSize; index++ )
+	{
+		delete owned[ index ];
+	}
+	owned.clear();
+}
+
+/**
+ * @brief explainOperator
+ *
+ * @details outputs an operator and, indented beneath it, its inputs
+ *
+ * @par Algorithm each line holds the operator, what it works on and its
+ *      estimated rows. After EXPLAIN ANALYZE the figures of the profiling
+ *      operator above it follow: actual rows, wall time, bytes read from
+ *      table files and allocations, each including its inputs
+ *
+ * @param [in] Operator * op
+ *
+ * @param [in] int depth - 0 for the root
+ *
+ * @param [in] bool analyze - true if the plan was executed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void explainOperator( Operator * op, int depth, bool analyze )
+{
+	ProfileOperator * profiler = dynamic_cast< ProfileOperator * >( op );
+	Operator * shown = ( profiler == NULL ) ? op : profiler->child;
+	stringstream line;
+
+	line << "-- " << string( depth * 2, ' ' );
+	if( depth > 0 )
+	{
+		line << "-> ";
+	}
+	line << shown->name();
+	if( !shown->detail.empty() )
+	{
+		line << " " << shown->detail;
+	}
+	if( shown->estimatedRows >= 0 )
+	{
+		line << "  (estimated rows " << (long long) ( shown->estimatedRows + 0.5 ) << ")";
+	}
+	if( analyze && profiler != NULL )
+	{
+		line << " (actual rows " << profiler->actualRows;
+		line << ", time " << fixed << setprecision( 3 ) << profiler->elapsedSeconds * 1000 << " ms";
+		line << ", bytes read " << profiler->bytesRead;
+		line << ", allocations " << profiler->allocations << ")";
+	}
+	cout << line.str() << endl;
+
+	vector< Operator * > children = shown->inputs();
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		explainOperator( children[ index ], depth + 1, analyze );
+	}
+}
+
+/**
+ * @brief summarizePlan
+ *
+ * @details returns a plan on one line, each operator followed by its
+ *          inputs in brackets, e.g. "Filter a = 1 [Seq Scan on t]"
+ *
+ * @param [in] Operator * op - root of the plan
+ *
+ * @return string
+ *
+ * @note None
+ */
+string summarizePlan( Operator * op )
+{
+	ProfileOperator * profiler = dynamic_cast< ProfileOperator * >( op );
+	Operator * shown = ( profiler == NULL ) ? op : profiler->child;
+	string summary = shown->name();
+	if( !shown->detail.empty() )
+	{
+		summary += " " + shown->detail;
+	}
+
+	vector< Operator * > children = shown->inputs();
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		summary += ( index == 0 ) ? " [" : ", ";
+		summary += summarizePlan( children[ index ] );
+	}
+	if( childSize > 0 )
+	{
+		summary += "]";
+	}
+	return summary;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,215 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Operator.h
+ *
+ * @brief Definition file for the query operators
+ *
+ * @details Specifies the pull based operators (scan, filter, project, join,
+ *          limit) that are chained together to execute a query one tuple
+ *          at a time, and the profiling operator EXPLAIN ANALYZE places
+ *          above each of them
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include "Table.h"
+#include "Predicate.h"
+#include "Arena.h"
+#include "Dictionary.h"
+#include "Storage.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef OPERATOR_H
+#define OPERATOR_H
+
+const int EXPLAIN_NONE = 0;
+const int EXPLAIN_PLAN = 1;
+const int EXPLAIN_ANALYZE = 2;
+
+class Operator{
+	public:
+		vector< Attribute > attributes;
+		//VALUE_ type and dictionary of each attribute, the layout of the rows
+		//produced
+		vector< int > columnTypes;
+		vector< const Dictionary * > columnDictionaries;
+		//estimated tuples produced, -1 if not estimated
+		double estimatedRows;
+		//what the operator works on (its condition, join keys), for EXPLAIN
+		string detail;
+
+		Operator();
+		virtual ~Operator();
+		virtual void open() = 0;
+		virtual bool next( Row &tuple ) = 0;
+		virtual void close() = 0;
+		virtual string name() = 0;
+		virtual vector< Operator * > inputs();
+		void setAttributes( const vector< Attribute > &newAttributes );
+};
+
+class TableScan : public Operator{
+	public:
+		string filePath;
+		//reads plain and compressed table files alike
+		TableReader reader;
+		//codec of the table file, kept when the table is rewritten
+		unsigned char codec;
+		int columnCount;
+		int layoutOffset;
+		//record being split, reused between calls
+		string line;
+		//dictionaries of the encoded attributes of the table
+		TableDictionary dictionary;
+
+		TableScan( string scanFilePath );
+		~TableScan();
+		void setLayout( vector< Attribute > &layoutAttributes, int offset );
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+};
+
+class FilterOperator : public Operator{
+	public:
+		Operator * child;
+		ConditionKernel * condition;
+
+		FilterOperator( Operator * childOperator, ConditionKernel * filterCondition );
+		~FilterOperator();
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+		vector< Operator * > inputs();
+};
+
+class ProjectOperator : public Operator{
+	public:
+		Operator * child;
+		vector< int > attributeIndexes;
+		Row childTuple;
+
+		ProjectOperator( Operator * childOperator, vector< int > indexes );
+		~ProjectOperator();
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+		vector< Operator * > inputs();
+};
+
+//right tuples with the same join key, by position
+struct MatchList{
+	int first;
+	int last;
+};
+
+class JoinOperator : public Operator{
+	public:
+		Operator * leftChild;
+		Operator * rightChild;
+		vector< int > leftKeyIndexes;
+		vector< int > rightKeyIndexes;
+		vector< int > rightColumns;
+		bool leftOuter;
+		ConditionKernel * joinCondition;
+		//estimated right tuples, used to size the hash table
+		double expectedRows;
+
+		JoinOperator( Operator * left, Operator * right, vector< int > leftKeys, vector< int > rightKeys,
+			vector< int > rightColumnIndexes, bool outerJoin, ConditionKernel * condition );
+		~JoinOperator();
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+		vector< Operator * > inputs();
+
+	private:
+		typedef unordered_map< ArenaString, MatchList, ArenaStringHash, ArenaStringEqual,
+			ArenaAllocator< pair< const ArenaString, MatchList > > > HashIndex;
+
+		//the right tuples are kept in the arena of the statement
+		Arena * arena;
+		//slot and format of each of rightColumns of each right tuple, one
+		//tuple after the other, and the text of each tuple
+		vector< RowSlot, ArenaAllocator< RowSlot > > rightSlots;
+		vector< unsigned char, ArenaAllocator< unsigned char > > rightFormats;
+		vector< const char *, ArenaAllocator< const char * > > rightText;
+		//position of the next right tuple with the same key, -1 after the last
+		vector< int, ArenaAllocator< int > > nextMatch;
+		HashIndex rightIndex;
+		//a single key on an encoded right attribute: the right tuples of each
+		//code of its dictionary, and the code in it of each code of the left
+		//key's dictionary (-2 until looked up, -1 if not in it)
+		const Dictionary * keyDictionary;
+		vector< MatchList, ArenaAllocator< MatchList > > codeMatches;
+		vector< int > leftCodes;
+		int rightCount;
+		Row leftTuple;
+		string keyBuffer;
+		string textBuffer;
+		//right tuple to try next for the current left tuple, -1 if none
+		int matchPosition;
+		bool leftMatched;
+		bool leftValid;
+
+		bool buildKey( Row &tuple, vector< int > &keyIndexes );
+		int leftKeyCode();
+		void addMatch( MatchList &matches );
+};
+
+class LimitOperator : public Operator{
+	public:
+		Operator * child;
+		QueryLimit qLimit;
+
+		LimitOperator( Operator * childOperator, QueryLimit limit );
+		~LimitOperator();
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+		vector< Operator * > inputs();
+
+	private:
+		int rowsReturned;
+		bool offsetSkipped;
+};
+
+//measures the operator beneath it, its figures include that operator's inputs
+class ProfileOperator : public Operator{
+	public:
+		Operator * child;
+		long long actualRows;
+		double elapsedSeconds;
+		long long bytesRead;
+		long long allocations;
+
+		ProfileOperator( Operator * childOperator );
+		~ProfileOperator();
+		void open();
+		bool next( Row &tuple );
+		void close();
+		string name();
+		vector< Operator * > inputs();
+
+	private:
+		void startMeasure();
+		void stopMeasure();
+		double startTime;
+		long long startBytes;
+		long long startAllocations;
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,275 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file PageCache.cpp
+ *
+ * @brief Implementation file for the PageCache class
+ *
+ * @details Implements the 2Q cache of table file pages
+ *
+ * @Note Requires PageCache.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "PageCache.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PAGECACHE_CPP
+#define PAGECACHE_CPP
+
+//pages of the table files read by every session
+PageCache pageCache( PAGE_CACHE_PAGES );
+
+bool PageCache::PageKey::operator<( const PageKey &other ) const
+{
+	if( file.inode != other.file.inode )
+	{
+		return file.inode < other.file.inode;
+	}
+	if( page != other.page )
+	{
+		return page < other.page;
+	}
+	if( file.device != other.file.device )
+	{
+		return file.device < other.file.device;
+	}
+	if( file.birthSeconds != other.file.birthSeconds )
+	{
+		return file.birthSeconds < other.file.birthSeconds;
+	}
+	return file.birthNanoseconds < other.file.birthNanoseconds;
+}
+
+PageCache::PageCache( size_t pageCount )
+{
+	capacity = pageCount;
+}
+
+/**
+ * @brief PageCache getFileVersion
+ *
+ * @details returns the version of an open file
+ *
+ * @param [in] int fd
+ *
+ * @param [out] FileVersion &version
+ *
+ * @return bool false if the file system does not keep when an inode was
+ *         made, its pages are then not cached
+ *
+ * @note None
+ */
+bool PageCache::getFileVersion( int fd, FileVersion &version )
+{
+	struct statx fileInfo;
+	if( statx( fd, "", AT_EMPTY_PATH, STATX_INO | STATX_BTIME, &fileInfo ) != 0 ||
+		( fileInfo.stx_mask & STATX_BTIME ) == 0 )
+	{
+		return false;
+	}
+	version.device = ( (unsigned long long) fileInfo.stx_dev_major << 32 ) | fileInfo.stx_dev_minor;
+	version.inode = fileInfo.stx_ino;
+	version.birthSeconds = fileInfo.stx_btime.tv_sec;
+	version.birthNanoseconds = fileInfo.stx_btime.tv_nsec;
+	return true;
+}
+
+/**
+ * @brief PageCache find
+ *
+ * @details copies the first bytes of a cached page
+ *
+ * @par Algorithm a frequently used page moves to the front of its queue, a
+ *      page read once stays where it is so that a scan reading it again
+ *      soon does not make it look frequently used
+ *
+ * @param [in] const FileVersion &file
+ *
+ * @param [in] long long page - index of the page in the file
+ *
+ * @param [in] size_t size - bytes wanted
+ *
+ * @param [out] char * data
+ *
+ * @return bool false if the page is not cached with that many bytes
+ *
+ * @note None
+ */
+bool PageCache::find( const FileVersion &file, long long page, size_t size, char * data )
+{
+	PageKey key;
+	key.file = file;
+	key.page = page;
+
+	lock_guard< mutex > state( stateMutex );
+	map< PageKey, CachedPage >::iterator found = pages.find( key );
+	if( found == pages.end() || found->second.data.size() < size )
+	{
+		Metrics::count( METRIC_PAGE_CACHE_MISSES );
+		return false;
+	}
+
+	if( found->second.frequent )
+	{
+		frequentQueue.splice( frequentQueue.begin(), frequentQueue, found->second.position );
+	}
+	memcpy( data, found->second.data.data(), size );
+	Metrics::count( METRIC_PAGE_CACHE_HITS );
+	return true;
+}
+
+/**
+ * @brief PageCache add
+ *
+ * @details caches a page read from a file
+ *
+ * @par Algorithm a page whose key is still remembered was read again after
+ *      it left the once queue, so it goes to the frequent queue, anything
+ *      else to the once queue. A page cached already only takes the longer
+ *      data of a grown last page
+ *
+ * @param [in] const FileVersion &file
+ *
+ * @param [in] long long page
+ *
+ * @param [in] const char * data
+ *
+ * @param [in] size_t size
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageCache::add( const FileVersion &file, long long page, const char * data, size_t size )
+{
+	PageKey key;
+	key.file = file;
+	key.page = page;
+
+	lock_guard< mutex > state( stateMutex );
+	if( capacity == 0 )
+	{
+		return;
+	}
+	map< PageKey, CachedPage >::iterator found = pages.find( key );
+	if( found != pages.end() )
+	{
+		if( found->second.data.size() < size )
+		{
+			found->second.data.assign( data, size );
+		}
+		return;
+	}
+
+	CachedPage &cached = pages[ key ];
+	cached.data.assign( data, size );
+	map< PageKey, list< PageKey >::iterator >::iterator ghost = ghosts.find( key );
+	cached.frequent = ghost != ghosts.end();
+	if( cached.frequent )
+	{
+		ghostQueue.erase( ghost->second );
+		ghosts.erase( ghost );
+		frequentQueue.push_front( key );
+		cached.position = frequentQueue.begin();
+	}
+	else
+	{
+		onceQueue.push_front( key );
+		cached.position = onceQueue.begin();
+	}
+
+	while( pages.size() > capacity )
+	{
+		evict();
+	}
+}
+
+/**
+ * @brief PageCache evict
+ *
+ * @details removes a page: the oldest page read once while that queue is
+ *          over its share, otherwise the least recently used frequent page
+ *
+ * @return None
+ *
+ * @note the caller holds stateMutex
+ */
+void PageCache::evict()
+{
+	size_t onceLimit = capacity * PAGE_CACHE_ONCE_PERCENT / 100;
+	if( !onceQueue.empty() && ( onceQueue.size() > onceLimit || frequentQueue.empty() ) )
+	{
+		PageKey key = onceQueue.back();
+		onceQueue.pop_back();
+		pages.erase( key );
+
+		ghostQueue.push_front( key );
+		ghosts[ key ] = ghostQueue.begin();
+		if( ghostQueue.size() > capacity * PAGE_CACHE_GHOST_PERCENT / 100 )
+		{
+			ghosts.erase( ghostQueue.back() );
+			ghostQueue.pop_back();
+		}
+	}
+	else
+	{
+		pages.erase( frequentQueue.back() );
+		frequentQueue.pop_back();
+	}
+}
+
+/**
+ * @brief PageCache resize
+ *
+ * @details changes how many pages are cached, 0 turns the cache off
+ *
+ * @param [in] size_t pageCount
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageCache::resize( size_t pageCount )
+{
+	lock_guard< mutex > state( stateMutex );
+	capacity = pageCount;
+	while( !pages.empty() && pages.size() > capacity )
+	{
+		evict();
+	}
+	if( capacity == 0 )
+	{
+		ghostQueue.clear();
+		ghosts.clear();
+	}
+}
+
+/**
+ * @brief PageCache scanLimit
+ *
+ * @details returns the most pages a scan adds to the cache, a bigger
+ *          version would push out every page read once before it
+ *
+ * @return size_t
+ *
+ * @note None
+ */
+size_t PageCache::scanLimit()
+{
+	lock_guard< mutex > state( stateMutex );
+	return capacity * PAGE_CACHE_ONCE_PERCENT / 100;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,90 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file PageCache.h
+ *
+ * @brief Definition file for the PageCache class
+ *
+ * @details Specifies the cache of table file pages shared by every session.
+ *          A page is TABLE_READ_SIZE bytes of one version of a table file,
+ *          a file replacing another is a new version, so a cached page is
+ *          never out of date. Only the last page of a version grows as
+ *          records are appended, it is used if it holds the bytes asked for
+ *
+ *          Pages are replaced by 2Q: a page read for the first time waits
+ *          in a short FIFO queue, a page read again after it left that
+ *          queue is moved to an LRU queue of frequently used pages. A scan
+ *          through many pages only passes through the FIFO queue, so the
+ *          pages of hot tables are kept. Scans of versions bigger than the
+ *          FIFO queue do not add their pages at all, they read through the
+ *          ring of their own read-ahead buffers
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+//pages cached unless --page-cache is given
+const size_t PAGE_CACHE_PAGES = 256;
+//shares of the cache for pages read once, and for the keys of pages
+//remembered after they left it
+const int PAGE_CACHE_ONCE_PERCENT = 25;
+const int PAGE_CACHE_GHOST_PERCENT = 50;
+
+//a version of a file, known by its inode and when the inode was made
+struct FileVersion{
+	unsigned long long device;
+	unsigned long long inode;
+	long long birthSeconds;
+	unsigned birthNanoseconds;
+};
+
+class PageCache{
+	public:
+		PageCache( size_t pageCount );
+		static bool getFileVersion( int fd, FileVersion &version );
+		bool find( const FileVersion &file, long long page, size_t size, char * data );
+		void add( const FileVersion &file, long long page, const char * data, size_t size );
+		void resize( size_t pageCount );
+		size_t scanLimit();
+
+	private:
+		struct PageKey{
+			FileVersion file;
+			long long page;
+			bool operator<( const PageKey &other ) const;
+		};
+		struct CachedPage{
+			string data;
+			bool frequent;
+			list< PageKey >::iterator position;
+		};
+
+		mutex stateMutex;
+		size_t capacity;
+		map< PageKey, CachedPage > pages;
+		//pages read once, newest first, and pages read again, most recent
+		//first
+		list< PageKey > onceQueue;
+		list< PageKey > frequentQueue;
+		//keys of pages that left the once queue, newest first
+		list< PageKey > ghostQueue;
+		map< PageKey, list< PageKey >::iterator > ghosts;
+
+		PageCache( const PageCache &other );
+		PageCache &operator=( const PageCache &other );
+		void evict();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
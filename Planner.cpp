@@ -0,0 +1,786 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Planner.cpp
+ *
+ * @brief Implementation file for the JoinPlanner class
+ *
+ * @details Implements all member methods of the JoinPlanner class. The where
+ *          and on conditions are split into conjuncts; conjuncts on a single
+ *          table filter that table's scan, the others become hash join keys
+ *          or join conditions once all of their tables have been joined
+ *
+ * @Note Requires Planner.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "Planner.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PLANNER_CPP
+#define PLANNER_CPP
+
+//declaration of the predicate helpers
+vector< string > tokenizeCondition( string input );
+int resolveAttribute( string name, vector< Attribute > &attributes, vector< string > &qualifiers );
+void referencedAttributes( PredicateNode * node, vector< int > &indexes );
+vector< AttributeStatistics * > getAttributeStatistics( TableStatistics &statistics, vector< Attribute > &attributes );
+bool lessSelective( PredicateNode * a, PredicateNode * b );
+string conditionText( PredicateNode * node );
+Operator * profileOperator( Operator * op, bool profile, vector< Operator * > &owned );
+
+/**
+ * @brief conjunctionText
+ *
+ * @details writes conjuncts back as one condition, for EXPLAIN
+ *
+ * @param [in] vector< PredicateNode * > &nodes
+ *
+ * @return string
+ *
+ * @note None
+ */
+string conjunctionText( vector< PredicateNode * > &nodes )
+{
+	string text;
+	int nodeSize = nodes.size();
+	for( int index = 0; index < nodeSize; index++ )
+	{
+		if( index > 0 )
+		{
+			text += " AND ";
+		}
+		if( nodes[ index ]->nodeType == PREDICATE_OR )
+		{
+			text += "(" + conditionText( nodes[ index ] ) + ")";
+		}
+		else
+		{
+			text += conditionText( nodes[ index ] );
+		}
+	}
+	return text;
+}
+
+/**
+ * @brief countTables
+ *
+ * @details counts the tables in a table mask
+ *
+ * @param [in] unsigned int tableMask
+ *
+ * @return int
+ *
+ * @note None
+ */
+int countTables( unsigned int tableMask )
+{
+	int count = 0;
+	while( tableMask != 0 )
+	{
+		tableMask &= tableMask - 1;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief JoinPlanner constructor
+ *
+ * @details nothing is planned until plan is called
+ *
+ * @note None
+ */
+JoinPlanner::JoinPlanner()
+{
+	root = NULL;
+	profile = false;
+}
+
+/**
+ * @brief JoinPlanner destructor
+ *
+ * @details frees the operators, kernels and predicates of the plan
+ *
+ * @note None
+ */
+JoinPlanner::~JoinPlanner()
+{
+	int size = operators.size();
+	for( int index = 0; index < size; index++ )
+	{
+		delete operators[ index ];
+	}
+	size = scans.size();
+	for( int index = 0; index < size; index++ )
+	{
+		delete scans[ index ];
+	}
+	size = kernels.size();
+	for( int index = 0; index < size; index++ )
+	{
+		delete kernels[ index ];
+	}
+	size = predicates.size();
+	for( int index = 0; index < size; index++ )
+	{
+		delete predicates[ index ];
+	}
+}
+
+/**
+ * @brief plan
+ *
+ * @details builds the operator tree for a select over several tables
+ *
+ * @par Algorithm the tables before the first left outer join are joined in
+ *      the order chosen by orderJoins, the where condition and their on
+ *      conditions being interchangeable. The remaining tables are joined in
+ *      the order they are written, since moving a table across an outer
+ *      join changes the result. Where conjuncts that could not be applied
+ *      inside the joins filter the joined tuples, then the selected
+ *      attributes are projected in the order they are written and the limit
+ *      is applied. Every operator records its estimated rows and what it
+ *      works on for EXPLAIN
+ *
+ * @param [in] string databasePath - path to the database directory ending
+ *             in a slash
+ *
+ * @param [in] vector< JoinTable > &joinTables - tables in from order
+ *
+ * @param [in] string whereType
+ *
+ * @param [in] string queryType - * or the selected attributes
+ *
+ * @param [in] QueryLimit qLimit
+ *
+ * @param [out] string &errorMessage - reason the plan failed
+ *
+ * @return bool false if the query can not be planned
+ *
+ * @note None
+ */
+bool JoinPlanner::plan( string databasePath, vector< JoinTable > &joinTables, string whereType, string queryType,
+	QueryLimit qLimit, string &errorMessage )
+{
+	tables = joinTables;
+	int tableSize = tables.size();
+	if( tableSize > MAX_JOIN_TABLES )
+	{
+		errorMessage = "too many tables are joined";
+		return false;
+	}
+
+	//lay the attributes of every table side by side
+	vector< int > tableOffsets;
+	for( int table = 0; table < tableSize; table++ )
+	{
+		string tableFilePath = tables[ table ].filePath;
+		if( tableFilePath.empty() )
+		{
+			tableFilePath = databasePath + tables[ table ].tableName;
+		}
+		TableScan * scan = new TableScan( tableFilePath );
+		scans.push_back( scan );
+
+		string qualifier = tables[ table ].tableVariable;
+		if( qualifier.empty() )
+		{
+			qualifier = tables[ table ].tableName;
+		}
+
+		tableOffsets.push_back( attributes.size() );
+		int attrSize = scan->attributes.size();
+		attributes.insert( attributes.end(), scan->attributes.begin(), scan->attributes.end() );
+		qualifiers.insert( qualifiers.end(), attrSize, qualifier );
+		tableOfAttribute.insert( tableOfAttribute.end(), attrSize, table );
+		if( tables[ table ].statistics != NULL )
+		{
+			vector< AttributeStatistics * > tableStatistics = getAttributeStatistics( *tables[ table ].statistics, scan->attributes );
+			attributeStatistics.insert( attributeStatistics.end(), tableStatistics.begin(), tableStatistics.end() );
+		}
+		else
+		{
+			attributeStatistics.insert( attributeStatistics.end(), attrSize, (AttributeStatistics *) NULL );
+		}
+		if( tables[ table ].statistics != NULL )
+		{
+			tableRows.push_back( tables[ table ].statistics->estimateRows( scan->filePath ) );
+		}
+		else
+		{
+			tableRows.push_back( TableStatistics().estimateRows( scan->filePath ) );
+		}
+		scan->estimatedRows = tableRows[ table ];
+	}
+	for( int table = 0; table < tableSize; table++ )
+	{
+		scans[ table ]->setLayout( attributes, tableOffsets[ table ] );
+	}
+
+	if( !addConditions( whereType, -1 ) )
+	{
+		errorMessage = "of an invalid condition";
+		return false;
+	}
+	int blockSize = tableSize;
+	for( int table = 1; table < tableSize; table++ )
+	{
+		if( !addConditions( tables[ table ].onCondition, table ) )
+		{
+			errorMessage = "of an invalid condition";
+			return false;
+		}
+		if( tables[ table ].joinType == JOIN_LEFT_OUTER && blockSize == tableSize )
+		{
+			blockSize = table;
+		}
+	}
+
+	//an on condition may only use the tables joined so far
+	int conditionSize = conditions.size();
+	for( int index = 0; index < conditionSize; index++ )
+	{
+		int onTable = conditions[ index ].onTable;
+		if( onTable >= 0 && ( conditions[ index ].tableMask >> onTable ) > 1 )
+		{
+			errorMessage = "of an invalid condition";
+			return false;
+		}
+	}
+
+	orderJoins( blockSize );
+
+	root = tableInput( joinOrder[ 0 ], blockSize );
+	unsigned int joinedMask = 1u << joinOrder[ 0 ];
+	for( int index = 1; index < tableSize; index++ )
+	{
+		int table = joinOrder[ index ];
+		bool outerJoin = tables[ table ].joinType == JOIN_LEFT_OUTER;
+		root = joinInput( root, joinedMask, table, outerJoin, blockSize );
+		joinedMask |= 1u << table;
+	}
+
+	//where conjuncts on tables of outer joins are applied after the joins
+	vector< PredicateNode * > remaining;
+	double rows = root->estimatedRows;
+	for( int index = 0; index < conditionSize; index++ )
+	{
+		if( !conditions[ index ].applied )
+		{
+			conditions[ index ].applied = true;
+			remaining.push_back( conditions[ index ].node );
+			rows *= conditionSelectivity( conditions[ index ] );
+		}
+	}
+	if( !remaining.empty() )
+	{
+		Operator * filter = new FilterOperator( root, combineConditions( remaining ) );
+		filter->detail = conjunctionText( remaining );
+		filter->estimatedRows = rows;
+		operators.push_back( filter );
+		root = track( filter );
+	}
+
+	//project the selected attributes
+	vector< string > selected = tokenizeCondition( queryType );
+	if( !( selected.size() == 1 && selected[ 0 ] == "*" ) )
+	{
+		vector< int > attrIndexes;
+		int selectedSize = selected.size();
+		for( int index = 0; index < selectedSize; index++ )
+		{
+			if( selected[ index ] == "," )
+			{
+				continue;
+			}
+			int attrIndex = resolveAttribute( selected[ index ], attributes, qualifiers );
+			if( attrIndex < 0 )
+			{
+				errorMessage = selected[ index ] + " does not exist";
+				return false;
+			}
+			attrIndexes.push_back( attrIndex );
+		}
+		Operator * project = new ProjectOperator( root, attrIndexes );
+		project->detail = queryType;
+		project->estimatedRows = root->estimatedRows;
+		operators.push_back( project );
+		root = track( project );
+	}
+
+	if( qLimit.rowLimit != NO_LIMIT || qLimit.rowOffset > 0 )
+	{
+		Operator * limit = new LimitOperator( root, qLimit );
+		limit->estimatedRows = max( 0.0, root->estimatedRows - qLimit.rowOffset );
+		if( qLimit.rowLimit != NO_LIMIT )
+		{
+			limit->estimatedRows = min( limit->estimatedRows, (double) qLimit.rowLimit );
+		}
+		operators.push_back( limit );
+		root = track( limit );
+	}
+	return true;
+}
+
+/**
+ * @brief addConditions
+ *
+ * @details compiles a where or on condition for the joined attributes and
+ *          records each of its conjuncts with the tables it uses
+ *
+ * @param [in] string condition
+ *
+ * @param [in] int onTable - table whose on clause holds the condition, -1
+ *             for the where clause
+ *
+ * @return bool false if the condition is invalid
+ *
+ * @note None
+ */
+bool JoinPlanner::addConditions( string condition, int onTable )
+{
+	Predicate * predicate = new Predicate;
+	predicates.push_back( predicate );
+	predicate->statistics = attributeStatistics;
+	if( !predicate->parse( condition ) || !predicate->compile( attributes, qualifiers ) )
+	{
+		return false;
+	}
+
+	vector< PredicateNode * > nodes = predicate->conjuncts();
+	int nodeSize = nodes.size();
+	for( int index = 0; index < nodeSize; index++ )
+	{
+		vector< int > attrIndexes;
+		referencedAttributes( nodes[ index ], attrIndexes );
+
+		PlannedCondition planned;
+		planned.node = nodes[ index ];
+		planned.tableMask = 0;
+		planned.onTable = onTable;
+		planned.applied = false;
+		int attrSize = attrIndexes.size();
+		for( int attrIndex = 0; attrIndex < attrSize; attrIndex++ )
+		{
+			planned.tableMask |= 1u << tableOfAttribute[ attrIndexes[ attrIndex ] ];
+		}
+		conditions.push_back( planned );
+	}
+	return true;
+}
+
+/**
+ * @brief estimateDistinct
+ *
+ * @details estimates the number of distinct values of an attribute
+ *
+ * @par Algorithm uses the HyperLogLog estimate of an analyzed table, without
+ *      one every row is assumed distinct, which treats the attribute as a
+ *      key
+ *
+ * @param [in] int attributeIndex - index in the joined attributes
+ *
+ * @return double at least 1
+ *
+ * @note None
+ */
+double JoinPlanner::estimateDistinct( int attributeIndex )
+{
+	if( attributeStatistics[ attributeIndex ] != NULL )
+	{
+		return max( 1.0, attributeStatistics[ attributeIndex ]->distinctCount );
+	}
+	return max( 1.0, tableRows[ tableOfAttribute[ attributeIndex ] ] );
+}
+
+/**
+ * @brief conditionSelectivity
+ *
+ * @details estimates the fraction of tuples a conjunct is true for
+ *
+ * @par Algorithm an equality between attributes of two tables matches
+ *      1 / max( distinct values ) of the pairs, other conjuncts use the
+ *      selectivity estimated when they were compiled
+ *
+ * @param [in] PlannedCondition &condition
+ *
+ * @return double
+ *
+ * @note None
+ */
+double JoinPlanner::conditionSelectivity( PlannedCondition &condition )
+{
+	PredicateNode * node = condition.node;
+	if( node->nodeType == PREDICATE_COMPARE && node->rightAttributeIndex >= 0 &&
+		node->wCond.operatorValue == "=" && countTables( condition.tableMask ) == 2 )
+	{
+		return 1.0 / max( estimateDistinct( node->wCond.attributeIndex ),
+			estimateDistinct( node->rightAttributeIndex ) );
+	}
+	return node->selectivity;
+}
+
+/**
+ * @brief conditionInBlock
+ *
+ * @details checks that a conjunct may be applied while joining the tables
+ *          before the first outer join
+ *
+ * @param [in] PlannedCondition &condition
+ *
+ * @param [in] int blockSize - number of tables before the first outer join
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool JoinPlanner::conditionInBlock( PlannedCondition &condition, int blockSize )
+{
+	if( condition.onTable >= 0 )
+	{
+		return condition.onTable < blockSize;
+	}
+	return ( condition.tableMask >> blockSize ) == 0;
+}
+
+/**
+ * @brief conditionForTable
+ *
+ * @details checks that a conjunct may be applied when a table is joined
+ *
+ * @param [in] PlannedCondition &condition
+ *
+ * @param [in] int table
+ *
+ * @param [in] int blockSize
+ *
+ * @return bool
+ *
+ * @note a table after the first outer join only takes its on condition
+ */
+bool JoinPlanner::conditionForTable( PlannedCondition &condition, int table, int blockSize )
+{
+	if( table < blockSize )
+	{
+		return conditionInBlock( condition, blockSize );
+	}
+	return condition.onTable == table;
+}
+
+/**
+ * @brief orderJoins
+ *
+ * @details chooses the order the tables are joined in
+ *
+ * @par Algorithm the plans are left deep, each table being hashed and
+ *      probed by the tuples joined so far. For every subset of the tables
+ *      before the first outer join, in increasing order, the cheapest plan
+ *      is the cheapest plan of the subset without one of its tables, joined
+ *      with that table. The cost of a plan is the number of tuples it reads
+ *      into hash tables and produces, summed over its joins. Candidates are
+ *      tried last written table first and only replaced when cheaper, so
+ *      ties keep the written order
+ *
+ * @param [in] int blockSize - number of tables before the first outer join
+ *
+ * @return None
+ *
+ * @note None
+ */
+void JoinPlanner::orderJoins( int blockSize )
+{
+	int tableSize = tables.size();
+	int conditionSize = conditions.size();
+
+	//rows of each table after its own conditions
+	inputRows = tableRows;
+	for( int index = 0; index < conditionSize; index++ )
+	{
+		PlannedCondition &condition = conditions[ index ];
+		for( int table = 0; table < tableSize; table++ )
+		{
+			if( condition.tableMask == ( 1u << table ) && conditionForTable( condition, table, blockSize ) )
+			{
+				inputRows[ table ] *= conditionSelectivity( condition );
+			}
+		}
+	}
+
+	joinOrder.clear();
+	if( blockSize > MAX_ORDERED_TABLES )
+	{
+		for( int table = 0; table < blockSize; table++ )
+		{
+			joinOrder.push_back( table );
+		}
+	}
+	else
+	{
+		unsigned int subsetCount = 1u << blockSize;
+		vector< double > bestCost( subsetCount, 0 );
+		vector< double > bestRows( subsetCount, 0 );
+		vector< int > bestLast( subsetCount, -1 );
+
+		for( int table = 0; table < blockSize; table++ )
+		{
+			bestRows[ 1u << table ] = inputRows[ table ];
+			bestLast[ 1u << table ] = table;
+		}
+
+		for( unsigned int subset = 1; subset < subsetCount; subset++ )
+		{
+			if( countTables( subset ) < 2 )
+			{
+				continue;
+			}
+
+			for( int table = blockSize - 1; table >= 0; table-- )
+			{
+				unsigned int tableBit = 1u << table;
+				if( ( subset & tableBit ) == 0 )
+				{
+					continue;
+				}
+				unsigned int rest = subset ^ tableBit;
+
+				//apply the conjuncts joining the table to the rest
+				double rows = bestRows[ rest ] * inputRows[ table ];
+				for( int index = 0; index < conditionSize; index++ )
+				{
+					PlannedCondition &condition = conditions[ index ];
+					if( conditionInBlock( condition, blockSize ) && ( condition.tableMask & ~subset ) == 0 &&
+						( condition.tableMask & tableBit ) != 0 && ( condition.tableMask & rest ) != 0 )
+					{
+						rows *= conditionSelectivity( condition );
+					}
+				}
+
+				double cost = bestCost[ rest ] + inputRows[ table ] + rows;
+				if( bestLast[ subset ] < 0 || cost < bestCost[ subset ] )
+				{
+					bestCost[ subset ] = cost;
+					bestRows[ subset ] = rows;
+					bestLast[ subset ] = table;
+				}
+			}
+		}
+
+		//walk back from the full subset to recover the order
+		unsigned int subset = subsetCount - 1;
+		while( countTables( subset ) > 1 )
+		{
+			joinOrder.insert( joinOrder.begin(), bestLast[ subset ] );
+			subset ^= 1u << bestLast[ subset ];
+		}
+		joinOrder.insert( joinOrder.begin(), bestLast[ subset ] );
+	}
+
+	for( int table = blockSize; table < tableSize; table++ )
+	{
+		joinOrder.push_back( table );
+	}
+}
+
+/**
+ * @brief combineConditions
+ *
+ * @details builds one kernel that is true when all conjuncts are
+ *
+ * @param [in] vector< PredicateNode * > &nodes
+ *
+ * @return ConditionKernel * NULL for no conjuncts, owned by the planner
+ *
+ * @note None
+ */
+ConditionKernel * JoinPlanner::combineConditions( vector< PredicateNode * > &nodes )
+{
+	int nodeSize = nodes.size();
+	if( nodeSize == 0 )
+	{
+		return NULL;
+	}
+
+	//most selective first
+	stable_sort( nodes.begin(), nodes.end(), lessSelective );
+
+	ConditionKernel * kernel;
+	if( nodeSize == 1 )
+	{
+		kernel = Predicate::buildKernel( nodes[ 0 ], attributes );
+	}
+	else
+	{
+		AndKernel * andKernel = new AndKernel;
+		for( int index = 0; index < nodeSize; index++ )
+		{
+			andKernel->children.push_back( Predicate::buildKernel( nodes[ index ], attributes ) );
+		}
+		kernel = andKernel;
+	}
+	kernels.push_back( kernel );
+	return kernel;
+}
+
+/**
+ * @brief tableInput
+ *
+ * @details returns the scan of a table, filtered by the conjuncts that only
+ *          use that table
+ *
+ * @param [in] int table
+ *
+ * @param [in] int blockSize
+ *
+ * @return Operator *
+ *
+ * @note None
+ */
+Operator * JoinPlanner::tableInput( int table, int blockSize )
+{
+	vector< PredicateNode * > nodes;
+	int conditionSize = conditions.size();
+	for( int index = 0; index < conditionSize; index++ )
+	{
+		PlannedCondition &condition = conditions[ index ];
+		if( !condition.applied && condition.tableMask == ( 1u << table ) &&
+			conditionForTable( condition, table, blockSize ) )
+		{
+			condition.applied = true;
+			nodes.push_back( condition.node );
+		}
+	}
+
+	Operator * scan = track( scans[ table ] );
+	if( nodes.empty() )
+	{
+		return scan;
+	}
+	Operator * filter = new FilterOperator( scan, combineConditions( nodes ) );
+	filter->detail = conjunctionText( nodes );
+	filter->estimatedRows = inputRows[ table ];
+	operators.push_back( filter );
+	return track( filter );
+}
+
+/**
+ * @brief joinInput
+ *
+ * @details joins a table to the tuples joined so far
+ *
+ * @par Algorithm every conjunct that can be applied once the table is
+ *      joined is either an equality between the table and the joined
+ *      tables, which becomes part of the hash key, or part of the join
+ *      condition checked on each match
+ *
+ * @param [in] Operator * left - the tuples joined so far
+ *
+ * @param [in] unsigned int leftMask - tables already joined
+ *
+ * @param [in] int table
+ *
+ * @param [in] bool outerJoin
+ *
+ * @param [in] int blockSize
+ *
+ * @return Operator *
+ *
+ * @note None
+ */
+Operator * JoinPlanner::joinInput( Operator * left, unsigned int leftMask, int table, bool outerJoin, int blockSize )
+{
+	Operator * right = tableInput( table, blockSize );
+	unsigned int tableBit = 1u << table;
+	vector< int > leftKeys;
+	vector< int > rightKeys;
+	vector< int > rightColumns;
+	vector< PredicateNode * > keys;
+	vector< PredicateNode * > residual;
+	double rows = left->estimatedRows * right->estimatedRows;
+
+	int conditionSize = conditions.size();
+	for( int index = 0; index < conditionSize; index++ )
+	{
+		PlannedCondition &condition = conditions[ index ];
+		if( condition.applied || !conditionForTable( condition, table, blockSize ) ||
+			( condition.tableMask & ~( leftMask | tableBit ) ) != 0 )
+		{
+			continue;
+		}
+		condition.applied = true;
+		rows *= conditionSelectivity( condition );
+
+		PredicateNode * node = condition.node;
+		if( node->nodeType == PREDICATE_COMPARE && node->rightAttributeIndex >= 0 &&
+			node->wCond.operatorValue == "=" )
+		{
+			int leftIndex = node->wCond.attributeIndex;
+			int rightIndex = node->rightAttributeIndex;
+			unsigned int leftTable = 1u << tableOfAttribute[ leftIndex ];
+			unsigned int rightTable = 1u << tableOfAttribute[ rightIndex ];
+			if( ( leftTable & leftMask ) != 0 && rightTable == tableBit )
+			{
+				leftKeys.push_back( leftIndex );
+				rightKeys.push_back( rightIndex );
+				keys.push_back( node );
+				continue;
+			}
+			if( ( rightTable & leftMask ) != 0 && leftTable == tableBit )
+			{
+				leftKeys.push_back( rightIndex );
+				rightKeys.push_back( leftIndex );
+				keys.push_back( node );
+				continue;
+			}
+		}
+		residual.push_back( node );
+	}
+
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		if( tableOfAttribute[ index ] == table )
+		{
+			rightColumns.push_back( index );
+		}
+	}
+
+	JoinOperator * join = new JoinOperator( left, right, leftKeys, rightKeys, rightColumns, outerJoin,
+		combineConditions( residual ) );
+	join->expectedRows = inputRows[ table ];
+	join->estimatedRows = outerJoin ? max( rows, left->estimatedRows ) : rows;
+	if( !keys.empty() )
+	{
+		join->detail = "on " + conjunctionText( keys );
+	}
+	if( !residual.empty() )
+	{
+		join->detail += ( keys.empty() ? "filter " : " filter " ) + conjunctionText( residual );
+	}
+	operators.push_back( join );
+	return track( join );
+}
+
+/**
+ * @brief track
+ *
+ * @details places a profiling operator above an operator of the plan when
+ *          the plan is profiled
+ *
+ * @param [in] Operator * op
+ *
+ * @return Operator * the operator its parent should pull from
+ *
+ * @note None
+ */
+Operator * JoinPlanner::track( Operator * op )
+{
+	return profileOperator( op, profile, operators );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
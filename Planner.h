@@ -0,0 +1,87 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Planner.h
+ *
+ * @brief Definition file for the JoinPlanner class
+ *
+ * @details Specifies the planner that turns a select over several tables
+ *          into a tree of operators. The order the tables are joined in is
+ *          chosen by dynamic programming over subsets of the tables, using
+ *          row counts and distinct values from the table statistics (or
+ *          estimates when a table has not been analyzed) to cost each order
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Table.h"
+#include "Predicate.h"
+#include "Operator.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PLANNER_H
+#define PLANNER_H
+
+//tables are tracked in the bits of an unsigned int
+const int MAX_JOIN_TABLES = 31;
+//larger inner joins are joined in the order they are written
+const int MAX_ORDERED_TABLES = 12;
+
+//a conjunct of a where or on condition and the tables it references
+struct PlannedCondition{
+	PredicateNode * node;
+	unsigned int tableMask;
+	//table whose on clause holds the condition, -1 for the where clause
+	int onTable;
+	bool applied;
+};
+
+class JoinPlanner{
+	public:
+		Operator * root;
+		//attributes of every table in from order, the layout of joined tuples
+		vector< Attribute > attributes;
+		vector< string > qualifiers;
+		//tables in the order they are joined
+		vector< int > joinOrder;
+		//measure every operator for EXPLAIN ANALYZE
+		bool profile;
+
+		JoinPlanner();
+		~JoinPlanner();
+		bool plan( string databasePath, vector< JoinTable > &joinTables, string whereType, string queryType,
+			QueryLimit qLimit, string &errorMessage );
+
+	private:
+		vector< JoinTable > tables;
+		vector< TableScan * > scans;
+		vector< int > tableOfAttribute;
+		vector< AttributeStatistics * > attributeStatistics;
+		vector< double > tableRows;
+		//estimated rows of each table after its own conditions
+		vector< double > inputRows;
+		vector< Predicate * > predicates;
+		vector< PlannedCondition > conditions;
+		vector< Operator * > operators;
+		vector< ConditionKernel * > kernels;
+
+		JoinPlanner( const JoinPlanner &other );
+		JoinPlanner &operator=( const JoinPlanner &other );
+		bool addConditions( string condition, int onTable );
+		double estimateDistinct( int attributeIndex );
+		double conditionSelectivity( PlannedCondition &condition );
+		bool conditionInBlock( PlannedCondition &condition, int blockSize );
+		bool conditionForTable( PlannedCondition &condition, int table, int blockSize );
+		void orderJoins( int blockSize );
+		ConditionKernel * combineConditions( vector< PredicateNode * > &nodes );
+		Operator * track( Operator * op );
+		Operator * tableInput( int table, int blockSize );
+		Operator * joinInput( Operator * left, unsigned int leftMask, int table, bool outerJoin, int blockSize );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
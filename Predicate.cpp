@@ -0,0 +1,1291 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Predicate.cpp
+ *
+ * @brief Implementation file for the Predicate class
+ *
+ * @details Implements parsing, compiling and evaluation of where and on
+ *          conditions
+ *
+ * @Note Requires Predicate.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <new>
+#include "Predicate.h"
+#include "Arena.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PREDICATE_CPP
+#define PREDICATE_CPP
+
+//estimated selectivities used when ordering conditions
+const double SELECTIVITY_EQUAL = 0.1;
+const double SELECTIVITY_NOT_EQUAL = 0.9;
+const double SELECTIVITY_RANGE = 0.33;
+
+//declaration of the helper functions
+bool caseInsCompare( string s1, string s2 );
+Arena &statementArena();
+
+/**
+ * @brief tokenizeCondition
+ *
+ * @details splits a condition into words, quoted values, operators,
+ *          parentheses and commas
+ *
+ * @par Algorithm walks the string once; quoted values are kept whole
+ *      including their quotes since values are stored quoted in table files
+ *
+ * @param [in] string input
+ *
+ * @return vector< string > the tokens
+ *
+ * @note None
+ */
+vector< string > tokenizeCondition( string input )
+{
+	vector< string > tokens;
+	int inputSize = input.size();
+	int index = 0;
+
+	while( index < inputSize )
+	{
+		char current = input[ index ];
+		if( isspace( current ) )
+		{
+			index++;
+		}
+		else if( current == '(' || current == ')' || current == ',' )
+		{
+			tokens.push_back( string( 1, current ) );
+			index++;
+		}
+		else if( current == '\'' )
+		{
+			int end = input.find( '\'', index + 1 );
+			if( end < 0 )
+			{
+				end = inputSize - 1;
+			}
+			tokens.push_back( input.substr( index, end - index + 1 ) );
+			index = end + 1;
+		}
+		else if( current == '=' || current == '<' || current == '>' || current == '!' )
+		{
+			string op( 1, current );
+			if( index + 1 < inputSize && ( input[ index + 1 ] == '=' ||
+				( current == '<' && input[ index + 1 ] == '>' ) ) )
+			{
+				op += input[ index + 1 ];
+			}
+			if( op == "<>" )
+			{
+				op = "!=";
+			}
+			tokens.push_back( op );
+			index += ( op.size() == 1 ? 1 : 2 );
+		}
+		else
+		{
+			int start = index;
+			while( index < inputSize && !isspace( input[ index ] ) &&
+				input[ index ] != '(' && input[ index ] != ')' && input[ index ] != ',' &&
+				input[ index ] != '=' && input[ index ] != '<' && input[ index ] != '>' &&
+				input[ index ] != '!' && input[ index ] != '\'' )
+			{
+				index++;
+			}
+			tokens.push_back( input.substr( start, index - start ) );
+		}
+	}
+	return tokens;
+}
+
+/**
+ * @brief isOperatorToken
+ *
+ * @details checks that a token is a comparison operator
+ *
+ * @param [in] string token
+ *
+ * @return bool true for =, !=, <, <=, >, >=
+ *
+ * @note None
+ */
+bool isOperatorToken( string token )
+{
+	return token == "=" || token == "!=" || token == "<" ||
+		token == "<=" || token == ">" || token == ">=";
+}
+
+/**
+ * @brief isLiteralToken
+ *
+ * @details checks that a token is a value rather than an attribute name
+ *
+ * @param [in] string token
+ *
+ * @return bool true for quoted values and numbers
+ *
+ * @note None
+ */
+bool isLiteralToken( string token )
+{
+	if( token.empty() )
+	{
+		return false;
+	}
+	if( token[ 0 ] == '\'' || isdigit( token[ 0 ] ) )
+	{
+		return true;
+	}
+	return ( token[ 0 ] == '-' || token[ 0 ] == '.' || token[ 0 ] == '+' ) &&
+		token.size() > 1 && ( isdigit( token[ 1 ] ) || token[ 1 ] == '.' );
+}
+
+/**
+ * @brief mirrorOperator
+ *
+ * @details returns the operator to use when both sides of a comparison swap
+ *
+ * @param [in] string op
+ *
+ * @return string
+ *
+ * @note None
+ */
+string mirrorOperator( string op )
+{
+	if( op == "<" )
+	{
+		return ">";
+	}
+	else if( op == "<=" )
+	{
+		return ">=";
+	}
+	else if( op == ">" )
+	{
+		return "<";
+	}
+	else if( op == ">=" )
+	{
+		return "<=";
+	}
+	return op;
+}
+
+/**
+ * @brief resolveAttribute
+ *
+ * @details finds the index of an attribute name, which may be qualified by
+ *          a table variable (E.id)
+ *
+ * @param [in] string name
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [in] vector< string > &qualifiers - table variable of each attribute,
+ *             may be empty
+ *
+ * @return int index, -1 if not found
+ *
+ * @note None
+ */
+int resolveAttribute( string name, vector< Attribute > &attributes, vector< string > &qualifiers )
+{
+	string qualifier;
+	size_t found = name.find( '.' );
+	if( found != name.npos )
+	{
+		qualifier = name.substr( 0, found );
+		name.erase( 0, found + 1 );
+	}
+
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		if( attributes[ index ].attributeName == name )
+		{
+			if( qualifier.empty() || qualifiers.empty() || qualifiers[ index ] == qualifier )
+			{
+				return index;
+			}
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief newPredicateNode
+ *
+ * @details allocates a node of the given type with default values in the
+ *          arena of the statement
+ *
+ * @param [in] int nodeType
+ *
+ * @return PredicateNode *
+ *
+ * @note None
+ */
+PredicateNode * newPredicateNode( int nodeType )
+{
+	PredicateNode * node = new ( statementArena().allocate( sizeof( PredicateNode ) ) ) PredicateNode;
+	node->nodeType = nodeType;
+	node->wCond.attributeIndex = -1;
+	node->wCond.floatValue = false;
+	node->wCond.comparisonValueFloat = 0;
+	node->rightAttributeIndex = -1;
+	node->selectivity = 1.0;
+	return node;
+}
+
+/**
+ * @brief deletePredicateNode
+ *
+ * @details destroys a node and all of its children, their memory is given
+ *          back with the statement arena
+ *
+ * @param [in] PredicateNode * node
+ *
+ * @return None
+ *
+ * @note None
+ */
+void deletePredicateNode( PredicateNode * node )
+{
+	if( node == NULL )
+	{
+		return;
+	}
+	int childSize = node->children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		deletePredicateNode( node->children[ index ] );
+	}
+	node->~PredicateNode();
+}
+
+/**
+ * @brief lessSelective
+ *
+ * @details sort helper, orders nodes from most to least selective
+ *
+ * @note None
+ */
+bool lessSelective( PredicateNode * a, PredicateNode * b )
+{
+	return a->selectivity < b->selectivity;
+}
+
+/**
+ * @brief moreSelective
+ *
+ * @details sort helper, orders nodes from least to most selective
+ *
+ * @note None
+ */
+bool moreSelective( PredicateNode * a, PredicateNode * b )
+{
+	return a->selectivity > b->selectivity;
+}
+
+/**
+ * @brief referencedAttributes
+ *
+ * @details collects the indexes of the attributes a compiled node uses
+ *
+ * @param [in] PredicateNode * node
+ *
+ * @param [out] vector< int > &indexes - indexes are appended
+ *
+ * @return None
+ *
+ * @note None
+ */
+void referencedAttributes( PredicateNode * node, vector< int > &indexes )
+{
+	if( node->nodeType == PREDICATE_COMPARE || node->nodeType == PREDICATE_IN )
+	{
+		indexes.push_back( node->wCond.attributeIndex );
+		if( node->rightAttributeIndex >= 0 )
+		{
+			indexes.push_back( node->rightAttributeIndex );
+		}
+		return;
+	}
+
+	int childSize = node->children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		referencedAttributes( node->children[ index ], indexes );
+	}
+}
+
+/**
+ * @brief conditionText
+ *
+ * @details writes a compiled node back as a condition, for EXPLAIN
+ *
+ * @param [in] PredicateNode * node
+ *
+ * @return string
+ *
+ * @note None
+ */
+string conditionText( PredicateNode * node )
+{
+	if( node->nodeType == PREDICATE_COMPARE )
+	{
+		return node->wCond.attributeName + " " + node->wCond.operatorValue + " " + node->wCond.comparisonValue;
+	}
+	else if( node->nodeType == PREDICATE_IN )
+	{
+		string text = node->wCond.attributeName + " IN (";
+		int inSize = node->inValues.size();
+		for( int index = 0; index < inSize; index++ )
+		{
+			text += ( index > 0 ? ", " : "" ) + node->inValues[ index ];
+		}
+		return text + ")";
+	}
+	else if( node->nodeType == PREDICATE_NOT )
+	{
+		return "NOT (" + conditionText( node->children[ 0 ] ) + ")";
+	}
+
+	string text;
+	string separator = ( node->nodeType == PREDICATE_AND ) ? " AND " : " OR ";
+	int childSize = node->children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		PredicateNode * child = node->children[ index ];
+		if( index > 0 )
+		{
+			text += separator;
+		}
+		if( child->nodeType == PREDICATE_AND || child->nodeType == PREDICATE_OR )
+		{
+			text += "(" + conditionText( child ) + ")";
+		}
+		else
+		{
+			text += conditionText( child );
+		}
+	}
+	return text;
+}
+
+/**
+ * @brief getValueType
+ *
+ * @details returns how values of an attribute type are compared
+ *
+ * @param [in] string attributeType
+ *
+ * @return int VALUE_INT, VALUE_FLOAT or VALUE_STRING
+ *
+ * @note None
+ */
+int getValueType( string attributeType )
+{
+	if( caseInsCompare( attributeType, "int" ) )
+	{
+		return VALUE_INT;
+	}
+	else if( caseInsCompare( attributeType, "float" ) )
+	{
+		return VALUE_FLOAT;
+	}
+	return VALUE_STRING;
+}
+
+/**
+ * @brief getLiteralValueType
+ *
+ * @details returns how an attribute is compared to a value, a quoted value
+ *          is compared as a string and a decimal value as a float
+ *
+ * @param [in] int attributeValueType
+ *
+ * @param [in] string value
+ *
+ * @return int VALUE_INT, VALUE_FLOAT or VALUE_STRING
+ *
+ * @note None
+ */
+int getLiteralValueType( int attributeValueType, string value )
+{
+	if( attributeValueType == VALUE_STRING || ( !value.empty() && value[ 0 ] == '\'' ) )
+	{
+		return VALUE_STRING;
+	}
+	if( attributeValueType == VALUE_INT && value.find_first_of( ".eE" ) != value.npos )
+	{
+		return VALUE_FLOAT;
+	}
+	return attributeValueType;
+}
+
+/**
+ * @brief newLiteralKernel
+ *
+ * @details instantiates the kernel comparing an attribute to a value for
+ *          one operator
+ *
+ * @param [in] string op
+ *
+ * @param [in] int index - attribute index
+ *
+ * @param [in] string value
+ *
+ * @return ConditionKernel *, NULL for an unknown operator
+ *
+ * @note None
+ */
+template< typename Value >
+ConditionKernel * newLiteralKernel( string op, int index, string value )
+{
+	if( op == "=" )
+	{
+		return new LiteralKernel< Value, equal_to >( index, value );
+	}
+	else if( op == "!=" )
+	{
+		return new LiteralKernel< Value, not_equal_to >( index, value );
+	}
+	else if( op == "<" )
+	{
+		return new LiteralKernel< Value, less >( index, value );
+	}
+	else if( op == "<=" )
+	{
+		return new LiteralKernel< Value, less_equal >( index, value );
+	}
+	else if( op == ">" )
+	{
+		return new LiteralKernel< Value, greater >( index, value );
+	}
+	else if( op == ">=" )
+	{
+		return new LiteralKernel< Value, greater_equal >( index, value );
+	}
+	return NULL;
+}
+
+/**
+ * @brief newAttributeKernel
+ *
+ * @details instantiates the kernel comparing two attributes for one operator
+ *
+ * @param [in] string op
+ *
+ * @param [in] int leftIndex, int rightIndex - attribute indexes
+ *
+ * @return ConditionKernel *, NULL for an unknown operator
+ *
+ * @note None
+ */
+template< typename Value >
+ConditionKernel * newAttributeKernel( string op, int leftIndex, int rightIndex )
+{
+	if( op == "=" )
+	{
+		return new AttributeKernel< Value, equal_to >( leftIndex, rightIndex );
+	}
+	else if( op == "!=" )
+	{
+		return new AttributeKernel< Value, not_equal_to >( leftIndex, rightIndex );
+	}
+	else if( op == "<" )
+	{
+		return new AttributeKernel< Value, less >( leftIndex, rightIndex );
+	}
+	else if( op == "<=" )
+	{
+		return new AttributeKernel< Value, less_equal >( leftIndex, rightIndex );
+	}
+	else if( op == ">" )
+	{
+		return new AttributeKernel< Value, greater >( leftIndex, rightIndex );
+	}
+	else if( op == ">=" )
+	{
+		return new AttributeKernel< Value, greater_equal >( leftIndex, rightIndex );
+	}
+	return NULL;
+}
+
+/**
+ * @brief DictionaryKernel constructor
+ *
+ * @details evaluates condition on each value of the dictionary
+ *
+ * @par Algorithm every value is placed, as text, at index in a row of
+ *      string attributes and given to condition, which is kept for values
+ *      added to the dictionary later and for values that are not codes
+ *
+ * @param [in] int index - index of the encoded attribute
+ *
+ * @param [in] const Dictionary * dictionary
+ *
+ * @param [in] ConditionKernel * condition - owned by the kernel
+ *
+ * @note None
+ */
+DictionaryKernel::DictionaryKernel( int index, const Dictionary * dictionary, ConditionKernel * condition )
+{
+	vector< int > valueTypes( index + 1, VALUE_STRING );
+	Row valueRow;
+	attributeIndex = index;
+	valueCondition = condition;
+
+	int valueSize = dictionary->values.size();
+	codeMatches.resize( valueSize );
+	for( int code = 0; code < valueSize; code++ )
+	{
+		valueRow.reset( valueTypes );
+		valueRow.setValue( index, dictionary->values[ code ] );
+		codeMatches[ code ] = valueCondition->evaluate( valueRow );
+	}
+}
+
+DictionaryKernel::~DictionaryKernel()
+{
+	delete valueCondition;
+}
+
+/**
+ * @brief AndKernel destructor
+ *
+ * @details frees the child kernels
+ *
+ * @note None
+ */
+AndKernel::~AndKernel()
+{
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		delete children[ index ];
+	}
+}
+
+/**
+ * @brief AndKernel evaluate
+ *
+ * @details true if every child is true, stops at the first false child
+ *
+ * @param [in] Row &tuple
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool AndKernel::evaluate( Row &tuple )
+{
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		if( !children[ index ]->evaluate( tuple ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief OrKernel destructor
+ *
+ * @details frees the child kernels
+ *
+ * @note None
+ */
+OrKernel::~OrKernel()
+{
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		delete children[ index ];
+	}
+}
+
+/**
+ * @brief OrKernel evaluate
+ *
+ * @details true if any child is true, stops at the first true child
+ *
+ * @param [in] Row &tuple
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool OrKernel::evaluate( Row &tuple )
+{
+	int childSize = children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		if( children[ index ]->evaluate( tuple ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief NotKernel destructor
+ *
+ * @details frees the child kernel
+ *
+ * @note None
+ */
+NotKernel::~NotKernel()
+{
+	delete child;
+}
+
+/**
+ * @brief NotKernel evaluate
+ *
+ * @details negates the child
+ *
+ * @param [in] Row &tuple
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool NotKernel::evaluate( Row &tuple )
+{
+	return !child->evaluate( tuple );
+}
+
+/**
+ * @brief Predicate default constructor
+ *
+ * @details an empty predicate is true for every tuple
+ *
+ * @note None
+ */
+Predicate::Predicate()
+{
+	root = NULL;
+	kernel = NULL;
+	position = 0;
+}
+
+/**
+ * @brief Predicate destructor
+ *
+ * @details frees the expression tree and the compiled kernels
+ *
+ * @note None
+ */
+Predicate::~Predicate()
+{
+	deletePredicateNode( root );
+	delete kernel;
+}
+
+/**
+ * @brief parse
+ *
+ * @details builds the expression tree for a condition
+ *
+ * @par Algorithm recursive descent, OR binds loosest then AND then NOT
+ *
+ * @param [in] string condition - text after where/on
+ *
+ * @return bool false if the condition is not valid
+ *
+ * @note an empty condition parses to an empty predicate
+ */
+bool Predicate::parse( string condition )
+{
+	deletePredicateNode( root );
+	delete kernel;
+	root = NULL;
+	kernel = NULL;
+	tokens = tokenizeCondition( condition );
+	position = 0;
+
+	if( tokens.empty() )
+	{
+		return true;
+	}
+
+	root = parseOr();
+	if( root == NULL || position != tokens.size() )
+	{
+		deletePredicateNode( root );
+		root = NULL;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief parseOr
+ *
+ * @details parses AND conditions separated by OR
+ *
+ * @return PredicateNode *, NULL on error
+ *
+ * @note None
+ */
+PredicateNode * Predicate::parseOr()
+{
+	PredicateNode * left = parseAnd();
+	if( left == NULL )
+	{
+		return NULL;
+	}
+
+	while( position < tokens.size() && caseInsCompare( tokens[ position ], "OR" ) )
+	{
+		position++;
+		PredicateNode * right = parseAnd();
+		if( right == NULL )
+		{
+			deletePredicateNode( left );
+			return NULL;
+		}
+		PredicateNode * node = newPredicateNode( PREDICATE_OR );
+		node->children.push_back( left );
+		node->children.push_back( right );
+		left = node;
+	}
+	return left;
+}
+
+/**
+ * @brief parseAnd
+ *
+ * @details parses NOT conditions separated by AND
+ *
+ * @return PredicateNode *, NULL on error
+ *
+ * @note None
+ */
+PredicateNode * Predicate::parseAnd()
+{
+	PredicateNode * left = parseNot();
+	if( left == NULL )
+	{
+		return NULL;
+	}
+
+	while( position < tokens.size() && caseInsCompare( tokens[ position ], "AND" ) )
+	{
+		position++;
+		PredicateNode * right = parseNot();
+		if( right == NULL )
+		{
+			deletePredicateNode( left );
+			return NULL;
+		}
+		PredicateNode * node = newPredicateNode( PREDICATE_AND );
+		node->children.push_back( left );
+		node->children.push_back( right );
+		left = node;
+	}
+	return left;
+}
+
+/**
+ * @brief parseNot
+ *
+ * @details parses an optionally negated condition
+ *
+ * @return PredicateNode *, NULL on error
+ *
+ * @note None
+ */
+PredicateNode * Predicate::parseNot()
+{
+	if( position < tokens.size() && caseInsCompare( tokens[ position ], "NOT" ) )
+	{
+		position++;
+		PredicateNode * child = parseNot();
+		if( child == NULL )
+		{
+			return NULL;
+		}
+		PredicateNode * node = newPredicateNode( PREDICATE_NOT );
+		node->children.push_back( child );
+		return node;
+	}
+	return parsePrimary();
+}
+
+/**
+ * @brief parsePrimary
+ *
+ * @details parses a parenthesized condition, a comparison or an IN list
+ *
+ * @return PredicateNode *, NULL on error
+ *
+ * @note None
+ */
+PredicateNode * Predicate::parsePrimary()
+{
+	if( position >= tokens.size() )
+	{
+		return NULL;
+	}
+
+	//parenthesized condition
+	if( tokens[ position ] == "(" )
+	{
+		position++;
+		PredicateNode * node = parseOr();
+		if( node == NULL || position >= tokens.size() || tokens[ position ] != ")" )
+		{
+			deletePredicateNode( node );
+			return NULL;
+		}
+		position++;
+		return node;
+	}
+
+	string left = tokens[ position ];
+	position++;
+	if( position >= tokens.size() )
+	{
+		return NULL;
+	}
+
+	//IN list, optionally negated
+	bool negated = false;
+	if( caseInsCompare( tokens[ position ], "NOT" ) && position + 1 < tokens.size() &&
+		caseInsCompare( tokens[ position + 1 ], "IN" ) )
+	{
+		negated = true;
+		position++;
+	}
+	if( caseInsCompare( tokens[ position ], "IN" ) )
+	{
+		position++;
+		if( position >= tokens.size() || tokens[ position ] != "(" )
+		{
+			return NULL;
+		}
+		position++;
+
+		PredicateNode * node = newPredicateNode( PREDICATE_IN );
+		node->wCond.attributeName = left;
+		node->wCond.operatorValue = "=";
+		while( position < tokens.size() && tokens[ position ] != ")" )
+		{
+			if( tokens[ position ] != "," )
+			{
+				node->inValues.push_back( tokens[ position ] );
+			}
+			position++;
+		}
+		if( position >= tokens.size() || node->inValues.empty() )
+		{
+			deletePredicateNode( node );
+			return NULL;
+		}
+		position++;
+
+		if( negated )
+		{
+			PredicateNode * notNode = newPredicateNode( PREDICATE_NOT );
+			notNode->children.push_back( node );
+			return notNode;
+		}
+		return node;
+	}
+
+	//comparison
+	if( !isOperatorToken( tokens[ position ] ) || position + 1 >= tokens.size() )
+	{
+		return NULL;
+	}
+	PredicateNode * node = newPredicateNode( PREDICATE_COMPARE );
+	node->wCond.attributeName = left;
+	node->wCond.operatorValue = tokens[ position ];
+	node->wCond.comparisonValue = tokens[ position + 1 ];
+	position += 2;
+	return node;
+}
+
+/**
+ * @brief compile
+ *
+ * @details resolves attribute names against the attributes of the tuples the
+ *          predicate will be evaluated on, orders the conditions, then builds
+ *          the kernels used by evaluate
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [in] vector< string > &qualifiers - table variable of each attribute
+ *
+ * @return bool false if an attribute does not exist
+ *
+ * @note None
+ */
+bool Predicate::compile( vector< Attribute > &attributes, vector< string > &qualifiers )
+{
+	delete kernel;
+	kernel = NULL;
+	if( root == NULL )
+	{
+		return true;
+	}
+	if( !compileNode( root, attributes, qualifiers ) )
+	{
+		return false;
+	}
+	kernel = buildKernel( root, attributes );
+	return true;
+}
+
+/**
+ * @brief compile
+ *
+ * @details compile for the attributes of a single table
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return bool false if an attribute does not exist
+ *
+ * @note None
+ */
+bool Predicate::compile( vector< Attribute > &attributes )
+{
+	vector< string > qualifiers;
+	return compile( attributes, qualifiers );
+}
+
+/**
+ * @brief compileNode
+ *
+ * @details compiles one node and its children
+ *
+ * @par Algorithm leaves get their attribute indexes and float values, and
+ *      their selectivity from the attribute statistics when known. Nested
+ *      AND/OR nodes of the same type are flattened, then AND children are
+ *      sorted most selective first and OR children least selective first so
+ *      evaluation short-circuits as early as possible
+ *
+ * @param [in] PredicateNode * node
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [in] vector< string > &qualifiers
+ *
+ * @return bool false if an attribute does not exist
+ *
+ * @note None
+ */
+bool Predicate::compileNode( PredicateNode * node, vector< Attribute > &attributes, vector< string > &qualifiers )
+{
+	if( node->nodeType == PREDICATE_COMPARE )
+	{
+		int leftIndex = resolveAttribute( node->wCond.attributeName, attributes, qualifiers );
+		int rightIndex = -1;
+		if( !isLiteralToken( node->wCond.comparisonValue ) )
+		{
+			rightIndex = resolveAttribute( node->wCond.comparisonValue, attributes, qualifiers );
+		}
+
+		//literal on the left, swap sides
+		if( leftIndex < 0 && rightIndex >= 0 && isLiteralToken( node->wCond.attributeName ) )
+		{
+			string temp = node->wCond.attributeName;
+			node->wCond.attributeName = node->wCond.comparisonValue;
+			node->wCond.comparisonValue = temp;
+			node->wCond.operatorValue = mirrorOperator( node->wCond.operatorValue );
+			leftIndex = rightIndex;
+			rightIndex = -1;
+		}
+		if( leftIndex < 0 )
+		{
+			return false;
+		}
+
+		node->wCond.attributeIndex = leftIndex;
+		node->wCond.floatValue = attributes[ leftIndex ].attributeType == "float" ||
+			attributes[ leftIndex ].attributeType == "FLOAT";
+		if( rightIndex >= 0 )
+		{
+			node->rightAttributeName = node->wCond.comparisonValue;
+			node->rightAttributeIndex = rightIndex;
+		}
+
+		if( node->wCond.operatorValue == "=" )
+		{
+			node->selectivity = SELECTIVITY_EQUAL;
+		}
+		else if( node->wCond.operatorValue == "!=" )
+		{
+			node->selectivity = SELECTIVITY_NOT_EQUAL;
+		}
+		else
+		{
+			node->selectivity = SELECTIVITY_RANGE;
+		}
+		if( rightIndex < 0 && leftIndex < (int) statistics.size() && statistics[ leftIndex ] != NULL )
+		{
+			node->selectivity = statistics[ leftIndex ]->selectivity( node->wCond.operatorValue,
+				node->wCond.comparisonValue, node->selectivity );
+		}
+		return true;
+	}
+	else if( node->nodeType == PREDICATE_IN )
+	{
+		int index = resolveAttribute( node->wCond.attributeName, attributes, qualifiers );
+		if( index < 0 )
+		{
+			return false;
+		}
+		node->wCond.attributeIndex = index;
+		node->wCond.floatValue = attributes[ index ].attributeType == "float" ||
+			attributes[ index ].attributeType == "FLOAT";
+
+		int inSize = node->inValues.size();
+		node->selectivity = min( 1.0, inSize * SELECTIVITY_EQUAL );
+		if( index < (int) statistics.size() && statistics[ index ] != NULL )
+		{
+			node->selectivity = min( 1.0, inSize * statistics[ index ]->equalSelectivity() );
+		}
+		return true;
+	}
+
+	//compile children, pulling up the children of nested nodes of the same type
+	vector< PredicateNode * > flattened;
+	int childSize = node->children.size();
+	for( int index = 0; index < childSize; index++ )
+	{
+		PredicateNode * child = node->children[ index ];
+		if( !compileNode( child, attributes, qualifiers ) )
+		{
+			return false;
+		}
+		if( node->nodeType != PREDICATE_NOT && child->nodeType == node->nodeType )
+		{
+			flattened.insert( flattened.end(), child->children.begin(), child->children.end() );
+			child->children.clear();
+			deletePredicateNode( child );
+		}
+		else
+		{
+			flattened.push_back( child );
+		}
+	}
+	node->children = flattened;
+	childSize = node->children.size();
+
+	if( node->nodeType == PREDICATE_NOT )
+	{
+		node->selectivity = 1.0 - node->children[ 0 ]->selectivity;
+	}
+	else if( node->nodeType == PREDICATE_AND )
+	{
+		stable_sort( node->children.begin(), node->children.end(), lessSelective );
+		node->selectivity = 1.0;
+		for( int index = 0; index < childSize; index++ )
+		{
+			node->selectivity *= node->children[ index ]->selectivity;
+		}
+	}
+	else
+	{
+		stable_sort( node->children.begin(), node->children.end(), moreSelective );
+		double noneTrue = 1.0;
+		for( int index = 0; index < childSize; index++ )
+		{
+			noneTrue *= 1.0 - node->children[ index ]->selectivity;
+		}
+		node->selectivity = 1.0 - noneTrue;
+	}
+	return true;
+}
+
+/**
+ * @brief encodedKernel
+ *
+ * @details wraps the kernel of a condition on one string attribute in a
+ *          DictionaryKernel if the attribute is dictionary encoded
+ *
+ * @param [in] ConditionKernel * kernel
+ *
+ * @param [in] int index - attribute index
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return ConditionKernel *
+ *
+ * @note None
+ */
+ConditionKernel * encodedKernel( ConditionKernel * kernel, int index, vector< Attribute > &attributes )
+{
+	if( kernel == NULL || attributes[ index ].dictionary == NULL )
+	{
+		return kernel;
+	}
+	return new DictionaryKernel( index, attributes[ index ].dictionary, kernel );
+}
+
+/**
+ * @brief buildKernel
+ *
+ * @details builds the kernel for a compiled node
+ *
+ * @par Algorithm comparisons pick the kernel instance for their operator and
+ *      the type of the attribute (int, float or string), comparisons of an
+ *      encoded attribute to values are decided per code; AND, OR and NOT
+ *      kernels keep the child order chosen by compileNode
+ *
+ * @param [in] PredicateNode * node
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return ConditionKernel *
+ *
+ * @note None
+ */
+ConditionKernel * Predicate::buildKernel( PredicateNode * node, vector< Attribute > &attributes )
+{
+	int childSize = node->children.size();
+
+	if( node->nodeType == PREDICATE_COMPARE )
+	{
+		int leftIndex = node->wCond.attributeIndex;
+		int valueType = getValueType( attributes[ leftIndex ].attributeType );
+		string op = node->wCond.operatorValue;
+
+		if( node->rightAttributeIndex >= 0 )
+		{
+			int rightIndex = node->rightAttributeIndex;
+			int rightType = getValueType( attributes[ rightIndex ].attributeType );
+			if( valueType == VALUE_STRING || rightType == VALUE_STRING )
+			{
+				return newAttributeKernel< StringValue >( op, leftIndex, rightIndex );
+			}
+			else if( valueType == VALUE_FLOAT || rightType == VALUE_FLOAT )
+			{
+				return newAttributeKernel< FloatValue >( op, leftIndex, rightIndex );
+			}
+			return newAttributeKernel< IntValue >( op, leftIndex, rightIndex );
+		}
+
+		string value = node->wCond.comparisonValue;
+		valueType = getLiteralValueType( valueType, value );
+		if( valueType == VALUE_INT )
+		{
+			return newLiteralKernel< IntValue >( op, leftIndex, value );
+		}
+		else if( valueType == VALUE_FLOAT )
+		{
+			return newLiteralKernel< FloatValue >( op, leftIndex, value );
+		}
+		return encodedKernel( newLiteralKernel< StringValue >( op, leftIndex, value ), leftIndex, attributes );
+	}
+	else if( node->nodeType == PREDICATE_IN )
+	{
+		int index = node->wCond.attributeIndex;
+		int valueType = getValueType( attributes[ index ].attributeType );
+		int inSize = node->inValues.size();
+		for( int valueIndex = 0; valueIndex < inSize; valueIndex++ )
+		{
+			int literalType = getLiteralValueType( valueType, node->inValues[ valueIndex ] );
+			if( literalType == VALUE_STRING || valueType == VALUE_STRING )
+			{
+				valueType = VALUE_STRING;
+			}
+			else if( literalType == VALUE_FLOAT )
+			{
+				valueType = VALUE_FLOAT;
+			}
+		}
+
+		if( valueType == VALUE_INT )
+		{
+			return new InKernel< IntValue >( index, node->inValues );
+		}
+		else if( valueType == VALUE_FLOAT )
+		{
+			return new InKernel< FloatValue >( index, node->inValues );
+		}
+		return encodedKernel( new InKernel< StringValue >( index, node->inValues ), index, attributes );
+	}
+	else if( node->nodeType == PREDICATE_NOT )
+	{
+		NotKernel * notKernel = new NotKernel;
+		notKernel->child = buildKernel( node->children[ 0 ], attributes );
+		return notKernel;
+	}
+	else if( node->nodeType == PREDICATE_AND )
+	{
+		AndKernel * andKernel = new AndKernel;
+		for( int index = 0; index < childSize; index++ )
+		{
+			andKernel->children.push_back( buildKernel( node->children[ index ], attributes ) );
+		}
+		return andKernel;
+	}
+
+	OrKernel * orKernel = new OrKernel;
+	for( int index = 0; index < childSize; index++ )
+	{
+		orKernel->children.push_back( buildKernel( node->children[ index ], attributes ) );
+	}
+	return orKernel;
+}
+
+/**
+ * @brief empty
+ *
+ * @details checks if there is no condition
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool Predicate::empty()
+{
+	return root == NULL;
+}
+
+/**
+ * @brief conjuncts
+ *
+ * @details returns the conditions that are ANDed at the top of the tree
+ *
+ * @return vector< PredicateNode * > the root's children for an AND root,
+ *         otherwise the root itself
+ *
+ * @note the nodes are still owned by the predicate
+ */
+vector< PredicateNode * > Predicate::conjuncts()
+{
+	vector< PredicateNode * > nodes;
+	if( root == NULL )
+	{
+		return nodes;
+	}
+	if( root->nodeType == PREDICATE_AND )
+	{
+		return root->children;
+	}
+	nodes.push_back( root );
+	return nodes;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
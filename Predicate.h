@@ -0,0 +1,228 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Predicate.h
+ *
+ * @brief Definition file for the Predicate class
+ *
+ * @details Specifies the expression tree used for where and on conditions.
+ *          A condition may combine comparisons and IN lists with AND, OR,
+ *          NOT and parentheses. A compiled condition is a tree of kernels,
+ *          one template instance per operator and attribute type, so no
+ *          operator or type is looked up while tuples are evaluated
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <functional>
+#include "Table.h"
+#include "Row.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PREDICATE_H
+#define PREDICATE_H
+
+const int PREDICATE_COMPARE = 0;
+const int PREDICATE_IN = 1;
+const int PREDICATE_AND = 2;
+const int PREDICATE_OR = 3;
+const int PREDICATE_NOT = 4;
+
+struct PredicateNode{
+	int nodeType;
+	//comparison and IN nodes, wCond holds the left attribute and operator
+	WhereCondition wCond;
+	//set when the right side of a comparison is an attribute
+	string rightAttributeName;
+	int rightAttributeIndex;
+	//values of an IN list
+	vector< string > inValues;
+	//AND, OR and NOT nodes
+	vector< PredicateNode * > children;
+	//estimated fraction of tuples the node is true for
+	double selectivity;
+};
+
+class ConditionKernel{
+	public:
+		virtual ~ConditionKernel()
+		{
+
+		}
+		virtual bool evaluate( Row &tuple ) = 0;
+};
+
+//attribute compared to a value, false for a null attribute
+template< typename Value, template< typename > class Compare >
+class LiteralKernel : public ConditionKernel{
+	public:
+		int attributeIndex;
+		string literal;
+		typename Value::Type comparisonValue;
+		string scratch;
+
+		LiteralKernel( int index, const string &value )
+		{
+			attributeIndex = index;
+			literal = value;
+			comparisonValue = Value::convert( literal );
+		}
+		bool evaluate( Row &tuple )
+		{
+			return !tuple.isNull( attributeIndex ) &&
+				Compare< typename Value::Type >()( Value::read( tuple, attributeIndex, scratch ), comparisonValue );
+		}
+};
+
+//attribute compared to another attribute of the same tuple, false if either
+//is null
+template< typename Value, template< typename > class Compare >
+class AttributeKernel : public ConditionKernel{
+	public:
+		int leftIndex;
+		int rightIndex;
+		string leftScratch;
+		string rightScratch;
+
+		AttributeKernel( int left, int right )
+		{
+			leftIndex = left;
+			rightIndex = right;
+		}
+		bool evaluate( Row &tuple )
+		{
+			return !tuple.isNull( leftIndex ) && !tuple.isNull( rightIndex ) &&
+				Compare< typename Value::Type >()( Value::read( tuple, leftIndex, leftScratch ),
+				Value::read( tuple, rightIndex, rightScratch ) );
+		}
+};
+
+//attribute in a list of values, false for a null attribute
+template< typename Value >
+class InKernel : public ConditionKernel{
+	public:
+		int attributeIndex;
+		vector< string > literals;
+		vector< typename Value::Type > inValues;
+		string scratch;
+
+		InKernel( int index, const vector< string > &values )
+		{
+			attributeIndex = index;
+			literals = values;
+			int valueSize = literals.size();
+			for( int valueIndex = 0; valueIndex < valueSize; valueIndex++ )
+			{
+				inValues.push_back( Value::convert( literals[ valueIndex ] ) );
+			}
+		}
+		bool evaluate( Row &tuple )
+		{
+			if( tuple.isNull( attributeIndex ) )
+			{
+				return false;
+			}
+			typename Value::Type value = Value::read( tuple, attributeIndex, scratch );
+			int valueSize = inValues.size();
+			for( int valueIndex = 0; valueIndex < valueSize; valueIndex++ )
+			{
+				if( value == inValues[ valueIndex ] )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+};
+
+//a condition on one dictionary encoded attribute, decided once for each
+//value of the dictionary so that a tuple is checked by its code. Values that
+//are not codes are checked by the condition itself
+class DictionaryKernel : public ConditionKernel{
+	public:
+		int attributeIndex;
+		ConditionKernel * valueCondition;
+		//whether the condition holds for each code
+		vector< char > codeMatches;
+
+		DictionaryKernel( int index, const Dictionary * dictionary, ConditionKernel * condition );
+		~DictionaryKernel();
+		inline bool evaluate( Row &tuple )
+		{
+			if( tuple.formats[ attributeIndex ] == FORMAT_CODE )
+			{
+				unsigned long code = tuple.slots[ attributeIndex ].intValue;
+				if( code < codeMatches.size() )
+				{
+					return codeMatches[ code ];
+				}
+			}
+			return valueCondition->evaluate( tuple );
+		}
+};
+
+class AndKernel : public ConditionKernel{
+	public:
+		vector< ConditionKernel * > children;
+
+		~AndKernel();
+		bool evaluate( Row &tuple );
+};
+
+class OrKernel : public ConditionKernel{
+	public:
+		vector< ConditionKernel * > children;
+
+		~OrKernel();
+		bool evaluate( Row &tuple );
+};
+
+class NotKernel : public ConditionKernel{
+	public:
+		ConditionKernel * child;
+
+		~NotKernel();
+		bool evaluate( Row &tuple );
+};
+
+class Predicate{
+	public:
+		PredicateNode * root;
+		ConditionKernel * kernel;
+		//statistics of each attribute compile is given, used to estimate
+		//selectivities when set
+		vector< AttributeStatistics * > statistics;
+
+		Predicate();
+		~Predicate();
+		bool parse( string condition );
+		bool compile( vector< Attribute > &attributes, vector< string > &qualifiers );
+		bool compile( vector< Attribute > &attributes );
+		inline bool evaluate( Row &tuple )
+		{
+			return kernel == NULL || kernel->evaluate( tuple );
+		}
+		bool empty();
+		vector< PredicateNode * > conjuncts();
+		static ConditionKernel * buildKernel( PredicateNode * node, vector< Attribute > &attributes );
+
+	private:
+		vector< string > tokens;
+		unsigned int position;
+
+		Predicate( const Predicate &other );
+		Predicate &operator=( const Predicate &other );
+		PredicateNode * parseOr();
+		PredicateNode * parseAnd();
+		PredicateNode * parseNot();
+		PredicateNode * parsePrimary();
+		bool compileNode( PredicateNode * node, vector< Attribute > &attributes, vector< string > &qualifiers );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,331 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ResultCache.cpp
+ *
+ * @brief Implementation file for the ResultCache class
+ *
+ * @details Implements the cache of query results and the table versions it
+ *          is checked against
+ *
+ * @Note Requires ResultCache.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include "ResultCache.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef RESULTCACHE_CPP
+#define RESULTCACHE_CPP
+
+//results of the queries of every session
+ResultCache resultCache( RESULT_CACHE_BYTES );
+
+ResultCache::ResultCache( size_t capacityBytes )
+{
+	capacity = capacityBytes;
+	used = 0;
+}
+
+/**
+ * @brief ResultCache resize
+ *
+ * @details sets the bytes of results cached, 0 for none
+ *
+ * @param [in] size_t capacityBytes
+ *
+ * @return None
+ *
+ * @note called before any session starts
+ */
+void ResultCache::resize( size_t capacityBytes )
+{
+	lock_guard< mutex > state( stateMutex );
+	capacity = capacityBytes;
+	evict();
+}
+
+bool ResultCache::isEnabled()
+{
+	return capacity > 0;
+}
+
+size_t ResultCache::getEntryLimit()
+{
+	return capacity / RESULT_CACHE_ENTRY_SHARE;
+}
+
+/**
+ * @brief ResultCache getKey
+ *
+ * @details returns the key a query's result is cached by: the database and
+ *          output format it ran with, then its text
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] int outputFormat
+ *
+ * @param [in] string query
+ *
+ * @return string
+ *
+ * @note the text is kept as it is, statements are parsed by their spacing
+ *       so two spelled differently may not mean the same
+ */
+string ResultCache::getKey( string currentDatabase, int outputFormat, string query )
+{
+	return currentDatabase + "\n" + (char) ( '0' + outputFormat ) + "\n" + query;
+}
+
+/**
+ * @brief ResultCache getVersions
+ *
+ * @details returns the versions of tables
+ *
+ * @par Algorithm read before the query takes its snapshots: a table
+ *      written after this has a newer version, so a result that might hold
+ *      its records is never found by a query reading the newer version
+ *
+ * @param [in] const vector< string > &filePaths
+ *
+ * @param [out] vector< unsigned long long > &versions
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultCache::getVersions( const vector< string > &filePaths, vector< unsigned long long > &versions )
+{
+	lock_guard< mutex > state( stateMutex );
+	versions.clear();
+	int pathSize = filePaths.size();
+	for( int index = 0; index < pathSize; index++ )
+	{
+		map< string, unsigned long long >::iterator version = tableVersions.find( filePaths[ index ] );
+		versions.push_back( version == tableVersions.end() ? 0 : version->second );
+	}
+}
+
+/**
+ * @brief ResultCache changed
+ *
+ * @details counts up the version of a table, once its change is visible
+ *
+ * @param [in] const string &filePath - full path to the table file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultCache::changed( const string &filePath )
+{
+	if( !isEnabled() )
+	{
+		return;
+	}
+	lock_guard< mutex > state( stateMutex );
+	tableVersions[ filePath ]++;
+}
+
+/**
+ * @brief ResultCache find
+ *
+ * @details returns the cached result of a query if its tables are at the
+ *          versions it was cached with, dropping it if they are not
+ *
+ * @param [in] const string &key - see getKey
+ *
+ * @param [in] const vector< string > &filePaths
+ *
+ * @param [in] const vector< unsigned long long > &versions - see
+ *             getVersions
+ *
+ * @param [out] string &result
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool ResultCache::find( const string &key, const vector< string > &filePaths,
+	const vector< unsigned long long > &versions, string &result )
+{
+	lock_guard< mutex > state( stateMutex );
+	map< string, list< Entry >::iterator >::iterator found = index.find( key );
+	if( found == index.end() )
+	{
+		return false;
+	}
+	list< Entry >::iterator entry = found->second;
+	if( entry->filePaths != filePaths || entry->versions != versions )
+	{
+		erase( entry );
+		return false;
+	}
+	entries.splice( entries.begin(), entries, entry );
+	result = entry->result;
+	return true;
+}
+
+/**
+ * @brief ResultCache insert
+ *
+ * @details caches the result of a query, replacing any it had
+ *
+ * @param [in] const string &key
+ *
+ * @param [in] const vector< string > &filePaths
+ *
+ * @param [in] const vector< unsigned long long > &versions - the versions
+ *             read before the query ran
+ *
+ * @param [in] const string &result
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultCache::insert( const string &key, const vector< string > &filePaths,
+	const vector< unsigned long long > &versions, const string &result )
+{
+	lock_guard< mutex > state( stateMutex );
+	map< string, list< Entry >::iterator >::iterator found = index.find( key );
+	if( found != index.end() )
+	{
+		erase( found->second );
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.filePaths = filePaths;
+	entry.versions = versions;
+	entry.result = result;
+	entry.bytes = RESULT_CACHE_ENTRY_BYTES + key.size() * 2 + result.size();
+	int pathSize = filePaths.size();
+	for( int path = 0; path < pathSize; path++ )
+	{
+		entry.bytes += filePaths[ path ].size();
+	}
+	if( entry.bytes > capacity )
+	{
+		return;
+	}
+
+	entries.push_front( entry );
+	index[ key ] = entries.begin();
+	used += entry.bytes;
+	evict();
+}
+
+void ResultCache::erase( list< Entry >::iterator entry )
+{
+	used -= entry->bytes;
+	index.erase( entry->key );
+	entries.erase( entry );
+}
+
+/**
+ * @brief ResultCache evict
+ *
+ * @details drops the results used least recently until the rest fit
+ *
+ * @return None
+ *
+ * @note called holding stateMutex
+ */
+void ResultCache::evict()
+{
+	while( used > capacity && !entries.empty() )
+	{
+		erase( --entries.end() );
+	}
+}
+
+/**
+ * @brief CachedQuery constructor
+ *
+ * @details reads the versions of the tables of a query
+ *
+ * @param [in] string currentDatabase, int outputFormat, string query - see
+ *             ResultCache::getKey
+ *
+ * @param [in] const vector< string > &filePaths - the query's tables
+ *
+ * @param [in] bool cacheable - false for a query whose result depends on
+ *             more than its tables, such as one seeing its transaction's
+ *             changes
+ *
+ * @note constructed before the query's snapshots are taken
+ */
+CachedQuery::CachedQuery( string currentDatabase, int outputFormat, string query, const vector< string > &filePaths,
+	bool cacheable )
+{
+	active = cacheable && resultCache.isEnabled();
+	capturing = false;
+	if( active )
+	{
+		cacheKey = ResultCache::getKey( currentDatabase, outputFormat, query );
+		tablePaths = filePaths;
+		resultCache.getVersions( tablePaths, versions );
+	}
+}
+
+/**
+ * @brief CachedQuery destructor
+ *
+ * @details caches the result captured if the query wrote one in full
+ *
+ * @note None
+ */
+CachedQuery::~CachedQuery()
+{
+	if( !capturing )
+	{
+		return;
+	}
+	ResultWriter::setCapture( NULL );
+	if( capture.finished && !capture.overflowed )
+	{
+		resultCache.insert( cacheKey, tablePaths, versions, capture.text );
+	}
+}
+
+/**
+ * @brief CachedQuery output
+ *
+ * @details outputs the cached result of the query, or starts capturing
+ *          the result the query is about to output
+ *
+ * @return bool true if the result was output, the query is then not run
+ *
+ * @note None
+ */
+bool CachedQuery::output()
+{
+	if( !active )
+	{
+		return false;
+	}
+	string result;
+	if( resultCache.find( cacheKey, tablePaths, versions, result ) )
+	{
+		Metrics::count( METRIC_RESULT_CACHE_HITS );
+		cout.write( result.data(), result.size() );
+		cout.flush();
+		return true;
+	}
+	Metrics::count( METRIC_RESULT_CACHE_MISSES );
+	capture.limit = resultCache.getEntryLimit();
+	capturing = true;
+	ResultWriter::setCapture( &capture );
+	return false;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,100 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ResultCache.h
+ *
+ * @brief Definition file for the ResultCache class
+ *
+ * @details Specifies the cache of query results shared by every session. A
+ *          result is kept with the version of each table the query read,
+ *          and is only output again while none of those tables changed.
+ *          A table's version is counted up each time records are written
+ *          to it or it is replaced or dropped, so a changed table leaves
+ *          the results read from it unused until they are evicted. The
+ *          results used least recently are evicted to stay in the memory
+ *          budget
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include "ResultWriter.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+//results are not cached unless --result-cache is given
+const size_t RESULT_CACHE_BYTES = 0;
+//bytes counted for an entry besides its key and result
+const size_t RESULT_CACHE_ENTRY_BYTES = 256;
+//a single result may take this share of the cache at most
+const size_t RESULT_CACHE_ENTRY_SHARE = 4;
+
+class ResultCache{
+	public:
+		ResultCache( size_t capacityBytes );
+		void resize( size_t capacityBytes );
+		bool isEnabled();
+		static string getKey( string currentDatabase, int outputFormat, string query );
+		void getVersions( const vector< string > &filePaths, vector< unsigned long long > &versions );
+		void changed( const string &filePath );
+		bool find( const string &key, const vector< string > &filePaths,
+			const vector< unsigned long long > &versions, string &result );
+		void insert( const string &key, const vector< string > &filePaths,
+			const vector< unsigned long long > &versions, const string &result );
+		size_t getEntryLimit();
+
+	private:
+		struct Entry{
+			string key;
+			vector< string > filePaths;
+			vector< unsigned long long > versions;
+			string result;
+			size_t bytes;
+		};
+
+		mutex stateMutex;
+		//set before any session starts
+		size_t capacity;
+		size_t used;
+		//most recently used first
+		list< Entry > entries;
+		map< string, list< Entry >::iterator > index;
+		map< string, unsigned long long > tableVersions;
+
+		ResultCache( const ResultCache &other );
+		ResultCache &operator=( const ResultCache &other );
+		void erase( list< Entry >::iterator entry );
+		void evict();
+};
+
+//a query whose result is output from the cache, or captured as it is
+//output so that it can be cached
+class CachedQuery{
+	public:
+		CachedQuery( string currentDatabase, int outputFormat, string query, const vector< string > &filePaths,
+			bool cacheable );
+		~CachedQuery();
+		bool output();
+
+	private:
+		bool active;
+		bool capturing;
+		string cacheKey;
+		vector< string > tablePaths;
+		vector< unsigned long long > versions;
+		ResultCapture capture;
+
+		CachedQuery( const CachedQuery &other );
+		CachedQuery &operator=( const CachedQuery &other );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
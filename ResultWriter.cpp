@@ -0,0 +1,330 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ResultWriter.cpp
+ *
+ * @brief Implementation file for the ResultWriter class
+ *
+ * @details Implements the formatting of query results. Rows are appended to
+ *          a buffer that is written once it holds RESULT_BUFFER_SIZE bytes,
+ *          so a large result takes a few writes instead of a flush per row
+ *
+ * @Note Requires ResultWriter.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "ResultWriter.h"
+#include "Metrics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef RESULTWRITER_CPP
+#define RESULTWRITER_CPP
+
+//declaration of the helper functions
+bool caseInsCompare( string s1, string s2 );
+
+thread_local ResultCapture * ResultWriter::capture = NULL;
+
+/**
+ * @brief getOutputFormat
+ *
+ * @details finds the output format with the given name
+ *
+ * @param [in] string formatName - PIPE, CSV, TSV or BINARY in any case
+ *
+ * @return int the format, -1 if there is none with that name
+ *
+ * @note None
+ */
+int getOutputFormat( string formatName )
+{
+	if( caseInsCompare( formatName, "PIPE" ) )
+	{
+		return OUTPUT_PIPE;
+	}
+	if( caseInsCompare( formatName, "CSV" ) )
+	{
+		return OUTPUT_CSV;
+	}
+	if( caseInsCompare( formatName, "TSV" ) )
+	{
+		return OUTPUT_TSV;
+	}
+	if( caseInsCompare( formatName, "BINARY" ) )
+	{
+		return OUTPUT_BINARY;
+	}
+	return -1;
+}
+
+/**
+ * @brief ResultWriter constructor
+ *
+ * @param [in] int format - one of the OUTPUT_ constants
+ *
+ * @note None
+ */
+ResultWriter::ResultWriter( int format )
+{
+	outputFormat = format;
+	finished = false;
+	buffer.reserve( RESULT_BUFFER_SIZE + RESULT_BUFFER_SIZE / 4 );
+}
+
+/**
+ * @brief ResultWriter destructor
+ *
+ * @details outputs what is left in the buffer if finish was not called
+ *
+ * @note None
+ */
+ResultWriter::~ResultWriter()
+{
+	if( !finished )
+	{
+		finish();
+	}
+}
+
+/**
+ * @brief ResultWriter writeHeader
+ *
+ * @details outputs the attributes of the result
+ *
+ * @par Algorithm the pipe format lists each name and type, CSV and TSV list
+ *      the names. The binary format starts with the number of attributes
+ *      followed by the name and type of each, every string prefixed by its
+ *      length
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::writeHeader( vector< Attribute > &attributes )
+{
+	int attrSize = attributes.size();
+
+	if( outputFormat == OUTPUT_BINARY )
+	{
+		appendLength( attrSize );
+		for( int index = 0; index < attrSize; index++ )
+		{
+			appendValue( attributes[ index ].attributeName.c_str(), 0, attributes[ index ].attributeName.size() );
+			appendValue( attributes[ index ].attributeType.c_str(), 0, attributes[ index ].attributeType.size() );
+		}
+		return;
+	}
+
+	if( outputFormat == OUTPUT_PIPE )
+	{
+		buffer += "-- ";
+	}
+	for( int index = 0; index < attrSize; index++ )
+	{
+		if( index > 0 )
+		{
+			buffer += ( outputFormat == OUTPUT_PIPE ) ? '|' : ( outputFormat == OUTPUT_CSV ) ? ',' : '\t';
+		}
+		appendValue( attributes[ index ].attributeName.c_str(), 0, attributes[ index ].attributeName.size() );
+		if( outputFormat == OUTPUT_PIPE )
+		{
+			buffer += ' ';
+			buffer += attributes[ index ].attributeType;
+		}
+	}
+	buffer += '\n';
+}
+
+/**
+ * @brief ResultWriter writeRow
+ *
+ * @details formats a tuple into the buffer, writing the buffer once it is
+ *          full
+ *
+ * @par Algorithm string values are output without the quotes they are
+ *      stored in. In the binary format a row starts with a byte of 1 and
+ *      holds each value prefixed by its length
+ *
+ * @param [in] Row &tuple
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::writeRow( Row &tuple )
+{
+	Metrics::count( METRIC_ROWS_RETURNED );
+	int tupleSize = tuple.size();
+	char separator = ( outputFormat == OUTPUT_CSV ) ? ',' : ( outputFormat == OUTPUT_TSV ) ? '\t' : '|';
+
+	if( outputFormat == OUTPUT_BINARY )
+	{
+		buffer += '\1';
+	}
+	else if( outputFormat == OUTPUT_PIPE )
+	{
+		buffer += "-- ";
+	}
+
+	for( int index = 0; index < tupleSize; index++ )
+	{
+		TextView value = tuple.getText( index, scratch );
+		size_t start = 0;
+		size_t length = value.length;
+
+		if( index > 0 && outputFormat != OUTPUT_BINARY )
+		{
+			buffer += separator;
+		}
+		if( length > 1 && value.data[ 0 ] == '\'' && value.data[ length - 1 ] == '\'' )
+		{
+			start = 1;
+			length -= 2;
+		}
+		appendValue( value.data, start, length );
+	}
+
+	if( outputFormat != OUTPUT_BINARY )
+	{
+		buffer += '\n';
+	}
+	if( buffer.size() >= (size_t) RESULT_BUFFER_SIZE )
+	{
+		flushBuffer();
+	}
+}
+
+/**
+ * @brief ResultWriter finish
+ *
+ * @details outputs the rest of the result, ending a binary result with a
+ *          byte of 0
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::finish()
+{
+	if( outputFormat == OUTPUT_BINARY )
+	{
+		buffer += '\0';
+	}
+	flushBuffer();
+	cout.flush();
+	finished = true;
+	if( capture != NULL )
+	{
+		capture->finished = true;
+	}
+}
+
+void ResultWriter::setCapture( ResultCapture * resultCapture )
+{
+	capture = resultCapture;
+}
+
+/**
+ * @brief ResultWriter appendValue
+ *
+ * @details appends part of a value in the output format
+ *
+ * @par Algorithm CSV values holding a comma, quote or line break are
+ *      quoted, doubling the quotes inside them
+ *
+ * @param [in] const char * value
+ *
+ * @param [in] size_t start, size_t length - the part of value to append
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::appendValue( const char * value, size_t start, size_t length )
+{
+	if( outputFormat == OUTPUT_BINARY )
+	{
+		appendLength( length );
+	}
+	else if( outputFormat == OUTPUT_CSV )
+	{
+		bool special = false;
+		for( size_t index = start; index < start + length && !special; index++ )
+		{
+			special = ( value[ index ] == ',' || value[ index ] == '"' || value[ index ] == '\r' || value[ index ] == '\n' );
+		}
+		if( special )
+		{
+			buffer += '"';
+			for( size_t index = start; index < start + length; index++ )
+			{
+				if( value[ index ] == '"' )
+				{
+					buffer += '"';
+				}
+				buffer += value[ index ];
+			}
+			buffer += '"';
+			return;
+		}
+	}
+	buffer.append( value + start, length );
+}
+
+/**
+ * @brief ResultWriter appendLength
+ *
+ * @details appends a length as 4 bytes, least significant first
+ *
+ * @param [in] size_t length
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::appendLength( size_t length )
+{
+	for( int byte = 0; byte < 4; byte++ )
+	{
+		buffer += (char) ( ( length >> ( byte * 8 ) ) & 0xff );
+	}
+}
+
+/**
+ * @brief ResultWriter flushBuffer
+ *
+ * @details writes the buffer in one call and empties it, keeping it in the
+ *          capture of the thread if there is one
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ResultWriter::flushBuffer()
+{
+	if( !buffer.empty() )
+	{
+		cout.write( buffer.data(), buffer.size() );
+		if( capture != NULL && !capture->overflowed )
+		{
+			if( capture->text.size() + buffer.size() > capture->limit )
+			{
+				capture->overflowed = true;
+				string().swap( capture->text );
+			}
+			else
+			{
+				capture->text += buffer;
+			}
+		}
+		buffer.clear();
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,81 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ResultWriter.h
+ *
+ * @brief Definition file for the ResultWriter class
+ *
+ * @details Specifies the writer that formats the tuples of a query result
+ *          into a large buffer and outputs it in a few writes, in one of
+ *          the output formats a session may select
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Table.h"
+#include "Row.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+//"-- " followed by the values separated by |, the default
+const int OUTPUT_PIPE = 0;
+const int OUTPUT_CSV = 1;
+const int OUTPUT_TSV = 2;
+//length prefixed values, see ResultWriter.cpp
+const int OUTPUT_BINARY = 3;
+
+//bytes formatted before they are written
+const int RESULT_BUFFER_SIZE = 1 << 16;
+
+//output of the results written by a thread, kept for the result cache as
+//it is written
+struct ResultCapture{
+	string text;
+	//the capture is given up once text would hold more
+	size_t limit;
+	bool overflowed;
+	//set once a result has been written in full
+	bool finished;
+
+	ResultCapture()
+	{
+		limit = 0;
+		overflowed = false;
+		finished = false;
+	}
+};
+
+class ResultWriter{
+	public:
+		ResultWriter( int format );
+		~ResultWriter();
+		void writeHeader( vector< Attribute > &attributes );
+		void writeRow( Row &tuple );
+		void finish();
+		//results written by the calling thread are also kept in capture,
+		//NULL to stop
+		static void setCapture( ResultCapture * capture );
+
+	private:
+		int outputFormat;
+		string buffer;
+		//text of a number being output
+		string scratch;
+		bool finished;
+		static thread_local ResultCapture * capture;
+
+		ResultWriter( const ResultWriter &other );
+		ResultWriter &operator=( const ResultWriter &other );
+		void appendValue( const char * value, size_t start, size_t length );
+		void appendLength( size_t length );
+		void flushBuffer();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,477 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Row.cpp
+ *
+ * @brief Implementation file for the Row class
+ *
+ * @details Implements how stored values are parsed into the slots of a row
+ *          and how the stored text is rebuilt from them, including the codes
+ *          of dictionary encoded attributes
+ *
+ * @Note Requires Row.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include "Row.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef ROW_CPP
+#define ROW_CPP
+
+const double SLOT_POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+	1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+/**
+ * @brief isNullText
+ *
+ * @details checks if a stored value is null: empty or null in any case
+ *
+ * @param [in] const char * data, size_t length
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isNullText( const char * data, size_t length )
+{
+	return length == 0 || ( length == 4 && tolower( data[ 0 ] ) == 'n' && tolower( data[ 1 ] ) == 'u' &&
+		tolower( data[ 2 ] ) == 'l' && tolower( data[ 3 ] ) == 'l' );
+}
+
+/**
+ * @brief parseSlotNumber
+ *
+ * @details parses a number that can be written back exactly from its value
+ *
+ * @par Algorithm accepts an optional minus sign, an integer part without
+ *      leading zeros and, if fraction is allowed, a decimal point followed
+ *      by at least one digit, with at most MAX_SLOT_DIGITS digits in all.
+ *      Anything else (a plus sign, exponents, "-0" for an int) is left as
+ *      text so that it is output as it was stored
+ *
+ * @param [in] const char * data, size_t length
+ *
+ * @param [in] bool fraction - true for a float attribute
+ *
+ * @param [out] long long &mantissa - the digits as an integer
+ *
+ * @param [out] int &fractionDigits - digits after the decimal point
+ *
+ * @param [out] bool &negative
+ *
+ * @return bool false if the value has to be kept as text
+ *
+ * @note None
+ */
+bool parseSlotNumber( const char * data, size_t length, bool fraction, long long &mantissa, int &fractionDigits,
+	bool &negative )
+{
+	size_t position = 0;
+	int digitCount = 0;
+
+	negative = ( length > 0 && data[ 0 ] == '-' );
+	if( negative )
+	{
+		position++;
+	}
+	mantissa = 0;
+	fractionDigits = 0;
+
+	size_t integerStart = position;
+	while( position < length && data[ position ] >= '0' && data[ position ] <= '9' )
+	{
+		mantissa = mantissa * 10 + ( data[ position ] - '0' );
+		digitCount++;
+		position++;
+	}
+	int integerDigits = position - integerStart;
+	if( integerDigits == 0 || ( integerDigits > 1 && data[ integerStart ] == '0' ) )
+	{
+		return false;
+	}
+
+	if( fraction && position < length && data[ position ] == '.' )
+	{
+		position++;
+		while( position < length && data[ position ] >= '0' && data[ position ] <= '9' )
+		{
+			mantissa = mantissa * 10 + ( data[ position ] - '0' );
+			digitCount++;
+			fractionDigits++;
+			position++;
+		}
+		if( fractionDigits == 0 )
+		{
+			return false;
+		}
+	}
+
+	if( position != length || digitCount > MAX_SLOT_DIGITS )
+	{
+		return false;
+	}
+	return fraction || !( negative && mantissa == 0 );
+}
+
+/**
+ * @brief Row constructor
+ *
+ * @details a row has no attributes until it is reset
+ *
+ * @note None
+ */
+Row::Row()
+{
+	types = NULL;
+	dictionaries = NULL;
+	text.assign( 1, '\0' );
+}
+
+/**
+ * @brief Row reset
+ *
+ * @details empties the row for the given attribute types
+ *
+ * @par Algorithm every value starts out null with empty text, which is how
+ *      an attribute no operator fills (the other side of an unmatched left
+ *      outer join) is output. The buffers keep their capacity, so reusing a
+ *      row does not allocate
+ *
+ * @param [in] const vector< int > &columnTypes - VALUE_ type of each
+ *             attribute, must outlive the row's use
+ *
+ * @param [in] const vector< const Dictionary * > * columnDictionaries -
+ *             dictionary of each attribute, NULL if no attribute is encoded
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::reset( const vector< int > &columnTypes, const vector< const Dictionary * > * columnDictionaries )
+{
+	int columnSize = columnTypes.size();
+	RowSlot empty;
+	empty.text.offset = 0;
+	empty.text.length = 0;
+
+	types = &columnTypes;
+	dictionaries = columnDictionaries;
+	slots.assign( columnSize, empty );
+	formats.assign( columnSize, FORMAT_TEXT );
+	nullBits.assign( ( columnSize + 31 ) / 32, ~0u );
+	text.assign( 1, '\0' );
+}
+
+/**
+ * @brief Row setValue
+ *
+ * @details sets a value from its stored text
+ *
+ * @par Algorithm an int or float that parseSlotNumber accepts is held in
+ *      its slot, with the digits after the decimal point of a float kept as
+ *      its format. A string in the dictionary of its attribute is held as
+ *      its code. Other strings, nulls and other numbers keep their text
+ *
+ * @param [in] int index
+ *
+ * @param [in] const char * data, size_t length - the stored text, quotes
+ *             included
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setValue( int index, const char * data, size_t length )
+{
+	int type = ( *types )[ index ];
+	long long mantissa;
+	int fractionDigits;
+	bool negative;
+
+	setNull( index, isNullText( data, length ) );
+	if( type == VALUE_STRING && !isNull( index ) && dictionaries != NULL && ( *dictionaries )[ index ] != NULL )
+	{
+		int code = ( *dictionaries )[ index ]->lookup( data, length );
+		if( code >= 0 )
+		{
+			setCode( index, code );
+			return;
+		}
+	}
+	else if( type != VALUE_STRING && !isNull( index ) &&
+		parseSlotNumber( data, length, type == VALUE_FLOAT, mantissa, fractionDigits, negative ) )
+	{
+		if( type == VALUE_INT )
+		{
+			slots[ index ].intValue = negative ? -mantissa : mantissa;
+		}
+		else
+		{
+			double value = mantissa / SLOT_POWERS_OF_TEN[ fractionDigits ];
+			slots[ index ].floatValue = negative ? -value : value;
+		}
+		formats[ index ] = fractionDigits;
+		return;
+	}
+	setText( index, data, length );
+}
+
+void Row::setValue( int index, const string &value )
+{
+	setValue( index, value.data(), value.size() );
+}
+
+/**
+ * @brief Row setStored
+ *
+ * @details sets a value from its text in a table file
+ *
+ * @par Algorithm a value of an encoded attribute is stored as the decimal
+ *      code of its text, anything else is stored as its text. A code that
+ *      is not in the dictionary is kept as text rather than misread
+ *
+ * @param [in] int index
+ *
+ * @param [in] const char * data, size_t length
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setStored( int index, const char * data, size_t length )
+{
+	const Dictionary * dictionary = ( dictionaries == NULL ) ? NULL : ( *dictionaries )[ index ];
+	if( dictionary == NULL || isNullText( data, length ) )
+	{
+		setValue( index, data, length );
+		return;
+	}
+
+	unsigned long code = 0;
+	size_t position = 0;
+	while( position < length && position < 10 && data[ position ] >= '0' && data[ position ] <= '9' )
+	{
+		code = code * 10 + ( data[ position ] - '0' );
+		position++;
+	}
+	setNull( index, false );
+	if( position == 0 || position != length || code >= dictionary->values.size() )
+	{
+		setText( index, data, length );
+		return;
+	}
+	setCode( index, code );
+}
+
+/**
+ * @brief Row setSlot
+ *
+ * @details sets a value from the parts of another row
+ *
+ * @param [in] int index
+ *
+ * @param [in] const RowSlot &slot, unsigned char format, bool null - the
+ *             value's slot, format and null bit
+ *
+ * @param [in] const char * textBase - text the slot's offset is relative to
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setSlot( int index, const RowSlot &slot, unsigned char format, bool null, const char * textBase )
+{
+	setNull( index, null );
+	if( format == FORMAT_TEXT )
+	{
+		setText( index, textBase + slot.text.offset, slot.text.length );
+		return;
+	}
+	slots[ index ] = slot;
+	formats[ index ] = format;
+}
+
+/**
+ * @brief Row copyValue
+ *
+ * @details copies a value of another row
+ *
+ * @param [in] int index
+ *
+ * @param [in] const Row &source
+ *
+ * @param [in] int sourceIndex
+ *
+ * @return None
+ *
+ * @note the two rows must have the same type at the two indexes
+ */
+void Row::copyValue( int index, const Row &source, int sourceIndex )
+{
+	setSlot( index, source.slots[ sourceIndex ], source.formats[ sourceIndex ], source.isNull( sourceIndex ),
+		source.text.data() );
+}
+
+/**
+ * @brief Row appendText
+ *
+ * @details appends the text of a value exactly as it was stored
+ *
+ * @par Algorithm a float is rebuilt from its mantissa, which is recovered
+ *      exactly since it has at most MAX_SLOT_DIGITS digits
+ *
+ * @param [in] int index
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::appendText( int index, string &output ) const
+{
+	const RowSlot &slot = slots[ index ];
+	int format = formats[ index ];
+	//digits are written from the end of the buffer
+	char digits[ 32 ];
+	char * start = digits + sizeof( digits );
+	unsigned long long magnitude;
+	bool negative;
+
+	if( format == FORMAT_TEXT )
+	{
+		output.append( text, slot.text.offset, slot.text.length );
+		return;
+	}
+	if( format == FORMAT_CODE )
+	{
+		output += ( *dictionaries )[ index ]->values[ slot.intValue ];
+		return;
+	}
+	if( ( *types )[ index ] == VALUE_INT )
+	{
+		negative = slot.intValue < 0;
+		magnitude = negative ? -(unsigned long long) slot.intValue : slot.intValue;
+	}
+	else
+	{
+		negative = signbit( slot.floatValue );
+		magnitude = llround( fabs( slot.floatValue ) * SLOT_POWERS_OF_TEN[ format ] );
+	}
+
+	for( int digitCount = 0; magnitude > 0 || digitCount <= format; digitCount++ )
+	{
+		if( digitCount == format && format > 0 )
+		{
+			*--start = '.';
+		}
+		*--start = '0' + magnitude % 10;
+		magnitude /= 10;
+	}
+	if( negative )
+	{
+		*--start = '-';
+	}
+	output.append( start, digits + sizeof( digits ) - start );
+}
+
+/**
+ * @brief Row appendStored
+ *
+ * @details appends a value the way it is stored in a table file: the code
+ *          of an encoded value, the text of anything else
+ *
+ * @param [in] int index
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::appendStored( int index, string &output ) const
+{
+	if( formats[ index ] != FORMAT_CODE )
+	{
+		appendText( index, output );
+		return;
+	}
+
+	char digits[ 24 ];
+	int length = snprintf( digits, sizeof( digits ), "%ld", slots[ index ].intValue );
+	output.append( digits, length );
+}
+
+/**
+ * @brief Row setNull
+ *
+ * @param [in] int index
+ *
+ * @param [in] bool null
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setNull( int index, bool null )
+{
+	if( null )
+	{
+		nullBits[ index >> 5 ] |= 1u << ( index & 31 );
+	}
+	else
+	{
+		nullBits[ index >> 5 ] &= ~( 1u << ( index & 31 ) );
+	}
+}
+
+/**
+ * @brief Row setText
+ *
+ * @details keeps a value as text at the end of the row's text
+ *
+ * @param [in] int index
+ *
+ * @param [in] const char * data, size_t length
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setText( int index, const char * data, size_t length )
+{
+	slots[ index ].text.offset = text.size();
+	slots[ index ].text.length = length;
+	formats[ index ] = FORMAT_TEXT;
+	text.append( data, length );
+	text += '\0';
+}
+
+/**
+ * @brief Row setCode
+ *
+ * @details holds a value as its code in the attribute's dictionary
+ *
+ * @param [in] int index
+ *
+ * @param [in] int code
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Row::setCode( int index, int code )
+{
+	slots[ index ].intValue = code;
+	formats[ index ] = FORMAT_CODE;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
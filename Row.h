@@ -0,0 +1,293 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Row.h
+ *
+ * @brief Definition file for the Row class
+ *
+ * @details Specifies the typed tuple the operators pass to each other. An int
+ *          or float value is held in a fixed-width slot, a string value as
+ *          the offset and length of its text in one buffer per row, a value
+ *          of a dictionary encoded attribute as its code, and nulls in a
+ *          bitmap. Numbers are written back exactly as they were
+ *          stored, so a row can be output or saved without changing a value
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "Dictionary.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef ROW_H
+#define ROW_H
+
+//value types of attributes
+const int VALUE_INT = 0;
+const int VALUE_FLOAT = 1;
+const int VALUE_STRING = 2;
+
+//format of a value kept as its stored text: strings, nulls and numbers
+//that can not be rebuilt from their slot. An int slot otherwise has format
+//0 and a float slot the number of digits after its decimal point
+const unsigned char FORMAT_TEXT = 0xff;
+//format of a value held as its code in the attribute's dictionary
+const unsigned char FORMAT_CODE = 0xfd;
+//digits of a number rebuilt from its slot, more are kept as text
+const int MAX_SLOT_DIGITS = 15;
+
+//a value inside the text of a row or a condition
+struct TextView{
+	const char * data;
+	size_t length;
+};
+
+inline int compareText( const TextView &left, const TextView &right )
+{
+	int result = memcmp( left.data, right.data, left.length < right.length ? left.length : right.length );
+	if( result != 0 )
+	{
+		return result;
+	}
+	return ( left.length < right.length ) ? -1 : ( left.length > right.length ) ? 1 : 0;
+}
+
+inline bool operator==( const TextView &left, const TextView &right )
+{
+	return left.length == right.length && memcmp( left.data, right.data, left.length ) == 0;
+}
+
+inline bool operator!=( const TextView &left, const TextView &right )
+{
+	return !( left == right );
+}
+
+inline bool operator<( const TextView &left, const TextView &right )
+{
+	return compareText( left, right ) < 0;
+}
+
+inline bool operator<=( const TextView &left, const TextView &right )
+{
+	return compareText( left, right ) <= 0;
+}
+
+inline bool operator>( const TextView &left, const TextView &right )
+{
+	return compareText( left, right ) > 0;
+}
+
+inline bool operator>=( const TextView &left, const TextView &right )
+{
+	return compareText( left, right ) >= 0;
+}
+
+//value of an int or float attribute, code of an encoded value, or where a
+//string value's text is
+union RowSlot{
+	long intValue;
+	double floatValue;
+	struct{
+		unsigned int offset;
+		unsigned int length;
+	} text;
+};
+
+class Row;
+
+//value types a kernel reads values as. Text is converted the way it always
+//was: plain decimal values inline, anything else (exponents, very long
+//mantissas) by the library conversion
+struct IntValue{
+	typedef long Type;
+	static long convert( const char * digit )
+	{
+		bool negative = ( *digit == '-' );
+		if( *digit == '-' || *digit == '+' )
+		{
+			digit++;
+		}
+		long result = 0;
+		while( *digit >= '0' && *digit <= '9' )
+		{
+			result = result * 10 + ( *digit - '0' );
+			digit++;
+		}
+		return negative ? -result : result;
+	}
+	static long convert( const string &value )
+	{
+		return convert( value.c_str() );
+	}
+	static long read( const Row &row, int index, string &scratch );
+};
+
+struct FloatValue{
+	typedef double Type;
+	static double convert( const char * value )
+	{
+		static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+			1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+		const char * digit = value;
+		bool negative = ( *digit == '-' );
+		if( *digit == '-' || *digit == '+' )
+		{
+			digit++;
+		}
+
+		//an exactly representable mantissa divided by an exact power of ten
+		//rounds the same as the library conversion
+		long long mantissa = 0;
+		int digitCount = 0;
+		int fractionDigits = 0;
+		bool fraction = false;
+		for( ; ( *digit >= '0' && *digit <= '9' ) || ( *digit == '.' && !fraction ); digit++ )
+		{
+			if( *digit == '.' )
+			{
+				fraction = true;
+				continue;
+			}
+			mantissa = mantissa * 10 + ( *digit - '0' );
+			digitCount++;
+			if( fraction )
+			{
+				fractionDigits++;
+			}
+		}
+		if( *digit != '\0' || digitCount == 0 || digitCount > MAX_SLOT_DIGITS )
+		{
+			return atof( value );
+		}
+		double result = mantissa / powersOfTen[ fractionDigits ];
+		return negative ? -result : result;
+	}
+	static double convert( const string &value )
+	{
+		return convert( value.c_str() );
+	}
+	static double read( const Row &row, int index, string &scratch );
+};
+
+struct StringValue{
+	typedef TextView Type;
+	static TextView convert( const string &value )
+	{
+		TextView view = { value.data(), value.size() };
+		return view;
+	}
+	static TextView read( const Row &row, int index, string &scratch );
+};
+
+class Row{
+	public:
+		//value type and dictionary (NULL if not encoded) of each attribute,
+		//owned by the operator producing the row
+		const vector< int > * types;
+		const vector< const Dictionary * > * dictionaries;
+		vector< RowSlot > slots;
+		vector< unsigned char > formats;
+		vector< unsigned int > nullBits;
+		//text of the values of FORMAT_TEXT, each followed by a '\0'. It
+		//starts with a '\0' so that empty values point at an empty string
+		string text;
+
+		Row();
+		void reset( const vector< int > &columnTypes, const vector< const Dictionary * > * columnDictionaries = NULL );
+		void setValue( int index, const char * data, size_t length );
+		void setValue( int index, const string &value );
+		void setStored( int index, const char * data, size_t length );
+		void setSlot( int index, const RowSlot &slot, unsigned char format, bool null, const char * textBase );
+		void copyValue( int index, const Row &source, int sourceIndex );
+		void appendText( int index, string &output ) const;
+		void appendStored( int index, string &output ) const;
+
+		inline int size() const
+		{
+			return slots.size();
+		}
+		inline bool isNull( int index ) const
+		{
+			return ( nullBits[ index >> 5 ] >> ( index & 31 ) ) & 1;
+		}
+		inline long getInt( int index ) const
+		{
+			if( formats[ index ] == FORMAT_TEXT || formats[ index ] == FORMAT_CODE )
+			{
+				return IntValue::convert( textOf( index ) );
+			}
+			if( ( *types )[ index ] == VALUE_FLOAT )
+			{
+				return (long) slots[ index ].floatValue;
+			}
+			return slots[ index ].intValue;
+		}
+		inline double getFloat( int index ) const
+		{
+			if( formats[ index ] == FORMAT_TEXT || formats[ index ] == FORMAT_CODE )
+			{
+				return FloatValue::convert( textOf( index ) );
+			}
+			if( ( *types )[ index ] == VALUE_INT )
+			{
+				return (double) slots[ index ].intValue;
+			}
+			return slots[ index ].floatValue;
+		}
+		//the text of a value, rebuilt in scratch for a number held in a slot
+		inline TextView getText( int index, string &scratch ) const
+		{
+			if( formats[ index ] == FORMAT_CODE )
+			{
+				const string &value = ( *dictionaries )[ index ]->values[ slots[ index ].intValue ];
+				TextView view = { value.data(), value.size() };
+				return view;
+			}
+			if( formats[ index ] != FORMAT_TEXT )
+			{
+				scratch.clear();
+				appendText( index, scratch );
+				TextView view = { scratch.data(), scratch.size() };
+				return view;
+			}
+			TextView view = { text.data() + slots[ index ].text.offset, slots[ index ].text.length };
+			return view;
+		}
+
+	private:
+		void setNull( int index, bool null );
+		void setText( int index, const char * data, size_t length );
+		void setCode( int index, int code );
+		//text of a value kept as text or as a code
+		inline const char * textOf( int index ) const
+		{
+			if( formats[ index ] == FORMAT_CODE )
+			{
+				return ( *dictionaries )[ index ]->values[ slots[ index ].intValue ].c_str();
+			}
+			return text.c_str() + slots[ index ].text.offset;
+		}
+};
+
+inline long IntValue::read( const Row &row, int index, string &scratch )
+{
+	return row.getInt( index );
+}
+
+inline double FloatValue::read( const Row &row, int index, string &scratch )
+{
+	return row.getFloat( index );
+}
+
+inline TextView StringValue::read( const Row &row, int index, string &scratch )
+{
+	return row.getText( index, scratch );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,478 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Server.cpp
+ *
+ * @brief Implementation file for the server mode
+ *
+ * @details Implements listening for clients, running a session per client
+ *          on its own thread, and the client that connects the terminal to
+ *          a server
+ *
+ * @Note Requires Server.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <thread>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "Server.h"
+#include "Database.h"
+#include "Lock.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SERVER_CPP
+#define SERVER_CPP
+
+//declaration of the helper functions
+string loadDatabaseSystem( string currentWorkingDirectory, vector< Database > &dbms );
+void runSession( istream &in, vector< Database > &dbms, string currentWorkingDirectory );
+extern ReadWriteLock catalogLock;
+
+thread_local streambuf * SessionOutput::target = NULL;
+
+//set by SIGINT or SIGTERM, the server stops accepting clients
+volatile sig_atomic_t serverStopping = 0;
+
+/**
+ * @brief SocketBuffer constructor
+ *
+ * @param [in] int socketFd - a connected socket, closed by the destructor
+ *
+ * @note None
+ */
+SocketBuffer::SocketBuffer( int socketFd ) : input( SOCKET_BUFFER_SIZE ), output( SOCKET_BUFFER_SIZE )
+{
+	fd = socketFd;
+	clientGone = false;
+	setg( &input[ 0 ], &input[ 0 ], &input[ 0 ] );
+	setp( &output[ 0 ], &output[ 0 ] + output.size() );
+}
+
+SocketBuffer::~SocketBuffer()
+{
+	writeOutput();
+	close( fd );
+}
+
+/**
+ * @brief SocketBuffer underflow
+ *
+ * @details reads what the client has sent so far once the input is used up
+ *
+ * @return int the next character, EOF once the client stops sending or
+ *         is gone
+ *
+ * @note None
+ */
+int SocketBuffer::underflow()
+{
+	if( gptr() < egptr() )
+	{
+		return traits_type::to_int_type( *gptr() );
+	}
+
+	//output is sent before waiting for more statements, the statements
+	//of a client that is gone are never run
+	if( !writeOutput() )
+	{
+		return traits_type::eof();
+	}
+	ssize_t count;
+	do
+	{
+		count = read( fd, &input[ 0 ], input.size() );
+	} while( count < 0 && errno == EINTR );
+	if( count <= 0 )
+	{
+		return traits_type::eof();
+	}
+	setg( &input[ 0 ], &input[ 0 ], &input[ 0 ] + count );
+	return traits_type::to_int_type( *gptr() );
+}
+
+int SocketBuffer::overflow( int c )
+{
+	writeOutput();
+	if( !traits_type::eq_int_type( c, traits_type::eof() ) )
+	{
+		sputc( traits_type::to_char_type( c ) );
+	}
+	return traits_type::not_eof( c );
+}
+
+int SocketBuffer::sync()
+{
+	writeOutput();
+	return 0;
+}
+
+/**
+ * @brief SocketBuffer writeOutput
+ *
+ * @details sends the output kept so far, or drops it if the client is gone
+ *
+ * @return bool false if the client is gone
+ *
+ * @note None
+ */
+bool SocketBuffer::writeOutput()
+{
+	char * data = pbase();
+	size_t size = clientGone ? 0 : pptr() - pbase();
+	while( size > 0 )
+	{
+		ssize_t count = send( fd, data, size, MSG_NOSIGNAL );
+		if( count < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		if( count <= 0 )
+		{
+			clientGone = true;
+			break;
+		}
+		data += count;
+		size -= count;
+	}
+	setp( &output[ 0 ], &output[ 0 ] + output.size() );
+	return !clientGone;
+}
+
+/**
+ * @brief SessionOutput constructor
+ *
+ * @param [in] streambuf * defaultBuffer - output of threads without a
+ *             session, the terminal
+ *
+ * @note None
+ */
+SessionOutput::SessionOutput( streambuf * defaultBuffer )
+{
+	defaultTarget = defaultBuffer;
+}
+
+void SessionOutput::setTarget( streambuf * buffer )
+{
+	target = buffer;
+}
+
+streambuf * SessionOutput::current()
+{
+	return ( target == NULL ) ? defaultTarget : target;
+}
+
+int SessionOutput::overflow( int c )
+{
+	if( !traits_type::eq_int_type( c, traits_type::eof() ) )
+	{
+		current()->sputc( traits_type::to_char_type( c ) );
+	}
+	return traits_type::not_eof( c );
+}
+
+streamsize SessionOutput::xsputn( const char * data, streamsize count )
+{
+	current()->sputn( data, count );
+	return count;
+}
+
+int SessionOutput::sync()
+{
+	current()->pubsync();
+	return 0;
+}
+
+/**
+ * @brief serveSession
+ *
+ * @details runs the session of one client, its output goes back to the
+ *          client
+ *
+ * @param [in] int fd - the client's socket
+ *
+ * @param [in] vector< Database > * dbms
+ *
+ * @param [in] string currentWorkingDirectory - the database system directory
+ *
+ * @return None
+ *
+ * @note runs on the session's own thread
+ */
+void serveSession( int fd, vector< Database > * dbms, string currentWorkingDirectory )
+{
+	SocketBuffer buffer( fd );
+	istream in( &buffer );
+
+	SessionOutput::setTarget( &buffer );
+	runSession( in, *dbms, currentWorkingDirectory );
+	cout.flush();
+	SessionOutput::setTarget( NULL );
+}
+
+/**
+ * @brief stopServer
+ *
+ * @details signal handler, makes the server stop accepting clients
+ *
+ * @param [in] int signalNumber
+ *
+ * @return None
+ *
+ * @note None
+ */
+void stopServer( int signalNumber )
+{
+	serverStopping = 1;
+}
+
+/**
+ * @brief listenUnix
+ *
+ * @details listens on a Unix domain socket, replacing a socket left behind
+ *          at the path
+ *
+ * @param [in] string socketPath
+ *
+ * @return int the listening socket, -1 on failure
+ *
+ * @note None
+ */
+int listenUnix( string socketPath )
+{
+	struct sockaddr_un address;
+	memset( &address, 0, sizeof( address ) );
+	address.sun_family = AF_UNIX;
+	if( socketPath.size() >= sizeof( address.sun_path ) )
+	{
+		return -1;
+	}
+	strcpy( address.sun_path, socketPath.c_str() );
+
+	int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+	unlink( socketPath.c_str() );
+	if( fd < 0 || bind( fd, (struct sockaddr *) &address, sizeof( address ) ) != 0 || listen( fd, SOMAXCONN ) != 0 )
+	{
+		if( fd >= 0 )
+		{
+			close( fd );
+		}
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * @brief listenTcp
+ *
+ * @details listens on a TCP port of localhost only
+ *
+ * @param [in] int port
+ *
+ * @return int the listening socket, -1 on failure
+ *
+ * @note None
+ */
+int listenTcp( int port )
+{
+	struct sockaddr_in address;
+	memset( &address, 0, sizeof( address ) );
+	address.sin_family = AF_INET;
+	address.sin_port = htons( port );
+	address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+	int reuse = 1;
+	int fd = socket( AF_INET, SOCK_STREAM, 0 );
+	if( fd < 0 || setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) ) != 0 ||
+		bind( fd, (struct sockaddr *) &address, sizeof( address ) ) != 0 || listen( fd, SOMAXCONN ) != 0 )
+	{
+		if( fd >= 0 )
+		{
+			close( fd );
+		}
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * @brief startServer
+ *
+ * @details loads the databases and runs a session for every client that
+ *          connects, until SIGINT or SIGTERM
+ *
+ * @par Algorithm polls the listening sockets. A client that connects gets a
+ *      detached thread running its session; cout is replaced by a
+ *      SessionOutput so that everything a statement outputs goes to the
+ *      client of the thread running it
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string socketPath - Unix domain socket, none if empty
+ *
+ * @param [in] int port - TCP port on localhost, none if 0
+ *
+ * @return int exit status
+ *
+ * @note None
+ */
+int startServer( string currentWorkingDirectory, string socketPath, int port )
+{
+	vector< pollfd > listeners;
+	vector< Database > * dbms = new vector< Database >();
+
+	if( !socketPath.empty() )
+	{
+		pollfd listener = { listenUnix( socketPath ), POLLIN, 0 };
+		if( listener.fd < 0 )
+		{
+			cout << "-- !Failed to listen on " << socketPath << " because " << strerror( errno ) << "." << endl;
+			return 1;
+		}
+		listeners.push_back( listener );
+	}
+	if( port > 0 )
+	{
+		pollfd listener = { listenTcp( port ), POLLIN, 0 };
+		if( listener.fd < 0 )
+		{
+			cout << "-- !Failed to listen on port " << port << " because " << strerror( errno ) << "." << endl;
+			return 1;
+		}
+		listeners.push_back( listener );
+	}
+
+	struct sigaction action;
+	memset( &action, 0, sizeof( action ) );
+	action.sa_handler = stopServer;
+	sigaction( SIGINT, &action, NULL );
+	sigaction( SIGTERM, &action, NULL );
+
+	//the sessions outlive this function if they are still running
+	currentWorkingDirectory = loadDatabaseSystem( currentWorkingDirectory, *dbms );
+	static SessionOutput sessionOutput( cout.rdbuf() );
+	cout.rdbuf( &sessionOutput );
+	cout << "-- Server ready." << endl;
+
+	while( !serverStopping )
+	{
+		if( poll( &listeners[ 0 ], listeners.size(), -1 ) < 0 )
+		{
+			continue;
+		}
+		int listenerSize = listeners.size();
+		for( int index = 0; index < listenerSize; index++ )
+		{
+			if( !( listeners[ index ].revents & POLLIN ) )
+			{
+				continue;
+			}
+			int fd = accept( listeners[ index ].fd, NULL, NULL );
+			if( fd < 0 )
+			{
+				continue;
+			}
+			int noDelay = 1;
+			setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof( noDelay ) );
+			thread( serveSession, fd, dbms, currentWorkingDirectory ).detach();
+		}
+	}
+
+	int listenerSize = listeners.size();
+	for( int index = 0; index < listenerSize; index++ )
+	{
+		close( listeners[ index ].fd );
+	}
+	if( !socketPath.empty() )
+	{
+		unlink( socketPath.c_str() );
+	}
+	//statements still running finish before the databases go away
+	ReadWriteGuard statements( catalogLock, true );
+	cout << "-- Server stopped." << endl;
+	return 0;
+}
+
+/**
+ * @brief copyInput
+ *
+ * @details sends the terminal input to the server, then tells it the input
+ *          has ended
+ *
+ * @param [in] int fd - socket connected to the server
+ *
+ * @return None
+ *
+ * @note runs on its own thread while the output is read
+ */
+void copyInput( int fd )
+{
+	vector< char > buffer( SOCKET_BUFFER_SIZE );
+	ssize_t count;
+	while( ( count = read( STDIN_FILENO, &buffer[ 0 ], buffer.size() ) ) > 0 )
+	{
+		for( ssize_t sent = 0; sent < count; )
+		{
+			ssize_t written = send( fd, &buffer[ sent ], count - sent, MSG_NOSIGNAL );
+			if( written <= 0 )
+			{
+				return;
+			}
+			sent += written;
+		}
+	}
+	shutdown( fd, SHUT_WR );
+}
+
+/**
+ * @brief startClient
+ *
+ * @details connects the terminal to a server: statements are read from the
+ *          terminal and the output of the session is written to it
+ *
+ * @param [in] string socketPath - Unix domain socket of the server
+ *
+ * @return int exit status
+ *
+ * @note None
+ */
+int startClient( string socketPath )
+{
+	struct sockaddr_un address;
+	memset( &address, 0, sizeof( address ) );
+	address.sun_family = AF_UNIX;
+	strncpy( address.sun_path, socketPath.c_str(), sizeof( address.sun_path ) - 1 );
+
+	int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( fd < 0 || connect( fd, (struct sockaddr *) &address, sizeof( address ) ) != 0 )
+	{
+		cout << "-- !Failed to connect to " << socketPath << " because " << strerror( errno ) << "." << endl;
+		return 1;
+	}
+
+	thread( copyInput, fd ).detach();
+	vector< char > buffer( SOCKET_BUFFER_SIZE );
+	ssize_t count;
+	while( ( count = read( fd, &buffer[ 0 ], buffer.size() ) ) > 0 )
+	{
+		cout.write( &buffer[ 0 ], count );
+	}
+	cout.flush();
+	close( fd );
+	return 0;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,77 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Server.h
+ *
+ * @brief Definition file for the server mode
+ *
+ * @details Specifies the server that runs sessions for clients connected
+ *          over a Unix domain socket or TCP on localhost. Every session runs
+ *          on its own thread with its own current database, the databases
+ *          are loaded once and shared. A client sends statements exactly as
+ *          they would be typed at the terminal and reads their output back
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <streambuf>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SERVER_H
+#define SERVER_H
+
+//bytes read from or written to a socket at once
+const int SOCKET_BUFFER_SIZE = 1 << 16;
+
+//stream buffer over a connected socket. Once the client is gone the output
+//is dropped rather than failing, the streams writing it are shared by every
+//session, and the input ends so only this session stops
+class SocketBuffer : public streambuf{
+	public:
+		SocketBuffer( int socketFd );
+		~SocketBuffer();
+
+	protected:
+		int underflow();
+		int overflow( int c );
+		int sync();
+
+	private:
+		int fd;
+		//true once sending to the client failed
+		bool clientGone;
+		vector< char > input;
+		vector< char > output;
+
+		SocketBuffer( const SocketBuffer &other );
+		SocketBuffer &operator=( const SocketBuffer &other );
+		bool writeOutput();
+};
+
+//stream buffer installed in cout by the server, it passes the output of
+//each thread on to the stream buffer of that thread's session. It never
+//reports a failure, which would leave cout failed for every session
+class SessionOutput : public streambuf{
+	public:
+		SessionOutput( streambuf * defaultBuffer );
+		//output of the calling thread goes to buffer, NULL for the default
+		static void setTarget( streambuf * buffer );
+
+	protected:
+		int overflow( int c );
+		streamsize xsputn( const char * data, streamsize count );
+		int sync();
+
+	private:
+		streambuf * defaultTarget;
+		static thread_local streambuf * target;
+
+		streambuf * current();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,153 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SlowQueryLog.cpp
+ *
+ * @brief Implementation file for the SlowQueryLog class
+ *
+ * @details Implements logging and rotating the log of slow statements
+ *
+ * @Note Requires SlowQueryLog.h
+ */
+
+#include <iostream>
+#include <string>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <ctime>
+#include <sys/stat.h>
+#include "SlowQueryLog.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SLOWQUERYLOG_CPP
+#define SLOWQUERYLOG_CPP
+
+string SlowQueryLog::filePath;
+double SlowQueryLog::thresholdSeconds = -1;
+long long SlowQueryLog::fileSize = 0;
+mutex SlowQueryLog::logMutex;
+
+/**
+ * @brief SlowQueryLog configure
+ *
+ * @details sets the log file and the threshold statements are logged over
+ *
+ * @param [in] string logFilePath
+ *
+ * @param [in] int milliseconds - negative to log nothing
+ *
+ * @return None
+ *
+ * @note called before any session starts
+ */
+void SlowQueryLog::configure( string logFilePath, int milliseconds )
+{
+	filePath = logFilePath;
+	thresholdSeconds = milliseconds < 0 ? -1 : milliseconds / 1000.0;
+
+	struct stat fileStatus;
+	fileSize = ( stat( filePath.c_str(), &fileStatus ) == 0 ) ? fileStatus.st_size : 0;
+}
+
+bool SlowQueryLog::isSlow( double seconds )
+{
+	return thresholdSeconds >= 0 && seconds >= thresholdSeconds;
+}
+
+/**
+ * @brief SlowQueryLog write
+ *
+ * @details appends a statement to the log: a line starting with "# " with
+ *          when it ended, the seconds it took, the records it scanned and
+ *          returned and its plan, then its text on one line
+ *
+ * @param [in] string statement
+ *
+ * @param [in] double seconds
+ *
+ * @param [in] string plan - empty if the statement has none
+ *
+ * @param [in] long long rowsScanned
+ *
+ * @param [in] long long rowsReturned
+ *
+ * @return None
+ *
+ * @note an entry that could not be written is lost, the statement itself
+ *       already ran
+ */
+void SlowQueryLog::write( string statement, double seconds, string plan, long long rowsScanned,
+	long long rowsReturned )
+{
+	//a statement spread over lines is logged on one
+	for( unsigned int index = 0; index < statement.size(); index++ )
+	{
+		if( statement[ index ] == '\n' || statement[ index ] == '\r' || statement[ index ] == '\t' )
+		{
+			statement[ index ] = ' ';
+		}
+	}
+
+	time_t now = time( NULL );
+	struct tm localNow;
+	localtime_r( &now, &localNow );
+	char timeText[ 32 ];
+	strftime( timeText, sizeof( timeText ), "%Y-%m-%d %H:%M:%S", &localNow );
+
+	stringstream entry;
+	entry << "# Time: " << timeText << "  Seconds: " << fixed << setprecision( 3 ) << seconds;
+	entry << "  Rows scanned: " << rowsScanned << "  Rows returned: " << rowsReturned;
+	if( !plan.empty() )
+	{
+		entry << "  Plan: " << plan;
+	}
+	entry << "\n" << statement << ";\n";
+	string text = entry.str();
+
+	lock_guard< mutex > logging( logMutex );
+	if( fileSize > 0 && fileSize + (long long) text.size() > SLOW_QUERY_LOG_BYTES )
+	{
+		rotate();
+	}
+	ofstream fout( filePath.c_str(), ios::app );
+	fout << text;
+	fout.close();
+	if( !fout.fail() )
+	{
+		fileSize += text.size();
+	}
+}
+
+/**
+ * @brief SlowQueryLog rotate
+ *
+ * @details moves each log to the next suffix, dropping the oldest, so the
+ *          log starts empty
+ *
+ * @return None
+ *
+ * @note called holding logMutex
+ */
+void SlowQueryLog::rotate()
+{
+	for( int index = SLOW_QUERY_LOG_FILES - 1; index > 0; index-- )
+	{
+		stringstream from;
+		stringstream to;
+		from << filePath;
+		if( index > 1 )
+		{
+			from << "." << index - 1;
+		}
+		to << filePath << "." << index;
+		rename( from.str().c_str(), to.str().c_str() );
+	}
+	fileSize = 0;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
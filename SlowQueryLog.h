@@ -0,0 +1,53 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SlowQueryLog.h
+ *
+ * @brief Definition file for the SlowQueryLog class
+ *
+ * @details Specifies the log of the statements that took longer than a
+ *          threshold. Each is logged with the seconds it took, its plan,
+ *          the records it scanned and returned, and its text, so the log
+ *          shows which tables are worth an index. The log is rotated once
+ *          it grows past SLOW_QUERY_LOG_BYTES, keeping the last
+ *          SLOW_QUERY_LOG_FILES files
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SLOWQUERYLOG_H
+#define SLOWQUERYLOG_H
+
+//statements taking this long are logged unless --slow-query-ms is given
+const int SLOW_QUERY_MILLISECONDS = 1000;
+//the log in the database system directory, hidden so it is not taken for
+//a database. Rotated logs end in .1 (the newest) to .3
+const string SLOW_QUERY_LOG_NAME = ".slow_query.log";
+const long long SLOW_QUERY_LOG_BYTES = 1 << 20;
+const int SLOW_QUERY_LOG_FILES = 4;
+
+class SlowQueryLog{
+	public:
+		static void configure( string logFilePath, int milliseconds );
+		static bool isSlow( double seconds );
+		static void write( string statement, double seconds, string plan, long long rowsScanned,
+			long long rowsReturned );
+
+	private:
+		static string filePath;
+		//negative if nothing is logged
+		static double thresholdSeconds;
+		static long long fileSize;
+		static mutex logMutex;
+
+		static void rotate();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
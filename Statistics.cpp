@@ -0,0 +1,593 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Statistics.cpp
+ *
+ * @brief Implementation file for the table statistics
+ *
+ * @details Implements the HyperLogLog distinct count sketch, the selectivity
+ *          estimates of an attribute and the collection, saving and loading
+ *          of the statistics of a table
+ *
+ * @Note Requires Statistics.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/stat.h>
+#include "Statistics.h"
+#include "Predicate.h"
+#include "Operator.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef STATISTICS_CPP
+#define STATISTICS_CPP
+
+//declaration of the helper functions
+bool caseInsCompare( string s1, string s2 );
+int getValueType( string attributeType );
+string getUntilTab( string &input );
+
+/**
+ * @brief hashValue
+ *
+ * @details hashes a stored value to 64 well mixed bits
+ *
+ * @par Algorithm FNV-1a over the characters followed by the splitmix64
+ *      finalizer, so that the leading bits used by HyperLogLog are uniform
+ *
+ * @param [in] const string &value
+ *
+ * @return unsigned long long
+ *
+ * @note None
+ */
+unsigned long long hashValue( const string &value )
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	int valueSize = value.size();
+	for( int index = 0; index < valueSize; index++ )
+	{
+		hash ^= (unsigned char) value[ index ];
+		hash *= 1099511628211ULL;
+	}
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebULL;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+/**
+ * @brief isNumericLiteral
+ *
+ * @details checks that a condition value is a number
+ *
+ * @param [in] const string &value
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isNumericLiteral( const string &value )
+{
+	if( value.empty() )
+	{
+		return false;
+	}
+	char first = value[ 0 ];
+	return ( first >= '0' && first <= '9' ) || first == '-' || first == '+' || first == '.';
+}
+
+/**
+ * @brief HyperLogLog constructor
+ *
+ * @details starts with every register empty
+ *
+ * @note None
+ */
+HyperLogLog::HyperLogLog()
+{
+	registers.assign( HLL_REGISTERS, 0 );
+}
+
+/**
+ * @brief HyperLogLog add
+ *
+ * @details adds a value to the sketch
+ *
+ * @par Algorithm the first HLL_INDEX_BITS bits of the hash pick a register,
+ *      which keeps the longest run of leading zeros (plus one) seen in the
+ *      remaining bits
+ *
+ * @param [in] const string &value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HyperLogLog::add( const string &value )
+{
+	unsigned long long hash = hashValue( value );
+	int index = hash >> ( 64 - HLL_INDEX_BITS );
+	unsigned long long rest = hash << HLL_INDEX_BITS;
+
+	unsigned char rank = 1;
+	while( rank <= 64 - HLL_INDEX_BITS && ( rest & ( 1ULL << 63 ) ) == 0 )
+	{
+		rank++;
+		rest <<= 1;
+	}
+	if( rank > registers[ index ] )
+	{
+		registers[ index ] = rank;
+	}
+}
+
+/**
+ * @brief HyperLogLog estimate
+ *
+ * @details estimates the number of distinct values added
+ *
+ * @par Algorithm the bias corrected harmonic mean of the registers; while
+ *      the estimate is small and some registers are still empty, linear
+ *      counting of the empty registers is more accurate
+ *
+ * @return double
+ *
+ * @note None
+ */
+double HyperLogLog::estimate()
+{
+	double registerCount = HLL_REGISTERS;
+	double sum = 0;
+	int emptyRegisters = 0;
+	for( int index = 0; index < HLL_REGISTERS; index++ )
+	{
+		sum += ldexp( 1.0, -registers[ index ] );
+		if( registers[ index ] == 0 )
+		{
+			emptyRegisters++;
+		}
+	}
+
+	double alpha = 0.7213 / ( 1.0 + 1.079 / registerCount );
+	double estimate = alpha * registerCount * registerCount / sum;
+	if( estimate <= 2.5 * registerCount && emptyRegisters > 0 )
+	{
+		estimate = registerCount * log( registerCount / emptyRegisters );
+	}
+	return estimate;
+}
+
+/**
+ * @brief equalSelectivity
+ *
+ * @details estimates the fraction of rows equal to a given value, assuming
+ *          the non-null rows are spread evenly over the distinct values
+ *
+ * @return double
+ *
+ * @note None
+ */
+double AttributeStatistics::equalSelectivity()
+{
+	return ( 1.0 - nullFraction ) / max( 1.0, distinctCount );
+}
+
+/**
+ * @brief lessFraction
+ *
+ * @details estimates the fraction of non-null values below a value
+ *
+ * @par Algorithm every bucket of the histogram holds the same number of
+ *      values; the buckets below the value count whole and the bucket
+ *      holding it counts in proportion to where the value falls
+ *
+ * @param [in] double value
+ *
+ * @return double
+ *
+ * @note requires a histogram
+ */
+double AttributeStatistics::lessFraction( double value )
+{
+	int buckets = histogram.size() - 1;
+	if( value <= histogram[ 0 ] )
+	{
+		return 0.0;
+	}
+	for( int bucket = 0; bucket < buckets; bucket++ )
+	{
+		if( value <= histogram[ bucket + 1 ] )
+		{
+			double width = histogram[ bucket + 1 ] - histogram[ bucket ];
+			double within = ( width > 0 ) ? ( value - histogram[ bucket ] ) / width : 1.0;
+			return ( bucket + within ) / buckets;
+		}
+	}
+	return 1.0;
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details estimates the fraction of rows a comparison with a value keeps
+ *
+ * @par Algorithm equalities use the distinct count, ranges over numeric
+ *      attributes use the histogram
+ *
+ * @param [in] string op - comparison operator
+ *
+ * @param [in] string value - the compared value
+ *
+ * @param [in] double defaultSelectivity - returned when the statistics can
+ *             not estimate the comparison
+ *
+ * @return double
+ *
+ * @note None
+ */
+double AttributeStatistics::selectivity( string op, string value, double defaultSelectivity )
+{
+	double nonNull = 1.0 - nullFraction;
+	double equal = equalSelectivity();
+
+	if( op == "=" )
+	{
+		return equal;
+	}
+	if( op == "!=" )
+	{
+		return max( 0.0, nonNull - equal );
+	}
+	if( histogram.size() < 2 || !isNumericLiteral( value ) )
+	{
+		return defaultSelectivity;
+	}
+
+	double less = lessFraction( FloatValue::convert( value ) ) * nonNull;
+	double result;
+	if( op == "<" )
+	{
+		result = less;
+	}
+	else if( op == "<=" )
+	{
+		result = less + equal;
+	}
+	else if( op == ">" )
+	{
+		result = nonNull - less - equal;
+	}
+	else
+	{
+		result = nonNull - less;
+	}
+	return min( 1.0, max( 0.0, result ) );
+}
+
+/**
+ * @brief TableStatistics constructor
+ *
+ * @details a table has no statistics until it is analyzed
+ *
+ * @note None
+ */
+TableStatistics::TableStatistics()
+{
+	analyzed = false;
+	rowCount = 0;
+}
+
+/**
+ * @brief analyze
+ *
+ * @details collects the statistics of a table file
+ *
+ * @par Algorithm one scan of the table feeds a HyperLogLog sketch and a null
+ *      count per attribute. Numeric attributes also keep a uniform reservoir
+ *      sample of STATISTICS_SAMPLE_SIZE values, which is sorted and cut into
+ *      HISTOGRAM_BUCKETS buckets of equal size
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableStatistics::analyze( string filePath )
+{
+	Row tuple;
+	string value;
+	TableScan scan( filePath );
+	int attrSize = scan.attributes.size();
+
+	vector< HyperLogLog > sketches( attrSize );
+	vector< double > nullCounts( attrSize, 0 );
+	vector< double > valueCounts( attrSize, 0 );
+	vector< vector< double > > samples( attrSize );
+	vector< bool > numeric( attrSize );
+	for( int index = 0; index < attrSize; index++ )
+	{
+		numeric[ index ] = getValueType( scan.attributes[ index ].attributeType ) != VALUE_STRING;
+	}
+
+	unsigned long long randomState = 88172645463325252ULL;
+	rowCount = 0;
+	scan.open();
+	while( scan.next( tuple ) )
+	{
+		rowCount++;
+		for( int index = 0; index < attrSize; index++ )
+		{
+			if( tuple.isNull( index ) )
+			{
+				nullCounts[ index ]++;
+				continue;
+			}
+			valueCounts[ index ]++;
+			value.clear();
+			tuple.appendText( index, value );
+			sketches[ index ].add( value );
+			if( !numeric[ index ] )
+			{
+				continue;
+			}
+
+			//reservoir sample, the nth value replaces a kept value with
+			//probability size / n
+			if( (int) samples[ index ].size() < STATISTICS_SAMPLE_SIZE )
+			{
+				samples[ index ].push_back( tuple.getFloat( index ) );
+			}
+			else
+			{
+				randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+				unsigned long long slot = ( randomState >> 33 ) % (unsigned long long) valueCounts[ index ];
+				if( slot < (unsigned long long) STATISTICS_SAMPLE_SIZE )
+				{
+					samples[ index ][ slot ] = tuple.getFloat( index );
+				}
+			}
+		}
+	}
+	scan.close();
+
+	attributes.clear();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		AttributeStatistics attrStats;
+		attrStats.attributeName = scan.attributes[ index ].attributeName;
+		attrStats.distinctCount = min( sketches[ index ].estimate(), valueCounts[ index ] );
+		if( valueCounts[ index ] > 0 )
+		{
+			attrStats.distinctCount = max( 1.0, attrStats.distinctCount );
+		}
+		attrStats.nullFraction = ( rowCount > 0 ) ? nullCounts[ index ] / rowCount : 0.0;
+
+		vector< double > &sample = samples[ index ];
+		int sampleSize = sample.size();
+		if( sampleSize > 0 )
+		{
+			sort( sample.begin(), sample.end() );
+			int buckets = min( HISTOGRAM_BUCKETS, sampleSize );
+			for( int bucket = 0; bucket <= buckets; bucket++ )
+			{
+				int position = ( bucket == buckets ) ? sampleSize - 1 : bucket * sampleSize / buckets;
+				attrStats.histogram.push_back( sample[ position ] );
+			}
+		}
+		attributes.push_back( attrStats );
+	}
+	analyzed = true;
+}
+
+/**
+ * @brief load
+ *
+ * @details reads statistics saved by save
+ *
+ * @param [in] string filePath - full path to the statistics file
+ *
+ * @return bool false if the table has not been analyzed
+ *
+ * @note None
+ */
+bool TableStatistics::load( string filePath )
+{
+	ifstream fin( filePath.c_str() );
+	return read( fin );
+}
+
+/**
+ * @brief read
+ *
+ * @details reads statistics written by write, up to the end of the stream
+ *
+ * @param [in] istream &in
+ *
+ * @return bool false if the stream is empty
+ *
+ * @note None
+ */
+bool TableStatistics::read( istream &in )
+{
+	string line;
+	analyzed = false;
+	rowCount = 0;
+	attributes.clear();
+
+	if( !getline( in, line ) )
+	{
+		return false;
+	}
+	rowCount = atof( line.c_str() );
+
+	while( getline( in, line ) )
+	{
+		if( line.empty() )
+		{
+			continue;
+		}
+
+		AttributeStatistics attrStats;
+		attrStats.attributeName = getUntilTab( line );
+		attrStats.distinctCount = atof( getUntilTab( line ).c_str() );
+		attrStats.nullFraction = atof( getUntilTab( line ).c_str() );
+
+		double bound;
+		istringstream bounds( line );
+		while( bounds >> bound )
+		{
+			attrStats.histogram.push_back( bound );
+		}
+		attributes.push_back( attrStats );
+	}
+
+	analyzed = true;
+	return true;
+}
+
+/**
+ * @brief save
+ *
+ * @details writes the statistics to a file, see write
+ *
+ * @param [in] string filePath - full path to the statistics file
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool TableStatistics::save( string filePath )
+{
+	ofstream fout( filePath.c_str() );
+	write( fout );
+	fout.close();
+	return !fout.fail();
+}
+
+/**
+ * @brief write
+ *
+ * @details writes the row count on the first line, then a line per
+ *          attribute: its name, distinct values, fraction of nulls and the
+ *          bounds of its histogram
+ *
+ * @param [in] ostream &out
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableStatistics::write( ostream &out )
+{
+	out << setprecision( 17 ) << rowCount;
+
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		AttributeStatistics &attrStats = attributes[ index ];
+		out << "\n" << attrStats.attributeName << "\t" << attrStats.distinctCount;
+		out << "\t" << attrStats.nullFraction << "\t";
+
+		int boundSize = attrStats.histogram.size();
+		for( int bound = 0; bound < boundSize; bound++ )
+		{
+			if( bound > 0 )
+			{
+				out << " ";
+			}
+			out << attrStats.histogram[ bound ];
+		}
+	}
+}
+
+/**
+ * @brief find
+ *
+ * @details returns the statistics of an attribute
+ *
+ * @param [in] string attributeName
+ *
+ * @return AttributeStatistics * NULL if the table has not been analyzed or
+ *         the attribute was added after
+ *
+ * @note None
+ */
+AttributeStatistics * TableStatistics::find( string attributeName )
+{
+	if( !analyzed )
+	{
+		return NULL;
+	}
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		if( attributes[ index ].attributeName == attributeName )
+		{
+			return &attributes[ index ];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief estimateRows
+ *
+ * @details estimates the number of records in a table file
+ *
+ * @par Algorithm the row count of an analyzed table is taken from its
+ *      statistics. Otherwise the records in the first ROW_SAMPLE_BYTES of
+ *      the file are counted; a larger file is assumed to continue with
+ *      records of the same average length
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @return double
+ *
+ * @note None
+ */
+double TableStatistics::estimateRows( string filePath )
+{
+	string line;
+	double sampledRows = 0;
+	double sampledBytes = 0;
+
+	if( analyzed )
+	{
+		return rowCount;
+	}
+
+	TableReader reader;
+	reader.open( filePath, line );
+	double headerBytes = reader.bytesRead;
+	bool wholeFile = false;
+	while( !wholeFile && sampledBytes < ROW_SAMPLE_BYTES )
+	{
+		wholeFile = !reader.readLine( line );
+		sampledRows += wholeFile ? 0 : 1;
+		sampledBytes = reader.bytesRead - headerBytes;
+	}
+	reader.close();
+
+	struct stat fileInfo;
+	if( wholeFile || sampledBytes == 0 || stat( filePath.c_str(), &fileInfo ) != 0 )
+	{
+		return sampledRows;
+	}
+	return sampledRows * ( fileInfo.st_size - headerBytes ) / sampledBytes;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,74 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Statistics.h
+ *
+ * @brief Definition file for the table statistics
+ *
+ * @details Specifies the statistics ANALYZE collects for a table: the row
+ *          count and, for each attribute, an estimate of its distinct
+ *          values, the fraction of null values and an equi-depth histogram
+ *          of numeric values. The optimizer uses them to estimate how many
+ *          tuples a condition or a join keeps
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+//2^10 registers, a standard error of about 3%
+const int HLL_INDEX_BITS = 10;
+const int HLL_REGISTERS = 1 << HLL_INDEX_BITS;
+//numeric values kept per attribute to build the histogram
+const int STATISTICS_SAMPLE_SIZE = 30000;
+const int HISTOGRAM_BUCKETS = 16;
+//bytes read from a table file to estimate its row count
+const int ROW_SAMPLE_BYTES = 65536;
+
+class HyperLogLog{
+	public:
+		vector< unsigned char > registers;
+
+		HyperLogLog();
+		void add( const string &value );
+		double estimate();
+};
+
+struct AttributeStatistics{
+	string attributeName;
+	double distinctCount;
+	double nullFraction;
+	//bounds of equi-depth buckets over the non-null values, empty for
+	//attributes that are not int or float
+	vector< double > histogram;
+
+	double equalSelectivity();
+	double lessFraction( double value );
+	double selectivity( string op, string value, double defaultSelectivity );
+};
+
+class TableStatistics{
+	public:
+		bool analyzed;
+		double rowCount;
+		vector< AttributeStatistics > attributes;
+
+		TableStatistics();
+		void analyze( string filePath );
+		bool load( string filePath );
+		bool save( string filePath );
+		bool read( istream &in );
+		void write( ostream &out );
+		AttributeStatistics * find( string attributeName );
+		double estimateRows( string filePath );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
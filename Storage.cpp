@@ -0,0 +1,1228 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Storage.cpp
+ *
+ * @brief Implementation file for the storage layer of table files
+ *
+ * @details Implements reading and writing the records of plain and
+ *          compressed table files, snapshots of table files, appending
+ *          records and changing the codec of a table
+ *
+ * @Note Requires Storage.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "Storage.h"
+#include "Metrics.h"
+#include "ResultCache.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef STORAGE_CPP
+#define STORAGE_CPP
+
+//declaration of the helper functions
+Codec * findCodec( unsigned char codecId );
+string getReadPath( const string &tableFilePath );
+bool appendTableText( string filePath, const string &text );
+void compactTable( string filePath );
+
+extern PageCache pageCache;
+extern ResultCache resultCache;
+
+int TableReader::readAheadDepth = TABLE_READ_AHEAD;
+
+//held while a writer publishes a change to a table file, and shared while
+//a statement takes its snapshots
+ReadWriteLock commitLock;
+
+thread_local StatementSnapshots * StatementSnapshots::current = NULL;
+
+/**
+ * @brief getTempPath
+ *
+ * @details returns the path a table file is rewritten to before it replaces
+ *          the table file, hidden so that it is not loaded as a table
+ *
+ * @param [in] string tableFilePath - full path to the table file
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getTempPath( string tableFilePath )
+{
+	size_t slash = tableFilePath.rfind( '/' );
+	if( slash == string::npos )
+	{
+		return "." + tableFilePath + ".tmp";
+	}
+	return tableFilePath.substr( 0, slash + 1 ) + "." + tableFilePath.substr( slash + 1 ) + ".tmp";
+}
+
+/**
+ * @brief getReadPath
+ *
+ * @details returns the file a table is read from: the private version of
+ *          the thread's transaction if it rewrote the table, otherwise the
+ *          table file
+ *
+ * @param [in] const string &tableFilePath
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getReadPath( const string &tableFilePath )
+{
+	Transaction * transaction = Transaction::active();
+	string versionPath = transaction != NULL ? transaction->versionOf( tableFilePath ) : "";
+	return versionPath.empty() ? tableFilePath : versionPath;
+}
+
+/**
+ * @brief appendBlock
+ *
+ * @details appends a block of lines to output, compressed with codec
+ *
+ * @par Algorithm a block that does not get smaller is stored with the none
+ *      codec instead, so no block is larger than its lines plus the header
+ *
+ * @param [in] Codec * codec
+ *
+ * @param [in] const string &raw - the lines, each followed by a newline
+ *
+ * @param [in] string &stored - buffer for the compressed bytes
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void appendBlock( Codec * codec, const string &raw, string &stored, string &output )
+{
+	unsigned char codecId = codec->id();
+	stored.clear();
+	codec->compress( raw.data(), raw.size(), stored );
+	if( stored.size() >= raw.size() && !raw.empty() )
+	{
+		codecId = CODEC_NONE;
+		stored = raw;
+	}
+
+	unsigned int sizes[ 2 ] = { (unsigned int) raw.size(), (unsigned int) stored.size() };
+	output += BLOCK_MARKER;
+	output += (char) codecId;
+	for( int index = 0; index < 2; index++ )
+	{
+		for( int shift = 0; shift < 32; shift += 8 )
+		{
+			output += (char) ( ( sizes[ index ] >> shift ) & 0xff );
+		}
+	}
+	output += stored;
+}
+
+/**
+ * @brief readBlockSize
+ *
+ * @details reads a 4 byte little endian size of a block header
+ *
+ * @param [in] const unsigned char * bytes
+ *
+ * @return size_t
+ *
+ * @note None
+ */
+size_t readBlockSize( const unsigned char * bytes )
+{
+	return bytes[ 0 ] | ( bytes[ 1 ] << 8 ) | ( bytes[ 2 ] << 16 ) | ( (size_t) bytes[ 3 ] << 24 );
+}
+
+/**
+ * @brief StatementSnapshots constructor
+ *
+ * @details the snapshots are used by the thread until they are destroyed
+ *
+ * @note None
+ */
+StatementSnapshots::StatementSnapshots()
+{
+	previous = current;
+	current = this;
+}
+
+StatementSnapshots::~StatementSnapshots()
+{
+	int snapshotSize = snapshots.size();
+	for( int index = 0; index < snapshotSize; index++ )
+	{
+		::close( snapshots[ index ].fd );
+	}
+	current = previous;
+}
+
+/**
+ * @brief StatementSnapshots take
+ *
+ * @details opens the current version of each table file
+ *
+ * @par Algorithm commitLock is held shared while the files are opened, so
+ *      no writer publishes a change between two of them
+ *
+ * @param [in] const vector< string > &filePaths - full paths to the table
+ *             files
+ *
+ * @return None
+ *
+ * @note a file that cannot be opened gets no snapshot and is read as it is.
+ *       A table the thread's transaction rewrote is its private version
+ */
+void StatementSnapshots::take( const vector< string > &filePaths )
+{
+	ReadWriteGuard commits( commitLock, false );
+	int pathSize = filePaths.size();
+	for( int index = 0; index < pathSize; index++ )
+	{
+		struct stat fileInfo;
+		TableSnapshot snapshot;
+		snapshot.filePath = filePaths[ index ];
+		snapshot.fd = ::open( getReadPath( snapshot.filePath ).c_str(), O_RDONLY );
+		if( snapshot.fd < 0 || find( snapshot.filePath ) != NULL || fstat( snapshot.fd, &fileInfo ) != 0 )
+		{
+			if( snapshot.fd >= 0 )
+			{
+				::close( snapshot.fd );
+			}
+			continue;
+		}
+		snapshot.size = fileInfo.st_size;
+		snapshots.push_back( snapshot );
+	}
+}
+
+/**
+ * @brief StatementSnapshots find
+ *
+ * @details returns the snapshot of a table file taken by the thread's
+ *          statement
+ *
+ * @param [in] const string &filePath
+ *
+ * @return const TableSnapshot * NULL if the file has no snapshot
+ *
+ * @note None
+ */
+const TableSnapshot * StatementSnapshots::find( const string &filePath )
+{
+	for( StatementSnapshots * set = current; set != NULL; set = set->previous )
+	{
+		int snapshotSize = set->snapshots.size();
+		for( int index = 0; index < snapshotSize; index++ )
+		{
+			if( set->snapshots[ index ].filePath == filePath )
+			{
+				return &set->snapshots[ index ];
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief TableReader constructor
+ *
+ * @note None
+ */
+TableReader::TableReader() : buffer( TABLE_HEADER_READ_SIZE )
+{
+	codec = CODEC_NONE;
+	bytesRead = 0;
+	fd = -1;
+	ownsFd = false;
+	filePosition = 0;
+	fileLimit = 0;
+	bufferStart = 0;
+	bufferEnd = 0;
+	blockPosition = 0;
+	pendingLines = NULL;
+	pendingPosition = 0;
+	cached = false;
+	admitsPages = false;
+	aheadFirst = 0;
+	aheadCount = 0;
+	nextRead = 0;
+	aheadWindow = 1;
+	aheadDepth = readAheadDepth;
+}
+
+TableReader::~TableReader()
+{
+	close();
+}
+
+/**
+ * @brief TableReader open
+ *
+ * @details opens a table file and reads its attribute line and codec. The
+ *          table is read through the snapshot of the thread's statement if
+ *          it has one, otherwise as the file is now
+ *
+ * @param [in] string tableFilePath
+ *
+ * @param [out] string &attributeLine
+ *
+ * @return bool false if the file could not be opened
+ *
+ * @note None
+ */
+bool TableReader::open( string tableFilePath, string &attributeLine )
+{
+	const TableSnapshot * snapshot = StatementSnapshots::find( tableFilePath );
+	if( snapshot != NULL )
+	{
+		return open( *snapshot, attributeLine );
+	}
+
+	struct stat fileInfo;
+	close();
+	filePath = tableFilePath;
+	attributeLine.clear();
+	fd = ::open( getReadPath( filePath ).c_str(), O_RDONLY );
+	ownsFd = true;
+	if( fd < 0 || fstat( fd, &fileInfo ) != 0 )
+	{
+		return false;
+	}
+	fileLimit = fileInfo.st_size;
+	return start( attributeLine );
+}
+
+/**
+ * @brief TableReader open
+ *
+ * @details opens a snapshot of a table file, the snapshot keeps its file
+ *
+ * @param [in] const TableSnapshot &snapshot
+ *
+ * @param [out] string &attributeLine
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool TableReader::open( const TableSnapshot &snapshot, string &attributeLine )
+{
+	close();
+	filePath = snapshot.filePath;
+	fd = snapshot.fd;
+	ownsFd = false;
+	fileLimit = snapshot.size;
+	return start( attributeLine );
+}
+
+/**
+ * @brief TableReader start
+ *
+ * @details reads the attribute line, then the empty first block of a
+ *          compressed table
+ *
+ * @param [out] string &attributeLine
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool TableReader::start( string &attributeLine )
+{
+	codec = CODEC_NONE;
+	bytesRead = 0;
+	filePosition = 0;
+	nextRead = 0;
+	aheadWindow = 1;
+	aheadDepth = readAheadDepth;
+	//a scan of more pages than the cache keeps for pages read once would
+	//push out the pages of every other table, it only reads through its
+	//own buffers
+	cached = PageCache::getFileVersion( fd, version );
+	admitsPages = cached && ( fileLimit + (long long) TABLE_READ_SIZE - 1 ) / (long long) TABLE_READ_SIZE <= (long long) pageCache.scanLimit();
+	bufferStart = 0;
+	bufferEnd = 0;
+	block.clear();
+	blockPosition = 0;
+	Transaction * transaction = Transaction::active();
+	pendingLines = transaction != NULL ? transaction->pendingLines( filePath ) : NULL;
+	pendingPosition = 0;
+
+	attributeLine.clear();
+	if( !readText( attributeLine ) )
+	{
+		return true;
+	}
+	bytesRead += attributeLine.size() + 1;
+
+	if( peekByte() == BLOCK_MARKER )
+	{
+		readBlock();
+	}
+	return true;
+}
+
+/**
+ * @brief TableReader readLine
+ *
+ * @details reads the next record
+ *
+ * @par Algorithm lines are taken from the current block until it is used
+ *      up, then the next block is read and decompressed. Plain lines (a
+ *      plain table, or records appended to a compressed one) are read as
+ *      they are. Empty lines are skipped. The records buffered by the
+ *      thread's transaction come last
+ *
+ * @param [out] string &line
+ *
+ * @return bool false at the end of the file or at a corrupt block
+ *
+ * @note None
+ */
+bool TableReader::readLine( string &line )
+{
+	while( true )
+	{
+		if( blockPosition < block.size() )
+		{
+			size_t end = block.find( '\n', blockPosition );
+			if( end == string::npos )
+			{
+				end = block.size();
+			}
+			line.assign( block, blockPosition, end - blockPosition );
+			blockPosition = end + 1;
+			if( !line.empty() )
+			{
+				return true;
+			}
+			continue;
+		}
+
+		int next = peekByte();
+		if( next == EOF )
+		{
+			if( pendingLines == NULL || pendingPosition >= pendingLines->size() )
+			{
+				return false;
+			}
+			line = ( *pendingLines )[ pendingPosition++ ];
+			bytesRead += line.size() + 1;
+			return true;
+		}
+		if( next == BLOCK_MARKER )
+		{
+			if( !readBlock() )
+			{
+				return false;
+			}
+			continue;
+		}
+		if( !readText( line ) )
+		{
+			return false;
+		}
+		bytesRead += line.size() + 1;
+		if( !line.empty() )
+		{
+			return true;
+		}
+	}
+}
+
+/**
+ * @brief TableReader fill
+ *
+ * @details reads more of the file after the bytes not taken yet
+ *
+ * @par Algorithm the attribute line is read as it is needed, from the first
+ *      page if it is cached. The records are taken from reads of whole
+ *      pages submitted ahead of them, each used read is replaced by one
+ *      further on. The reads outstanding start at one and double with every
+ *      page taken, so a reader stopping early reads little it does not use
+ *
+ * @return bool false if there is nothing more to read
+ *
+ * @note None
+ */
+bool TableReader::fill()
+{
+	if( bufferStart > 0 )
+	{
+		memmove( &buffer[ 0 ], &buffer[ bufferStart ], bufferEnd - bufferStart );
+		bufferEnd -= bufferStart;
+		bufferStart = 0;
+	}
+	if( fd < 0 )
+	{
+		return false;
+	}
+
+	if( filePosition == 0 )
+	{
+		size_t pageSize = min( (long long) TABLE_READ_SIZE, fileLimit );
+		if( cached && pageSize > 0 )
+		{
+			buffer.resize( max( buffer.size(), bufferEnd + pageSize ) );
+			if( pageCache.find( version, 0, pageSize, &buffer[ bufferEnd ] ) )
+			{
+				bufferEnd += pageSize;
+				filePosition = pageSize;
+				nextRead = pageSize;
+				return true;
+			}
+		}
+
+		ssize_t count;
+		do
+		{
+			count = pread( fd, &buffer[ bufferEnd ], min( (long long) TABLE_HEADER_READ_SIZE, fileLimit ), 0 );
+		} while( count < 0 && errno == EINTR );
+		if( count <= 0 )
+		{
+			return false;
+		}
+		Metrics::count( METRIC_BYTES_READ, count );
+		if( admitsPages && (size_t) count == pageSize )
+		{
+			pageCache.add( version, 0, &buffer[ bufferEnd ], count );
+		}
+		bufferEnd += count;
+		filePosition = count;
+		//the first page is read again whole, unless this was all of it
+		nextRead = count < fileLimit ? 0 : count;
+		return true;
+	}
+
+	readAhead();
+	if( aheadCount == 0 )
+	{
+		return false;
+	}
+	int slot = aheadFirst;
+	IoRequest &request = ahead[ slot ];
+	if( !aheadFromCache[ slot ] )
+	{
+		IoQueue::forThread().wait( request );
+	}
+	aheadFirst = ( aheadFirst + 1 ) % aheadDepth;
+	aheadCount--;
+	long long skipped = filePosition - request.offset;
+	if( request.result <= skipped )
+	{
+		cancelReadAhead();
+		return false;
+	}
+
+	size_t count = request.result - skipped;
+	//a line longer than the buffer makes it grow
+	if( buffer.size() < bufferEnd + count )
+	{
+		buffer.resize( max( buffer.size() * 2, bufferEnd + TABLE_READ_SIZE ) );
+	}
+	memcpy( &buffer[ bufferEnd ], request.data + skipped, count );
+	bufferEnd += count;
+	filePosition += count;
+	if( (size_t) request.result < request.size )
+	{
+		//the reads after it assumed a full one
+		cancelReadAhead();
+		nextRead = filePosition - filePosition % TABLE_READ_SIZE;
+	}
+	else if( admitsPages && !aheadFromCache[ slot ] )
+	{
+		pageCache.add( version, request.offset / TABLE_READ_SIZE, request.data, request.size );
+	}
+	aheadWindow = min( aheadWindow * 2, aheadDepth );
+	readAhead();
+	return true;
+}
+
+/**
+ * @brief TableReader readAhead
+ *
+ * @details submits reads of the pages of the version being read until
+ *          aheadWindow are outstanding. A page found in the cache is copied
+ *          instead
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableReader::readAhead()
+{
+	if( (int) aheadData.size() < aheadDepth )
+	{
+		aheadData.resize( aheadDepth );
+	}
+	while( aheadCount < aheadWindow && nextRead < fileLimit )
+	{
+		int slot = ( aheadFirst + aheadCount ) % aheadDepth;
+		if( aheadData[ slot ].empty() )
+		{
+			aheadData[ slot ].resize( TABLE_READ_SIZE );
+		}
+		IoRequest &request = ahead[ slot ];
+		request.operation = IO_READ;
+		request.fd = fd;
+		request.data = &aheadData[ slot ][ 0 ];
+		request.offset = nextRead - nextRead % TABLE_READ_SIZE;
+		request.size = min( (long long) TABLE_READ_SIZE, fileLimit - request.offset );
+		aheadFromCache[ slot ] = cached &&
+			pageCache.find( version, request.offset / TABLE_READ_SIZE, request.size, request.data );
+		if( aheadFromCache[ slot ] )
+		{
+			request.result = request.size;
+			request.done = true;
+		}
+		else
+		{
+			IoQueue::forThread().submit( request );
+		}
+		nextRead = request.offset + request.size;
+		aheadCount++;
+	}
+}
+
+/**
+ * @brief TableReader cancelReadAhead
+ *
+ * @details waits for the outstanding reads and drops them
+ *
+ * @return None
+ *
+ * @note their buffers and the file must outlive them
+ */
+void TableReader::cancelReadAhead()
+{
+	while( aheadCount > 0 )
+	{
+		if( !aheadFromCache[ aheadFirst ] )
+		{
+			IoQueue::forThread().wait( ahead[ aheadFirst ] );
+		}
+		aheadFirst = ( aheadFirst + 1 ) % aheadDepth;
+		aheadCount--;
+	}
+	aheadFirst = 0;
+}
+
+/**
+ * @brief TableReader setReadAhead
+ *
+ * @details sets how many reads a scan keeps outstanding once it is reading
+ *          in sequence, for the readers opened from now on
+ *
+ * @param [in] int pages - from 1 to TABLE_READ_AHEAD_LIMIT
+ *
+ * @return None
+ *
+ * @note called before any session starts
+ */
+void TableReader::setReadAhead( int pages )
+{
+	readAheadDepth = max( 1, min( pages, TABLE_READ_AHEAD_LIMIT ) );
+}
+
+int TableReader::peekByte()
+{
+	if( bufferStart == bufferEnd && !fill() )
+	{
+		return EOF;
+	}
+	return (unsigned char) buffer[ bufferStart ];
+}
+
+/**
+ * @brief TableReader readText
+ *
+ * @details reads up to the next newline, which is skipped
+ *
+ * @param [out] string &line
+ *
+ * @return bool false if there was nothing left to read
+ *
+ * @note None
+ */
+bool TableReader::readText( string &line )
+{
+	size_t searched = bufferStart;
+	while( true )
+	{
+		char * end = (char *) memchr( &buffer[ 0 ] + searched, '\n', bufferEnd - searched );
+		if( end != NULL )
+		{
+			size_t newline = end - &buffer[ 0 ];
+			line.assign( &buffer[ bufferStart ], newline - bufferStart );
+			bufferStart = newline + 1;
+			return true;
+		}
+
+		searched = bufferEnd - bufferStart;
+		if( !fill() )
+		{
+			if( bufferStart == bufferEnd )
+			{
+				return false;
+			}
+			line.assign( &buffer[ bufferStart ], bufferEnd - bufferStart );
+			bufferStart = bufferEnd;
+			return true;
+		}
+	}
+}
+
+/**
+ * @brief TableReader readBytes
+ *
+ * @details reads the next bytes of the file
+ *
+ * @param [out] char * data
+ *
+ * @param [in] size_t size
+ *
+ * @return bool false if the file ends first
+ *
+ * @note None
+ */
+bool TableReader::readBytes( char * data, size_t size )
+{
+	while( size > 0 )
+	{
+		if( bufferStart == bufferEnd && !fill() )
+		{
+			return false;
+		}
+		size_t count = min( size, bufferEnd - bufferStart );
+		memcpy( data, &buffer[ bufferStart ], count );
+		bufferStart += count;
+		data += count;
+		size -= count;
+	}
+	return true;
+}
+
+/**
+ * @brief TableReader readBlock
+ *
+ * @details reads and decompresses the block at the read position. Only the
+ *          first block of a table is empty, its codec is the table's codec
+ *
+ * @return bool false if the block is corrupt
+ *
+ * @note None
+ */
+bool TableReader::readBlock()
+{
+	unsigned char header[ BLOCK_HEADER_SIZE ];
+	bool valid = readBytes( (char *) header, BLOCK_HEADER_SIZE );
+	size_t rawSize = readBlockSize( header + 2 );
+	size_t storedSize = readBlockSize( header + 6 );
+	Codec * blockCodec = findCodec( header[ 1 ] );
+	valid = valid && blockCodec != NULL && (long long) storedSize <= fileLimit;
+
+	if( valid )
+	{
+		stored.resize( storedSize );
+		valid = readBytes( &stored[ 0 ], storedSize ) &&
+			blockCodec->decompress( stored.data(), storedSize, rawSize, block );
+	}
+	bytesRead += BLOCK_HEADER_SIZE + storedSize;
+	blockPosition = 0;
+	if( !valid )
+	{
+		//nothing more is read from the file
+		block.clear();
+		bufferStart = bufferEnd;
+		fileLimit = filePosition;
+		cout << "-- !Failed to read " << filePath << " past a corrupt block." << endl;
+		return false;
+	}
+	if( rawSize == 0 )
+	{
+		codec = header[ 1 ];
+	}
+	return true;
+}
+
+void TableReader::close()
+{
+	cancelReadAhead();
+	if( ownsFd && fd >= 0 )
+	{
+		::close( fd );
+	}
+	fd = -1;
+	ownsFd = false;
+	bufferStart = 0;
+	bufferEnd = 0;
+	block.clear();
+	blockPosition = 0;
+	pendingLines = NULL;
+}
+
+/**
+ * @brief TableWriter constructor
+ *
+ * @note None
+ */
+TableWriter::TableWriter()
+{
+	fd = -1;
+	failed = false;
+	codec = NULL;
+	fileSize = 0;
+	behindFirst = 0;
+	behindCount = 0;
+}
+
+TableWriter::~TableWriter()
+{
+	if( fd >= 0 )
+	{
+		close();
+	}
+}
+
+/**
+ * @brief TableWriter open
+ *
+ * @details creates a table file holding only its attribute line
+ *
+ * @param [in] string tableFilePath - usually a temporary path that replaces
+ *             the table file once it is written
+ *
+ * @param [in] unsigned char tableCodec
+ *
+ * @param [in] const string &attributeLine
+ *
+ * @return bool false if the file could not be created
+ *
+ * @note None
+ */
+bool TableWriter::open( string tableFilePath, unsigned char tableCodec, const string &attributeLine )
+{
+	codec = findCodec( tableCodec );
+	if( codec == NULL )
+	{
+		codec = findCodec( CODEC_NONE );
+	}
+	block.clear();
+	fileSize = 0;
+	failed = false;
+
+	fd = ::open( tableFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	output = attributeLine;
+	if( codec->id() != CODEC_NONE )
+	{
+		output += "\n";
+		appendBlock( codec, block, stored, output );
+	}
+	return fd >= 0;
+}
+
+/**
+ * @brief TableWriter writeLine
+ *
+ * @details writes a record, a compressed table keeps it until a block is
+ *          full
+ *
+ * @param [in] const string &line
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableWriter::writeLine( const string &line )
+{
+	if( codec->id() == CODEC_NONE )
+	{
+		output += "\n";
+		output += line;
+		if( output.size() >= TABLE_READ_SIZE )
+		{
+			writeOutput();
+		}
+		return;
+	}
+
+	block += line;
+	block += '\n';
+	if( block.size() >= TABLE_BLOCK_SIZE )
+	{
+		writeBlock();
+	}
+}
+
+/**
+ * @brief TableWriter writeBlock
+ *
+ * @details compresses the lines kept so far
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableWriter::writeBlock()
+{
+	appendBlock( codec, block, stored, output );
+	block.clear();
+	if( output.size() >= TABLE_READ_SIZE )
+	{
+		writeOutput();
+	}
+}
+
+/**
+ * @brief TableWriter writeOutput
+ *
+ * @details submits a write of the bytes made so far without waiting for
+ *          it, unless TABLE_WRITE_BEHIND writes are outstanding already
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableWriter::writeOutput()
+{
+	if( fd < 0 || output.empty() )
+	{
+		return;
+	}
+	if( behindCount == TABLE_WRITE_BEHIND )
+	{
+		waitWrite();
+	}
+
+	int slot = ( behindFirst + behindCount ) % TABLE_WRITE_BEHIND;
+	behindData[ slot ].swap( output );
+	output.clear();
+	IoRequest &request = behind[ slot ];
+	request.operation = IO_WRITE;
+	request.fd = fd;
+	request.data = &behindData[ slot ][ 0 ];
+	request.size = behindData[ slot ].size();
+	request.offset = fileSize;
+	IoQueue::forThread().submit( request );
+	fileSize += request.size;
+	behindCount++;
+}
+
+/**
+ * @brief TableWriter waitWrite
+ *
+ * @details waits for the oldest outstanding write
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableWriter::waitWrite()
+{
+	IoRequest &request = behind[ behindFirst ];
+	long long size = request.size;
+	IoQueue::forThread().wait( request );
+	failed = failed || request.result != size;
+	behindFirst = ( behindFirst + 1 ) % TABLE_WRITE_BEHIND;
+	behindCount--;
+}
+
+/**
+ * @brief TableWriter close
+ *
+ * @details writes the last block, waits for the writes and closes the file
+ *
+ * @return bool false if the file could not be written
+ *
+ * @note None
+ */
+bool TableWriter::close()
+{
+	if( !block.empty() )
+	{
+		appendBlock( codec, block, stored, output );
+		block.clear();
+	}
+	writeOutput();
+	while( behindCount > 0 )
+	{
+		waitWrite();
+	}
+	bool closed = fd >= 0 && ::close( fd ) == 0;
+	fd = -1;
+	return closed && !failed;
+}
+
+/**
+ * @brief getTableCodec
+ *
+ * @details returns the codec of a table file
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @return unsigned char CODEC_NONE for a plain table
+ *
+ * @note None
+ */
+unsigned char getTableCodec( string filePath )
+{
+	TableReader reader;
+	string attributeLine;
+	reader.open( filePath, attributeLine );
+	reader.close();
+	return reader.codec;
+}
+
+/**
+ * @brief publishTable
+ *
+ * @details replaces a table file with the new version written to
+ *          tempFilePath
+ *
+ * @par Algorithm the rename holds commitLock, readers that opened the old
+ *      version keep reading it. Inside a transaction the new version is
+ *      only the transaction's until it commits. Results cached from the
+ *      old version are no longer used
+ *
+ * @param [in] string tempFilePath
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool publishTable( string tempFilePath, string filePath )
+{
+	Transaction * transaction = Transaction::active();
+	if( transaction != NULL )
+	{
+		return transaction->publish( tempFilePath, filePath );
+	}
+
+	ReadWriteGuard commits( commitLock, true );
+	if( rename( tempFilePath.c_str(), filePath.c_str() ) != 0 )
+	{
+		return false;
+	}
+	resultCache.changed( filePath );
+	return true;
+}
+
+/**
+ * @brief appendTableLine
+ *
+ * @details appends a record to a table file, or buffers it in the thread's
+ *          transaction
+ *
+ * @par Algorithm the record is appended as a plain line while holding
+ *      commitLock, so a snapshot has either all of it or none, then the
+ *      table is compacted if its plain lines have grown enough
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @param [in] const string &line
+ *
+ * @return bool false if the record could not be written
+ *
+ * @note None
+ */
+bool appendTableLine( string filePath, const string &line )
+{
+	Transaction * transaction = Transaction::active();
+	if( transaction != NULL )
+	{
+		transaction->appendLine( filePath, line );
+		return true;
+	}
+
+	bool appended;
+	{
+		ReadWriteGuard commits( commitLock, true );
+		appended = appendTableText( filePath, "\n" + line );
+		resultCache.changed( filePath );
+	}
+	if( appended )
+	{
+		compactTable( filePath );
+	}
+	return appended;
+}
+
+/**
+ * @brief appendTableText
+ *
+ * @details appends newline separated records to a table file
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @param [in] const string &text
+ *
+ * @return bool
+ *
+ * @note the caller holds commitLock
+ */
+bool appendTableText( string filePath, const string &text )
+{
+	ofstream fout( filePath.c_str(), ofstream::out | ofstream::app | ofstream::binary );
+	fout << text;
+	fout.close();
+	Metrics::count( METRIC_BYTES_WRITTEN, text.size() );
+	return !fout.fail();
+}
+
+/**
+ * @brief compactTable
+ *
+ * @details compresses the plain lines appended to a compressed table once
+ *          there are enough of them
+ *
+ * @par Algorithm the block headers are walked to find where the plain
+ *      lines start. Once they are a block and 1/TAIL_COMPACT_RATIO of the
+ *      blocks before them, a new version of the file is written: the blocks
+ *      copied as they are, then the plain lines compressed into blocks.
+ *      Copying only that often keeps the copying in proportion to the
+ *      records inserted
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void compactTable( string filePath )
+{
+	ofstream fout;
+	ifstream fin( filePath.c_str(), ifstream::in | ifstream::binary );
+	string attributeLine;
+	unsigned char header[ BLOCK_HEADER_SIZE ];
+	unsigned char codecId = CODEC_NONE;
+	getline( fin, attributeLine );
+	while( fin.peek() == BLOCK_MARKER )
+	{
+		fin.read( (char *) header, BLOCK_HEADER_SIZE );
+		if( codecId == CODEC_NONE )
+		{
+			codecId = header[ 1 ];
+		}
+		fin.seekg( readBlockSize( header + 6 ), ifstream::cur );
+	}
+	long long tailStart = fin.tellg();
+	fin.seekg( 0, ifstream::end );
+	long long fileSize = fin.tellg();
+	long long tailSize = fileSize - tailStart;
+	Codec * codec = findCodec( codecId );
+	if( codecId == CODEC_NONE || codec == NULL || tailStart < 0 || tailSize < (long long) TABLE_BLOCK_SIZE ||
+		tailSize * TAIL_COMPACT_RATIO < tailStart )
+	{
+		return;
+	}
+
+	//the blocks are copied to the new version as they are
+	string tempFilePath = getTempPath( filePath );
+	string copied( TABLE_READ_SIZE, '\0' );
+	fout.open( tempFilePath.c_str(), ofstream::out | ofstream::trunc | ofstream::binary );
+	fin.seekg( 0 );
+	for( long long position = 0; position < tailStart; position += copied.size() )
+	{
+		copied.resize( min( (long long) TABLE_READ_SIZE, tailStart - position ) );
+		fin.read( &copied[ 0 ], copied.size() );
+		fout.write( copied.data(), copied.size() );
+	}
+
+	string tail( tailSize, '\0' );
+	fin.read( &tail[ 0 ], tail.size() );
+	fin.close();
+
+	//the plain lines start with the newline before the first of them
+	string raw;
+	string stored;
+	string output;
+	size_t start = 0;
+	while( start < tail.size() )
+	{
+		size_t end = tail.find( '\n', start );
+		if( end == string::npos )
+		{
+			end = tail.size();
+		}
+		if( end > start )
+		{
+			raw.append( tail, start, end - start );
+			raw += '\n';
+		}
+		start = end + 1;
+		if( raw.size() >= TABLE_BLOCK_SIZE || ( start >= tail.size() && !raw.empty() ) )
+		{
+			appendBlock( codec, raw, stored, output );
+			raw.clear();
+		}
+	}
+	fout << output;
+	fout.close();
+
+	//the records are in the table either way
+	if( fout.fail() || !publishTable( tempFilePath, filePath ) )
+	{
+		remove( tempFilePath.c_str() );
+	}
+}
+
+/**
+ * @brief rewriteTable
+ *
+ * @details rewrites a table file with another codec
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @param [in] unsigned char tableCodec
+ *
+ * @return bool false if the table could not be rewritten, it is then left
+ *         as it was
+ *
+ * @note None
+ */
+bool rewriteTable( string filePath, unsigned char tableCodec )
+{
+	TableReader reader;
+	TableWriter writer;
+	string line;
+	string tempFilePath = getTempPath( filePath );
+
+	if( !reader.open( filePath, line ) || !writer.open( tempFilePath, tableCodec, line ) )
+	{
+		return false;
+	}
+	while( reader.readLine( line ) )
+	{
+		writer.writeLine( line );
+	}
+	reader.close();
+	if( !writer.close() )
+	{
+		remove( tempFilePath.c_str() );
+		return false;
+	}
+	return publishTable( tempFilePath, filePath );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,194 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Storage.h
+ *
+ * @brief Definition file for the storage layer of table files
+ *
+ * @details Specifies how records are read from and written to a table file.
+ *          The attribute line is always plain text. The records follow
+ *          either as plain lines, or as blocks of about TABLE_BLOCK_SIZE
+ *          bytes of lines compressed with the table's codec. Records
+ *          inserted into a compressed table are appended as plain lines and
+ *          compressed into blocks once they fill one
+ *
+ *          A block is BLOCK_MARKER, the codec id, the raw size and the
+ *          stored size (4 bytes each, little endian) then the stored bytes.
+ *          A compressed table starts with an empty block of its codec, so
+ *          its codec is known even before it holds a record
+ *
+ *          A table file is never changed where it may be read: records are
+ *          only appended, anything else writes a new file that replaces the
+ *          table file. A reader therefore keeps a consistent version, a
+ *          snapshot, by keeping the file it opened and reading only up to
+ *          the size it had then. Writers publish their changes while
+ *          holding commitLock, so the snapshots a statement takes together
+ *          all show the same commits
+ *
+ *          Inside a transaction a table is read from its private version
+ *          if it has one, followed by the records the transaction buffered
+ *          for it (see Transaction.h)
+ *
+ *          Records are read and written through the thread's IoQueue (see
+ *          Io.h) with several requests outstanding, so the device works on
+ *          the next reads or the last writes while records are processed
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include "Codec.h"
+#include "Lock.h"
+#include "Transaction.h"
+#include "Io.h"
+#include "PageCache.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef STORAGE_H
+#define STORAGE_H
+
+//raw bytes of lines compressed together
+const size_t TABLE_BLOCK_SIZE = 65536;
+//first byte of a block, never the first byte of a record
+const char BLOCK_MARKER = '\0';
+const int BLOCK_HEADER_SIZE = 10;
+//codec of new tables
+const unsigned char DEFAULT_TABLE_CODEC = CODEC_LZ;
+//bytes read from a table file at once
+const size_t TABLE_READ_SIZE = 1 << 16;
+//bytes read first, enough for the attribute line of most tables. A reader
+//that only wants the attributes, such as an insert, reads no more
+const size_t TABLE_HEADER_READ_SIZE = 1 << 12;
+//reads of TABLE_READ_SIZE a scan keeps outstanding ahead of the records it
+//takes unless --read-ahead is given, and the most it can be set to. Writes a
+//writer keeps outstanding behind the ones it makes
+const int TABLE_READ_AHEAD = 4;
+const int TABLE_READ_AHEAD_LIMIT = 32;
+const int TABLE_WRITE_BEHIND = 4;
+//the plain records appended to a compressed table are compressed once they
+//are a block and at least this fraction of the blocks before them
+const int TAIL_COMPACT_RATIO = 8;
+
+//a version of a table file
+struct TableSnapshot{
+	string filePath;
+	int fd;
+	long long size;
+};
+
+//snapshots of the tables a statement reads, taken together. Table files
+//opened while it exists are read through its snapshots
+class StatementSnapshots{
+	public:
+		StatementSnapshots();
+		~StatementSnapshots();
+		void take( const vector< string > &filePaths );
+		static const TableSnapshot * find( const string &filePath );
+
+	private:
+		vector< TableSnapshot > snapshots;
+		StatementSnapshots * previous;
+		static thread_local StatementSnapshots * current;
+
+		StatementSnapshots( const StatementSnapshots &other );
+		StatementSnapshots &operator=( const StatementSnapshots &other );
+};
+
+class TableReader{
+	public:
+		string filePath;
+		//codec of the table, CODEC_NONE for a plain table
+		unsigned char codec;
+		//bytes of the file read so far, compressed bytes for blocks
+		long long bytesRead;
+
+		TableReader();
+		~TableReader();
+		bool open( string tableFilePath, string &attributeLine );
+		bool open( const TableSnapshot &snapshot, string &attributeLine );
+		bool readLine( string &line );
+		void close();
+		static void setReadAhead( int pages );
+
+	private:
+		int fd;
+		bool ownsFd;
+		//offset of the next read and the end of the version being read
+		long long filePosition;
+		long long fileLimit;
+		//bytes read ahead of the records taken from them
+		vector< char > buffer;
+		size_t bufferStart;
+		size_t bufferEnd;
+		//lines of the current block and where the next one starts
+		string block;
+		size_t blockPosition;
+		string stored;
+		//records of the thread's transaction read after the file
+		const vector< string > * pendingLines;
+		size_t pendingPosition;
+		//version of the file in the page cache, and whether the pages read
+		//are added to it
+		FileVersion version;
+		bool cached;
+		bool admitsPages;
+		//reads of whole pages outstanding from aheadFirst on, those copied
+		//from the cache, and the offset of the next
+		IoRequest ahead[ TABLE_READ_AHEAD_LIMIT ];
+		bool aheadFromCache[ TABLE_READ_AHEAD_LIMIT ];
+		vector< vector< char > > aheadData;
+		int aheadFirst;
+		int aheadCount;
+		long long nextRead;
+		//reads kept outstanding, doubled by every page read in sequence
+		//up to aheadDepth
+		int aheadWindow;
+		int aheadDepth;
+		static int readAheadDepth;
+
+		TableReader( const TableReader &other );
+		TableReader &operator=( const TableReader &other );
+		bool start( string &attributeLine );
+		bool fill();
+		int peekByte();
+		bool readText( string &line );
+		bool readBytes( char * data, size_t size );
+		bool readBlock();
+		void readAhead();
+		void cancelReadAhead();
+};
+
+class TableWriter{
+	public:
+		TableWriter();
+		~TableWriter();
+		bool open( string tableFilePath, unsigned char tableCodec, const string &attributeLine );
+		void writeLine( const string &line );
+		bool close();
+
+	private:
+		int fd;
+		bool failed;
+		Codec * codec;
+		//lines not written yet, one block's worth for a compressed table
+		string block;
+		string stored;
+		//bytes not submitted yet, and the writes outstanding from behindFirst
+		string output;
+		long long fileSize;
+		IoRequest behind[ TABLE_WRITE_BEHIND ];
+		string behindData[ TABLE_WRITE_BEHIND ];
+		int behindFirst;
+		int behindCount;
+
+		void writeBlock();
+		void writeOutput();
+		void waitWrite();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -15,10 +15,24 @@
 #include <string>
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
 #include <unistd.h>
 #include "Table.h"
+#include "Dictionary.h"
+#include "Codec.h"
+#include "Storage.h"
+#include "Row.h"
+#include "Predicate.h"
+#include "Operator.h"
+#include "Planner.h"
+#include "Statistics.h"
+#include "ResultWriter.h"
+#include "Metrics.h"
+#include "SlowQueryLog.h"
+#include "ResultCache.h"
 
 using namespace std;
 
@@ -33,11 +47,44 @@ struct AttributeSubset{
 	int attributeIndex;
 };
 
-int findAttrOccur( vector< Attribute > attributes, string attrName );
-void getWhereCondition( WhereCondition &wCond, string whereType, vector< Attribute > attributes );
-void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > attributes );
-bool currIndexIsSubset( vector< AttributeSubset > attrSubsets, int indexVal );
-bool indexExists( int i, vector< int > indexCounter );
+int findAttrOccur( vector< Attribute > &attributes, string attrName );
+void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > &attributes );
+bool currIndexIsSubset( vector< AttributeSubset > &attrSubsets, int indexVal );
+bool indexExists( int i, vector< int > &indexCounter );
+string conditionText( PredicateNode * node );
+Operator * profileOperator( Operator * op, bool profile, vector< Operator * > &owned );
+void deleteOperators( vector< Operator * > &owned );
+void explainOperator( Operator * op, int depth, bool analyze );
+string summarizePlan( Operator * op );
+string getTempPath( string tableFilePath );
+string getDictionaryPath( string tableFilePath );
+bool publishTable( string tempFilePath, string filePath );
+bool appendTableLine( string filePath, const string &line );
+bool rewriteTable( string filePath, unsigned char tableCodec );
+Codec * findCodec( string codecName );
+bool isNullText( const char * data, size_t length );
+string getViewPath( string currentWorkingDirectory, string currentDatabase, string viewName );
+extern ResultCache resultCache;
+/**
+ * @brief notePlanIfSlow
+ *
+ * @details keeps the plan of a query that ran long enough to be logged,
+ *          the operators are freed before the statement ends
+ *
+ * @param [in] Operator * root
+ *
+ * @return None
+ *
+ * @note None
+ */
+void notePlanIfSlow( Operator * root )
+{
+	if( SlowQueryLog::isSlow( StatementClock::runningSeconds() ) )
+	{
+		StatementClock::setPlan( summarizePlan( root ) );
+	}
+}
+
 /**
  * @brief getCommaCount
  *
@@ -199,6 +246,266 @@ void removeLeadingWS( string &input )
 }
 
 
+/**
+ * @brief getAttributeLine
+ *
+ * @details formats attributes the way they are stored on the first line of
+ *          a table file
+ *
+ * @param [in] vector< Attribute > &attributes
+ *      
+ * @return string
+ *
+ * @note None
+ */
+string getAttributeLine( vector< Attribute > &attributes )
+{
+	string attributeLine;
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		attributeLine += attributes[ index ].attributeName + " " + attributes[ index ].attributeType;
+		if( index != attrSize - 1 )
+		{
+			attributeLine += '\t';
+		}
+	}
+	return attributeLine;
+}
+
+/**
+ * @brief getTupleText
+ *
+ * @details formats a tuple as a record with its encoded values decoded, the
+ *          way a table without dictionaries stores it
+ *
+ * @param [in] Row &tuple
+ *      
+ * @return string
+ *
+ * @note None
+ */
+string getTupleText( Row &tuple )
+{
+	string tupleText;
+	int tupleSize = tuple.size();
+	for( int index = 0; index < tupleSize; index++ )
+	{
+		tuple.appendText( index, tupleText );
+		if( index != tupleSize - 1 )
+		{
+			tupleText += '\t';
+		}
+	}
+	return tupleText;
+}
+
+/**
+ * @brief encodeValues
+ *
+ * @details replaces the values of the encoded attributes of a record with
+ *          their codes, adding new values to the dictionaries first
+ *
+ * @param [in] TableScan &scan - of the table the record is stored in
+ *
+ * @param [in/out] vector< string > &values
+ *      
+ * @return bool true if a dictionary changed and must be saved
+ *
+ * @note None
+ */
+bool encodeValues( TableScan &scan, vector< string > &values )
+{
+	bool dictionaryChanged = false;
+	int valueSize = values.size();
+	for( int index = 0; index < valueSize; index++ )
+	{
+		Dictionary * dictionary = NULL;
+		if( index < scan.columnCount && scan.attributes[ index ].dictionary != NULL )
+		{
+			dictionary = scan.dictionary.find( scan.attributes[ index ].attributeName );
+		}
+		if( dictionary != NULL && !isNullText( values[ index ].data(), values[ index ].size() ) )
+		{
+			int valueCount = dictionary->values.size();
+			stringstream code;
+			code << dictionary->add( values[ index ] );
+			dictionaryChanged = dictionaryChanged || (int) dictionary->values.size() != valueCount;
+			values[ index ] = code.str();
+		}
+	}
+	return dictionaryChanged;
+}
+
+/**
+ * @brief getTupleLine
+ *
+ * @details formats a tuple the way records are stored in a table file
+ *
+ * @param [in] Row &tuple
+ *      
+ * @return string
+ *
+ * @note None
+ */
+string getTupleLine( Row &tuple )
+{
+	string tupleLine;
+	int tupleSize = tuple.size();
+	for( int index = 0; index < tupleSize; index++ )
+	{
+		tuple.appendStored( index, tupleLine );
+		if( index != tupleSize - 1 )
+		{
+			tupleLine += '\t';
+		}
+	}
+	return tupleLine;
+}
+
+/**
+ * @brief getStatisticsPath
+ *
+ * @details returns the path of the file holding a table's statistics, it
+ *          is hidden so that it is not loaded as a table
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] string tblName
+ *      
+ * @return string
+ *
+ * @note None
+ */
+string getStatisticsPath( string currentWorkingDirectory, string currentDatabase, string tblName )
+{
+	return currentWorkingDirectory + "/" + currentDatabase + "/." + tblName + ".stats";
+}
+
+/**
+ * @brief getAttributeStatistics
+ *
+ * @details looks up the statistics of each attribute
+ *
+ * @param [in] TableStatistics &statistics
+ *
+ * @param [in] vector< Attribute > &attributes
+ *      
+ * @return vector< AttributeStatistics * > NULL for attributes without
+ *         statistics
+ *
+ * @note None
+ */
+vector< AttributeStatistics * > getAttributeStatistics( TableStatistics &statistics, vector< Attribute > &attributes )
+{
+	vector< AttributeStatistics * > attributeStatistics;
+	int attrSize = attributes.size();
+	for( int index = 0; index < attrSize; index++ )
+	{
+		attributeStatistics.push_back( statistics.find( attributes[ index ].attributeName ) );
+	}
+	return attributeStatistics;
+}
+
+/**
+ * @brief encodeAttributes
+ *
+ * @details chooses the attributes of a table to dictionary encode from its
+ *          statistics and rewrites the table file with them encoded
+ *
+ * @par Algorithm a string attribute is encoded if it has at most
+ *      DICTIONARY_MAX_VALUES distinct values, each stored at least
+ *      DICTIONARY_MIN_REPEATS times on average. The table is rewritten only
+ *      if an attribute is or was encoded; every dictionary is rebuilt from
+ *      the values still stored, in the order they first appear, so values
+ *      left behind by updates and deletes are dropped. The dictionary file
+ *      is replaced just before the table file
+ *
+ * @param [in] string filePath - full path to the table file
+ *
+ * @param [in] TableStatistics &statistics - statistics of the table
+ *
+ * @return int the number of encoded attributes, -1 if the table could not
+ *         be rewritten
+ *
+ * @note None
+ */
+int encodeAttributes( string filePath, TableStatistics &statistics )
+{
+	Row tuple;
+	string line;
+	string tempFilePath;
+	TableScan scan( filePath );
+	TableDictionary encoded;
+	int attrSize = scan.attributes.size();
+
+	for( int index = 0; index < attrSize; index++ )
+	{
+		AttributeStatistics * attrStats = statistics.find( scan.attributes[ index ].attributeName );
+		if( scan.columnTypes[ index ] != VALUE_STRING || attrStats == NULL || attrStats->distinctCount < 1 )
+		{
+			continue;
+		}
+		double valueCount = statistics.rowCount * ( 1.0 - attrStats->nullFraction );
+		if( attrStats->distinctCount <= DICTIONARY_MAX_VALUES &&
+			attrStats->distinctCount * DICTIONARY_MIN_REPEATS <= valueCount )
+		{
+			Dictionary dictionary;
+			dictionary.attributeName = scan.attributes[ index ].attributeName;
+			encoded.dictionaries.push_back( dictionary );
+		}
+	}
+	if( encoded.dictionaries.empty() && scan.dictionary.dictionaries.empty() )
+	{
+		return 0;
+	}
+
+	vector< Dictionary * > targets( attrSize );
+	for( int index = 0; index < attrSize; index++ )
+	{
+		targets[ index ] = encoded.find( scan.attributes[ index ].attributeName );
+	}
+
+	tempFilePath = getTempPath( filePath );
+	TableWriter writer;
+	writer.open( tempFilePath, scan.codec, getAttributeLine( scan.attributes ) );
+	scan.open();
+	while( scan.next( tuple ) )
+	{
+		line.clear();
+		for( int index = 0; index < attrSize; index++ )
+		{
+			if( index > 0 )
+			{
+				line += '\t';
+			}
+			if( targets[ index ] == NULL || tuple.isNull( index ) )
+			{
+				tuple.appendText( index, line );
+				continue;
+			}
+
+			string value;
+			tuple.appendText( index, value );
+			stringstream code;
+			code << targets[ index ]->add( value );
+			line += code.str();
+		}
+		writer.writeLine( line );
+	}
+	scan.close();
+
+	if( !writer.close() || !encoded.save( getDictionaryPath( filePath ) ) )
+	{
+		remove( tempFilePath.c_str() );
+		return -1;
+	}
+	publishTable( tempFilePath, filePath );
+	return encoded.dictionaries.size();
+}
+
 /**
  * @brief attributeNameExists
  *
@@ -218,7 +525,7 @@ void removeLeadingWS( string &input )
  *
  * @note None
  */
-bool attributeNameExists( vector< Attribute > attributeTable, Attribute attr )
+bool attributeNameExists( vector< Attribute > &attributeTable, Attribute &attr )
 {
 	int size = attributeTable.size();
 	for( int index = 0; index < size; index++ )
@@ -356,6 +663,12 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 	fout << attr.attributeName << " ";
 	fout << attr.attributeType;
 	fout.close();
+	//new tables are compressed
+	if( DEFAULT_TABLE_CODEC != CODEC_NONE )
+	{
+		rewriteTable( currentWorkingDirectory + filePath, DEFAULT_TABLE_CODEC );
+	}
+	resultCache.changed( currentWorkingDirectory + filePath );
 
 	cout << "-- Table " << tblName << " created." << endl;
 }
@@ -382,6 +695,15 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 void Table::tableDrop( string currentWorkingDirectory, string dbName )
 {
 	system( ( "rm " + currentWorkingDirectory + "/" + dbName + "/" + tableName ).c_str() ) ;
+	remove( getStatisticsPath( currentWorkingDirectory, dbName, tableName ).c_str() );
+	remove( getDictionaryPath( currentWorkingDirectory + "/" + dbName + "/" + tableName ).c_str() );
+	remove( getViewPath( currentWorkingDirectory, dbName, tableName ).c_str() );
+	resultCache.changed( currentWorkingDirectory + "/" + dbName + "/" + tableName );
+	if( !viewQuery.empty() )
+	{
+		cout << "-- Materialized view " << tableName << " deleted." << endl;
+		return;
+	}
 	cout << "-- Table " << tableName << " deleted." << endl;
 }
 
@@ -389,7 +711,8 @@ void Table::tableDrop( string currentWorkingDirectory, string dbName )
 /**
  * @brief tableAlter method 
  *
- * @details used to add attributes to a specified table
+ * @details used to add attributes to a specified table, or with SET
+ *          COMPRESSION to change the codec its records are stored with
  *          
  * @pre assumes table exists and attribute name and type are specified
  *
@@ -422,33 +745,29 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 	int newNumOfAttr = 0;
 	//create filepath  to read from file
 	string filePath = "/" + currentDatabase + "/" + tableName;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
+	TableReader reader;
+	TableWriter writer;
 
 	string action = getNextWord( input );
 
 	if( action == "ADD" )
 	{
-		while( !fin.eof() )
+		//get attribute line
+		reader.open( currentWorkingDirectory + filePath, attrLine );
+		while( !attrLine.empty() )
 		{
-			//get attribute line
-			getline( fin, attrLine );
-
-			while( !attrLine.empty() )
-			{
-				string attribute = getUntilTab( attrLine );
-				//parse attribute further
-				tempAttr.attributeName = getNextWord( attribute );
-				tempAttr.attributeType = attribute;
+			string attribute = getUntilTab( attrLine );
+			//parse attribute further
+			tempAttr.attributeName = getNextWord( attribute );
+			tempAttr.attributeType = attribute;
 
-				tableAttributes.push_back( tempAttr );
-			}
-			//check again that it is not end of file
-			if( !fin.eof() )
-			{
-				getline( fin, temp );
-				fileContents.push_back( temp );
-			}	
+			tableAttributes.push_back( tempAttr );
+		}
+		while( reader.readLine( temp ) )
+		{
+			fileContents.push_back( temp );
 		}
+		reader.close();
 
 		//get comma count to get num of attributes
 		commaCount = getCommaCount( input );
@@ -456,7 +775,6 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 		//get number of attributes
 		originalNumOfAttr = tableAttributes.size();
 
-		ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
 		//get additional attributes
 		for( int index = 0; index < commaCount; index++ )
 		{
@@ -501,34 +819,47 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 
 		int tableSize = tableAttributes.size();
 		newNumOfAttr = tableSize - originalNumOfAttr;
-		for( int index = 0; index < tableSize; index++ )
-		{
-			if( index != tableSize - 1 )
-			{
-				//if its the last table then do not add tab
-				fout << tableAttributes[ index ].attributeName << " ";		
-				fout << tableAttributes[ index ].attributeType << "\t";	
-			}
-			else
-			{
-				fout << tableAttributes[ index ].attributeName << " ";		
-				fout << tableAttributes[ index ].attributeType;	
-			}
-
-		}
+		//the table keeps its codec, the new version replaces it once written
+		string tempFilePath = getTempPath( currentWorkingDirectory + filePath );
+		writer.open( tempFilePath, reader.codec, getAttributeLine( tableAttributes ) );
 
 		//initalize all records so that attribtue is null
 		int contentSize = fileContents.size();
 		for( int index = 0; index < contentSize; index++ )
 		{
-			fout << endl << fileContents[ index ];
 			for( int newAttr = 0; newAttr < newNumOfAttr; newAttr++ )
 			{
-				fout << "\tnull";
+				fileContents[ index ] += "\tnull";
 			}
+			writer.writeLine( fileContents[ index ] );
+		}
+		if( !writer.close() || !publishTable( tempFilePath, currentWorkingDirectory + filePath ) )
+		{
+			errorCode = true;
+			remove( tempFilePath.c_str() );
+			cout << "-- !Failed to modify table " << tableName << " because it could not be rewritten." << endl;
+			return;
+		}
+		cout << "-- Table " << tableName << " modified." << endl;
+	}
+	else if( action == "SET" && getNextWord( input ) == "COMPRESSION" )
+	{
+		//rewrite every record with the named codec
+		removeLeadingWS( input );
+		Codec * codec = findCodec( input );
+		if( codec == NULL )
+		{
+			errorCode = true;
+			cout << "-- !Failed to modify table " << tableName << " because " << input;
+			cout << " is not a compression codec." << endl;
+			return;
+		}
+		if( !rewriteTable( currentWorkingDirectory + filePath, codec->id() ) )
+		{
+			errorCode = true;
+			cout << "-- !Failed to modify table " << tableName << " because it could not be rewritten." << endl;
+			return;
 		}
-		fin.close();
-		fout.close();
 		cout << "-- Table " << tableName << " modified." << endl;
 	}
 	else
@@ -547,7 +878,13 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
  *
  * @post attributes stored in the directory are displayed 
  *
- * @par Algorithm goes to the filepath, and displays info from the file
+ * @par Algorithm builds a scan of the table file, wrapped in a filter for the
+ *      where condition, a projection for the attribute subset and a limit,
+ *      then outputs tuples through a ResultWriter as they are pulled from
+ *      the top operator. Rows
+ *      are streamed from the file so a limit stops reading the file early.
+ *      For EXPLAIN the operator tree is outputted instead, after it has been
+ *      run with every operator profiled for EXPLAIN ANALYZE
  *
  * @param [in] string currentWorkingDirectory
  *
@@ -557,256 +894,66 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
  *
  * @param [in] string queryType
  *
+ * @param [in] QueryLimit qLimit
+ *
+ * @param [in] int explainMode - EXPLAIN_NONE, EXPLAIN_PLAN or EXPLAIN_ANALYZE
+ *
+ * @param [in] int outputFormat - format of the session, see ResultWriter.h
+ *
  * @return None
  *
  * @note None
  */
-void Table::tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType )
+void Table::tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType,
+	QueryLimit qLimit, int explainMode, int outputFormat )
 {
-	vector< Attribute > attributes;
-	vector< AttributeSubset > attrSubsets;
-	WhereCondition wCond;
+	vector< int > attrIndexes;
+	Row tuple;
+	vector< Operator * > owned;
+	Predicate predicate;
 	string filePath = "/" + currentDatabase + "/" + tableName;
 	string temp;
 	int commaCount;
-	int contentLineCount = 0;
-	double tempDouble;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
+	bool profile = ( explainMode == EXPLAIN_ANALYZE );
 
-	//automatically get all the attributes
-	while( !temp.empty() )
+	StatementClock::enter( PHASE_PLAN );
+	TableScan * scan = new TableScan( currentWorkingDirectory + filePath );
+	owned.push_back( scan );
+	if( explainMode != EXPLAIN_NONE )
 	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
+		scan->estimatedRows = statistics.estimateRows( currentWorkingDirectory + filePath );
 	}
+	Operator * root = profileOperator( scan, profile, owned );
 
-	//if query all attributes
-	if( queryType == ALL )
+	predicate.statistics = getAttributeStatistics( statistics, scan->attributes );
+	if( !predicate.parse( whereType ) || !predicate.compile( scan->attributes ) )
 	{
-		cout << "-- ";
-		int size = attributes.size();
-
-		//output all attributes
-		for( int index = 0; index < size; index++ )
-		{
-			cout << attributes[ index ].attributeName << " ";
-			cout << attributes[ index ].attributeType;
-			if( index != size - 1 )
-			{
-				cout << "|";
-			}
-		}
-		cout << endl;
-
-		//if there is a where condition then output with where cond
-		if( !whereType.empty() )
-		{
-			getWhereCondition( wCond, whereType, attributes);
-		
-					//get size of file content
-			while( !fin.eof() )
-			{
-				getline( fin, temp );
-				contentLineCount++;
-			}
-			fin.close();
-			ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-			//get attribute and store into temp, not used
-			getline( fin, temp );
-			//create 2d array
-			string twoDArr[ contentLineCount ][ attributes.size() ];
-			int attributesSize = attributes.size();
-			for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-			{
-				getline( fin, temp );
-				for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-				{
-					twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
-				}
-			}
-
-			//output specific data
-			//for each row
-			for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-			{
-				bool printResult = false;
-				cout << "-- ";
-				//for each col
-				for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-				{
-						if( wCond.operatorValue == "=" )
-						{
-							
-							//if we are not comparing floats, then do not convert to double
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble == wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == "!=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble != wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						if( wCond.operatorValue == "<" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble < wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == "<=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble <= wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == ">" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble > wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == ">=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble >= wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						if( printResult )
-						{
-							string content = twoDArr[ iIndex ][ jIndex ];
-							if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-							{
-								content.erase( 0, content.find( "'" ) + 1 );
-								content.erase( content.find_last_of( "'" ), content.length()-1 );
-							}
-							cout << content << "|";
-						}	
-				}
-				if( printResult )
-				{
-					cout << "\b \b";
-					cout << endl;
-				}
-				else
-				{
-					cout << "\b \b\b\b";	
-				}
-			}
+		cout << "-- !Failed to query table " << tableName << " because of an invalid where condition." << endl;
+		deleteOperators( owned );
+		return;
+	}
 
-		}
-		else //output everything otherwise
-		{
-			while( !fin.eof() )
-			{
-				getline( fin, temp);
-				cout << "-- ";
-				while( !temp.empty() )
-				{
-					string content = getUntilTab( temp );
-					//check that if start of string is "'" and end is "'"
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
-				cout << "\b \b";
-				cout << endl;
-			}
-			fin.close();
-		}
+	//if there is a where condition then filter the scan
+	if( !predicate.empty() )
+	{
+		Operator * filter = new FilterOperator( root, predicate.kernel );
+		filter->detail = conditionText( predicate.root );
+		filter->estimatedRows = scan->estimatedRows * predicate.root->selectivity;
+		owned.push_back( filter );
+		root = profileOperator( filter, profile, owned );
 	}
-	else
+
+	//if query an attribute subset then project it
+	if( queryType != ALL )
 	{
+		string selected = queryType;
+
 		//get attributes in query subset 
 		commaCount = getCommaCount( queryType );
 		
 		//get subset to query
 		for ( int index = 0; index < commaCount+1; index++ )
 		{
-			AttributeSubset tempAttr;
-
 			//remove beginning parameter
 			temp = queryType.substr( 0, queryType.find( "," ));
 			queryType.erase( 0, queryType.find(",") + 1 );
@@ -814,201 +961,64 @@ void Table::tableSelect( string currentWorkingDirectory, string currentDatabase,
 			//remove leading white space
 			removeLeadingWS( temp );
 
-			tempAttr.attributeName = temp;
-			tempAttr.attributeIndex = findAttrOccur( attributes, tempAttr.attributeName );
-			attrSubsets.push_back( tempAttr );
-		}
-
-		//check that there is where condition
-		if( !whereType.empty() )
-		{
-			getWhereCondition( wCond, whereType, attributes);
-		}
-
-		//get size of file content
-		while( !fin.eof() )
-		{
-			getline( fin, temp );
-			contentLineCount++;
-		}
-
-		fin.close();
-		ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-		//get attribute and store into temp, not used
-		getline( fin, temp );
-		//create 2d array
-		string twoDArr[ contentLineCount ][ attributes.size() ];
-		
-		//store data in 2d array
-		int attributesSize = attributes.size();
-		for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-		{
-			getline( fin, temp );
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+			int attrIndex = findAttrOccur( scan->attributes, temp );
+			if( attrIndex < 0 )
 			{
-				twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
+				cout << "-- !Failed to query table " << tableName << " because " << temp;
+				cout << " does not exist." << endl;
+				deleteOperators( owned );
+				return;
 			}
+			attrIndexes.push_back( attrIndex );
 		}
+		Operator * project = new ProjectOperator( root, attrIndexes );
+		project->detail = selected;
+		project->estimatedRows = root->estimatedRows;
+		owned.push_back( project );
+		root = profileOperator( project, profile, owned );
+	}
 
-		//output attribute subset
-		cout << "-- ";
-		for( int index = 0; index < attributesSize; index++ )
+	if( qLimit.rowLimit != NO_LIMIT || qLimit.rowOffset > 0 )
+	{
+		Operator * limit = new LimitOperator( root, qLimit );
+		limit->estimatedRows = max( 0.0, root->estimatedRows - qLimit.rowOffset );
+		if( qLimit.rowLimit != NO_LIMIT )
 		{
-			if( currIndexIsSubset( attrSubsets, index ) )
-			{
-				cout << attributes[ index ].attributeName;
-				cout << " " << attributes[ index ].attributeType << "|"; 
-			}
+			limit->estimatedRows = min( limit->estimatedRows, (double) qLimit.rowLimit );
 		}
-		cout << "\b \b" << endl;
+		owned.push_back( limit );
+		root = profileOperator( limit, profile, owned );
+	}
 
-		//output specific data
-		//for each row
-		for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	StatementClock::enter( PHASE_EXECUTE );
+	if( explainMode != EXPLAIN_NONE )
+	{
+		if( profile )
 		{
-			bool printResult = false;
-			cout << "-- ";
-			//for each col
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+			root->open();
+			while( root->next( tuple ) )
 			{
-				//for each col check that the subset is to be called
-				if( currIndexIsSubset( attrSubsets, jIndex ) )
-				{
-					if( wCond.operatorValue == "=" )
-					{
-						
-						//if we are not comparing floats, then do not convert to double
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble == wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == "!=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble != wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					if( wCond.operatorValue == "<" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble < wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == "<=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble <= wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == ">" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble > wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == ">=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble >= wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					if( printResult )
-					{
-						string content = twoDArr[ iIndex ][ jIndex ];
-						if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-						{
-							content.erase( 0, content.find( "'" ) + 1 );
-							content.erase( content.find_last_of( "'" ), content.length()-1 );
-						}
-						cout << content << "|";
-					}	
-				}
-
-				
-			}
-			if( printResult )
-			{
-				cout << "\b \b";
-				cout << endl;
-			}
-			else
-			{
-				cout << "\b \b\b\b";	
 			}
+			root->close();
 		}
+		explainOperator( root, 0, profile );
+		notePlanIfSlow( root );
+		deleteOperators( owned );
+		return;
 	}
+
+	//output the attributes then each tuple as it is produced
+	ResultWriter writer( outputFormat );
+	writer.writeHeader( root->attributes );
+	root->open();
+	while( root->next( tuple ) )
+	{
+		writer.writeRow( tuple );
+	}
+	root->close();
+	writer.finish();
+	notePlanIfSlow( root );
+	deleteOperators( owned );
 }
 
 /**
@@ -1029,10 +1039,15 @@ void Table::tableSelect( string currentWorkingDirectory, string currentDatabase,
  *
  *@param [in] bool &errorCode
  *
+ *@param [out] TableDelta * delta - the record inserted is added to it, NULL
+ *            if no materialized view is over the table
+ *
 */
-void Table::tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode )
+void Table::tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode,
+	TableDelta * delta )
 {
-	string contentStr = "\n";
+	vector< string > values;
+	string contentStr;
 	int commaCount;
 	string filePath = "/" + currentDatabase + "/" + tableName;
 	string temp;
@@ -1046,29 +1061,69 @@ void Table::tableInsert( string currentWorkingDirectory, string currentDatabase,
 
 		//remove leading white space
 		removeLeadingWS( temp );
-
-		//concat temp to content str
-		contentStr = contentStr + temp + '\t';
+		values.push_back( temp );
 	}
 	
 	//remove leading WS from input
 	removeLeadingWS( input );
-	contentStr = contentStr + input;
-
-	ofstream fout;
-	fout.open( ( currentWorkingDirectory + filePath ).c_str(), ofstream::out | ofstream::app );
-	fout << contentStr;
-
-	fout.close();
+	values.push_back( input );
 
-	cout << "-- 1 new record inserted." << endl;
-}
+	StatementClock::enter( PHASE_EXECUTE );
+	string recordText;
+	int valueSize = values.size();
+	for( int index = 0; index < valueSize; index++ )
+	{
+		recordText += values[ index ];
+		if( index != valueSize - 1 )
+		{
+			recordText += '\t';
+		}
+	}
 
-/**
- *@brief tableUpdate
+	//values of encoded attributes are stored as their codes, new values are
+	//added to the dictionary before the record refers to them
+	TableScan scan( currentWorkingDirectory + filePath );
+	bool dictionaryChanged = encodeValues( scan, values );
+	for( int index = 0; index < valueSize; index++ )
+	{
+		//concat value to content str
+		contentStr += values[ index ];
+		if( index != valueSize - 1 )
+		{
+			contentStr += '\t';
+		}
+	}
+	if( dictionaryChanged && !scan.dictionary.save( getDictionaryPath( currentWorkingDirectory + filePath ) ) )
+	{
+		errorCode = true;
+		cout << "-- !Failed to insert into table " << tableName << " because its dictionary could not be saved." << endl;
+		return;
+	}
+
+	if( !appendTableLine( currentWorkingDirectory + filePath, contentStr ) )
+	{
+		errorCode = true;
+		cout << "-- !Failed to insert into table " << tableName << " because it could not be written." << endl;
+		return;
+	}
+	if( delta != NULL )
+	{
+		delta->inserted.push_back( recordText );
+	}
+
+	cout << "-- 1 new record inserted." << endl;
+}
+
+/**
+ *@brief tableUpdate
  *
  *@details updates the table based on all records that match the given condition  
  *
+ *@par Algorithm streams the table through the where condition, writing every
+ *            record (modified or not) to a temporary file which then replaces
+ *            the table file. A new value of an encoded attribute is added to
+ *            its dictionary when the first record is modified
+ *
  *@param [in] string currentWorkingDirectory
  *
  *@param [in] string currentDatabase
@@ -1077,206 +1132,82 @@ void Table::tableInsert( string currentWorkingDirectory, string currentDatabase,
  *
  *@param [in] string setType
  *
+ *@param [out] TableDelta * delta - each record modified is added to it
+ *            before and after, NULL if no materialized view is over the table
+ *
 */
-void Table::tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType )
+void Table::tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType,
+	TableDelta * delta )
 {
-	vector< Attribute > attributes;
 	SetCondition sCond;
-	WhereCondition wCond;
-	string filePath = "/" + currentDatabase + "/" + tableName;
-	string temp;
+	Predicate predicate;
+	Row tuple;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	string tempFilePath = getTempPath( filePath );
 	int recordsModified = 0;
-	int contentLineCount = 0;
-	double tempDouble;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
+	vector< string > deleted;
+	vector< string > inserted;
 
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
-
-	//get attribute data
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
-	}
+	TableScan scan( filePath );
 
 	//get where and set conditions
-	getWhereCondition( wCond, whereType, attributes);
-	getSetCondition( sCond, setType, attributes );
-
-	//get size of file content
-	while( !fin.eof() )
+	getSetCondition( sCond, setType, scan.attributes );
+	if( !predicate.parse( whereType ) || !predicate.compile( scan.attributes ) || sCond.attributeIndex < 0 )
 	{
-		getline( fin, temp );
-		contentLineCount++;
+		cout << "-- !Failed to update table " << tableName << " because of an invalid condition." << endl;
+		return;
 	}
 
-	fin.close();
-	
-	fin.open(( currentWorkingDirectory + filePath ).c_str() );
-	
-	//get attribute and store into temp 
-	getline( fin, temp );
-	string attributeData = temp;
-	
-	//create 2d array and store content data
-	string twoDArr[ contentLineCount ][ attributes.size() ];
-	int attributesSize = attributes.size();
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	StatementClock::enter( PHASE_EXECUTE );
+	TableWriter writer;
+	writer.open( tempFilePath, scan.codec, getAttributeLine( scan.attributes ) );
+
+	Dictionary * dictionary = NULL;
+	if( scan.attributes[ sCond.attributeIndex ].dictionary != NULL &&
+		!isNullText( sCond.newValue.data(), sCond.newValue.size() ) )
 	{
-		getline( fin, temp );
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-		{
-			twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
-		}
+		dictionary = scan.dictionary.find( scan.attributes[ sCond.attributeIndex ].attributeName );
 	}
-	fin.close();
 
-	ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
-	
-	fout << attributeData << endl;
-	
-	//output specific data
-	//for each row
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	//output every record, modifying those that meet the condition
+	scan.open();
+	while( scan.next( tuple ) )
 	{
-		bool printResult = false;
-		//for each col
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+		if( predicate.evaluate( tuple ) )
 		{
-			//for each col check that the set index is to be called
-			if( sCond.attributeIndex == jIndex )
+			if( dictionary != NULL && dictionary->lookup( sCond.newValue ) < 0 )
 			{
-				if( wCond.operatorValue == "=" )
-				{
-					//if we are not comparing floats, then do not convert to double
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble == wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == "!=" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble != wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				if( wCond.operatorValue == "<" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble < wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == "<=" )
+				dictionary->add( sCond.newValue );
+				if( !scan.dictionary.save( getDictionaryPath( filePath ) ) )
 				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble <= wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
+					scan.close();
+					writer.close();
+					remove( tempFilePath.c_str() );
+					cout << "-- !Failed to update table " << tableName << " because its dictionary could not be saved." << endl;
+					return;
 				}
-				else if( wCond.operatorValue == ">" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble > wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == ">=" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble >= wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				if( printResult )
-				{
-					recordsModified++;
-					twoDArr[ iIndex ][ jIndex ] = sCond.newValue;
-				}	
 			}
-			fout << twoDArr[ iIndex ][ jIndex ];
-			if( jIndex != attributesSize - 1 )
+			recordsModified++;
+			if( delta != NULL )
 			{
-				fout << "\t";
+				deleted.push_back( getTupleText( tuple ) );
+			}
+			tuple.setValue( sCond.attributeIndex, sCond.newValue );
+			if( delta != NULL )
+			{
+				inserted.push_back( getTupleText( tuple ) );
 			}
 		}
-		if( iIndex != contentLineCount- 1 )
-		{
-			fout << endl;
-		}
+		writer.writeLine( getTupleLine( tuple ) );
+	}
+	scan.close();
+	writer.close();
+	if( publishTable( tempFilePath, filePath ) && delta != NULL )
+	{
+		delta->deleted.insert( delta->deleted.end(), deleted.begin(), deleted.end() );
+		delta->inserted.insert( delta->inserted.end(), inserted.begin(), inserted.end() );
 	}
+
 	cout << "-- " << recordsModified; 
 	if( recordsModified == 1 )
 	{
@@ -1288,209 +1219,70 @@ void Table::tableUpdate( string currentWorkingDirectory, string currentDatabase,
 	}
 }
 
-
-void Table::tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType )
+/**
+ *@brief tableDelete
+ *
+ *@details deletes all records that match the given condition  
+ *
+ *@par Algorithm streams the table through the where condition, writing the
+ *            records that do not meet it to a temporary file which then
+ *            replaces the table file
+ *
+ *@param [in] string currentWorkingDirectory
+ *
+ *@param [in] string currentDatabase
+ *
+ *@param [in] string whereType
+ *
+ *@param [out] TableDelta * delta - the records deleted are added to it, NULL
+ *            if no materialized view is over the table
+ *
+*/
+void Table::tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType, TableDelta * delta )
 {
-	vector< Attribute > attributes;
-	vector< string > contentOutput;
-	SetCondition sCond;
-	WhereCondition wCond;
-	string filePath = "/" + currentDatabase + "/" + tableName;
-	string temp;
-	vector< int > recordsModified;
-	int contentLineCount = 0;
-	double tempDouble;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
-
-	//get attribute data
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
-	}
+	Predicate predicate;
+	Row tuple;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	string tempFilePath = getTempPath( filePath );
+	int recordsDeleted = 0;
+	vector< string > deleted;
 
-	getWhereCondition( wCond, whereType, attributes);
+	TableScan scan( filePath );
 
-	//get size of file content
-	while( !fin.eof() )
+	if( !predicate.parse( whereType ) || !predicate.compile( scan.attributes ) )
 	{
-		getline( fin, temp );
-		contentLineCount++;
+		cout << "-- !Failed to delete from table " << tableName << " because of an invalid condition." << endl;
+		return;
 	}
 
-	fin.close();
-	//ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-	fin.open(( currentWorkingDirectory + filePath ).c_str() );
-	//get attribute and store into temp 
-	getline( fin, temp );
-	string attributeData = temp;
-	//create 2d array
-	string twoDArr[ contentLineCount ][ attributes.size() ];
-	int attributesSize = attributes.size();
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-	{
-		getline( fin, temp );
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-		{
-			twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
-		}
-	}
-	fin.close();
+	StatementClock::enter( PHASE_EXECUTE );
+	TableWriter writer;
+	writer.open( tempFilePath, scan.codec, getAttributeLine( scan.attributes ) );
 
-	ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
-	
-	fout << attributeData << endl;
-	//output specific data
-	//for each row
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	//keep the records that do not meet the condition
+	scan.open();
+	while( scan.next( tuple ) )
 	{
-		bool printResult = true;
-		//check that index val does 
-		if( wCond.operatorValue == "=" )
-		{
-			
-			//if we are not comparing floats, then do not convert to double
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble == wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == "!=" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble != wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		if( wCond.operatorValue == "<" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble < wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == "<=" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble <= wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == ">" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble > wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == ">=" )
+		if( predicate.evaluate( tuple ) )
 		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
+			recordsDeleted++;
+			if( delta != NULL )
 			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble >= wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
+				deleted.push_back( getTupleText( tuple ) );
 			}
 		}
-
-		if( printResult == true )
+		else
 		{
-			string content = "";
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-			{
-				content = content + twoDArr[ iIndex ][ jIndex ];
-				if( jIndex != attributesSize - 1 )
-				{
-					content = content + '\t';
-				}
-			}
-			contentOutput.push_back( content );
+			writer.writeLine( getTupleLine( tuple ) );
 		}
 	}
-
-	int newContentSize = contentOutput.size();
-
-	for( int index = 0; index < newContentSize; index++ )
+	scan.close();
+	writer.close();
+	if( publishTable( tempFilePath, filePath ) && delta != NULL )
 	{
-		fout << contentOutput[ index ];
-		if( index != newContentSize - 1 )
-		{
-			fout << endl;
-		}
+		delta->deleted.insert( delta->deleted.end(), deleted.begin(), deleted.end() );
 	}
 
-	int recordsDeleted = contentLineCount - newContentSize;
 	cout << "-- " << recordsDeleted;
 	if( recordsDeleted == 1 )
 	{
@@ -1501,65 +1293,57 @@ void Table::tableDelete( string currentWorkingDirectory, string currentDatabase,
 		cout << " records deleted." << endl;
 	}
 }
-
-int findAttrOccur( vector< Attribute > attributes, string attrName )
+/**
+ *@brief tableAnalyze
+ *
+ *@details collects the statistics of the table for the optimizer and saves
+ *            them next to the table file, where they are loaded from at startup,
+ *            then dictionary encodes the attributes with few distinct values
+ *
+ *@par Algorithm see TableStatistics::analyze and encodeAttributes
+ *
+ *@param [in] string currentWorkingDirectory
+ *
+ *@param [in] string currentDatabase
+ *
+*/
+void Table::tableAnalyze( string currentWorkingDirectory, string currentDatabase )
 {
-	int attrSize = attributes.size();
-	int attrIndex;
-	for ( int index = 0; index < attrSize; index++ )
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	statistics.analyze( filePath );
+	if( !statistics.save( getStatisticsPath( currentWorkingDirectory, currentDatabase, tableName ) ) )
 	{
-		if( attributes[ index ].attributeName == attrName )
-		{
-			attrIndex = index;
-		}
+		cout << "-- !Failed to analyze table " << tableName << " because its statistics could not be saved." << endl;
+		return;
 	}
-	return attrIndex;
+	int encodedCount = encodeAttributes( filePath, statistics );
+	if( encodedCount < 0 )
+	{
+		cout << "-- !Failed to analyze table " << tableName << " because it could not be encoded." << endl;
+		return;
+	}
+
+	cout << "-- Table " << tableName << " analyzed, " << (long) statistics.rowCount;
+	cout << ( statistics.rowCount == 1 ? " record" : " records" );
+	if( encodedCount > 0 )
+	{
+		cout << ", " << encodedCount << ( encodedCount == 1 ? " attribute" : " attributes" ) << " dictionary encoded";
+	}
+	cout << "." << endl;
 }
 
-bool isAttrFloat( vector< Attribute > attributes, string attrName )
+int findAttrOccur( vector< Attribute > &attributes, string attrName )
 {
 	int attrSize = attributes.size();
+	int attrIndex = -1;
 	for ( int index = 0; index < attrSize; index++ )
 	{
 		if( attributes[ index ].attributeName == attrName )
 		{
-			if( attributes[ index ].attributeType == "float" || attributes[ index ].attributeType == "FLOAT" )
-			{
-				return true;
-			}
+			attrIndex = index;
 		}
 	}
-	return false;	
-}
-
-/**
-*@brief getWhereCondition method
-*
-*@details if there is a where condition in statement, parses that data
-*
-*@par Algorithm gets Where condition, and checks operatorValue from prev. function
-*			and stores the comparison which is converted into a floata and stored
-*
-*@param [in] WhereCondition &wCond
-*
-*@param [in] string whereType
-*
-*@param [in] vector <Attribute> attributes
-*
-*@note uses functions from setCondition 
-*/
-void getWhereCondition( WhereCondition &wCond, string whereType, vector< Attribute > attributes )
-{
-	wCond.attributeName = getNextWord( whereType );
-	wCond.attributeIndex = findAttrOccur( attributes, wCond.attributeName );
-	wCond.operatorValue = getNextWord( whereType );
-	wCond.comparisonValue = whereType;
-
-	if( isAttrFloat( attributes, wCond.attributeName ) )
-	{
-		wCond.floatValue = true;
-		wCond.comparisonValueFloat = atof( wCond.comparisonValue.c_str() );
-	}
+	return attrIndex;
 }
 
 /**
@@ -1578,7 +1362,7 @@ void getWhereCondition( WhereCondition &wCond, string whereType, vector< Attribu
 *@return none (void)
 *
 */
-void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > attributes )
+void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > &attributes )
 {
 	removeLeadingWS( setType );
 	sCond.attributeName = getNextWord( setType );
@@ -1598,7 +1382,7 @@ void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > a
 *
 *@return bool true if the same value
 */
-bool currIndexIsSubset( vector< AttributeSubset > attrSubsets, int indexVal )
+bool currIndexIsSubset( vector< AttributeSubset > &attrSubsets, int indexVal )
 {
 	int subsetSize = attrSubsets.size();
 	for( int index = 0; index < subsetSize; index++ )
@@ -1622,7 +1406,7 @@ bool currIndexIsSubset( vector< AttributeSubset > attrSubsets, int indexVal )
 *
 *@return bool true if index passed in exists in the vector of indices
 */
-bool indexExists( int i, vector< int > indexCounter )
+bool indexExists( int i, vector< int > &indexCounter )
 {
 	int size = indexCounter.size();
 	for ( int index = 0; index < size; index++ )
@@ -1636,405 +1420,99 @@ bool indexExists( int i, vector< int > indexCounter )
 }
 
 /**
- * @brief 
+ * @brief tableJoin
  *
- * @details 
+ * @details outputs the joined tuples of the tables of a from clause that
+ *          meet the on and where conditions
  *          
- * @pre 
+ * @pre all tables exist in the current database
  *
- * @post 
+ * @post joined tuples are outputted
  *
- * @par Algorithm 
- *     
+ * @par Algorithm the JoinPlanner builds the operator tree, choosing the order
+ *      the tables are joined in; tuples are outputted as they are pulled
+ *      from its root, with the attributes of the tables in from order.
+ *      For EXPLAIN the plan is outputted instead, as for tableSelect
  * 
  * @exception None
  *
- * @param [in] 
+ * @param [in] string currentWorkingDirectory, string currentDatabase
  *
- * @return 
+ * @param [in] vector< JoinTable > &joinTables - tables in from order, the
+ *             first one is this table
  *
- * @note None
- */
-void Table::innerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr )
-{
-	vector < Attribute > attributes1;
-	vector < string * > table1Tuples;
-	vector < Attribute > attributes2;
-	vector < string * > table2Tuples;
-	string filePath = "/" + currentDatabase + "/";
-	string temp;
-
-
-	//open table 1 file and read contents and attributes
-	ifstream fin( (currentWorkingDirectory + filePath + table1Name ).c_str() );
-
-	//get table 1 attributes
-	getline( fin, temp );
-
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes1.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl1Attr = attributes1.size();
-	//go till end of file
-	while( !fin.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes1.size() ];
-		//get line
-		getline( fin, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl1Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table1Tuples.push_back( tuple );
-	}
-	fin.close();
-
-	//open table 3 file and read contents and attributes
-	ifstream fread( (currentWorkingDirectory + filePath + table2Name ).c_str() );
-
-	getline( fread, temp );
-
-	//get attributes for table 2
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes2.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl2Attr = attributes2.size();
-	//go till end of file
-	while( !fread.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes2.size() ];
-		//get line
-		getline( fread, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl2Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table2Tuples.push_back( tuple );
-	}
-	fread.close();
-
-	int tbl1Size = table1Tuples.size();
-	int tbl2Size = table2Tuples.size();
-	int tbl1AttrOccur = findAttrOccur( attributes1, table1Attr );
-	int tbl2AttrOccur = findAttrOccur( attributes2, table2Attr );
-
-	//output attributes
-	int attrSize1 = attributes1.size();
-	int attrSize2 = attributes2.size();
-
-	cout << "-- ";
-	for( int index = 0; index < attrSize1; index++ )
-	{
-		cout << attributes1[ index ].attributeName << " ";
-		cout << attributes1[ index ].attributeType << "|";
-	}
-
-
-	for( int index = 0; index < attrSize2; index++ )
-	{
-		cout << attributes2[ index ].attributeName << " ";
-		cout << attributes2[ index ].attributeType; 
-		if( index != attrSize2 - 1 )
-		{
-			cout << "|";
-		}
-	}
-	cout << endl;
-
-	for( int tuple1Count = 0; tuple1Count < tbl1Size; tuple1Count++ )
-	{
-		bool joinFound = false;
-		vector <int> tbl2JoinIndexes;
-
-		for( int tuple2Count = 0; tuple2Count < tbl2Size; tuple2Count++ )
-		{
-		
-			if( table1Tuples[ tuple1Count ][ tbl1AttrOccur ] == 
-				table2Tuples[ tuple2Count ][ tbl2AttrOccur ] )
-			{
-				joinFound = true;
-				tbl2JoinIndexes.push_back( tuple2Count );
-				//cout << "TUPLE count " << tuple2Count << endl;
-			}
-		}
-		if( joinFound )
-		{
-			int joinCount = tbl2JoinIndexes.size();
-			
-			for( int joins = 0; joins < joinCount; joins++ )
-			{
-				cout << "-- ";
-				for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-				{
-					string content = table1Tuples[ tuple1Count ][ attr1 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
-
-				for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
-				{
-					string content = table2Tuples[ tbl2JoinIndexes[ joins ] ][ attr2 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content; 
-					if( attr2 != numTbl2Attr - 1 )
-					{
-						cout << "|";
-					}
-				}
-				cout << endl;
-			}
-		}
-	}
-
-	for( int i = 0; i < numTbl1Attr; i++ )
-	{
-		delete [] table1Tuples[ i ];
-	}
-
-	for( int i = 0; i < numTbl2Attr; i++ )
-	{
-		delete [] table2Tuples[ i ];
-	}
-
-}
-
-/**
- * @brief 
+ * @param [in] string whereType, string queryType
  *
- * @details 
- *          
- * @pre 
+ * @param [in] QueryLimit qLimit
  *
- * @post 
+ * @param [in] int explainMode - EXPLAIN_NONE, EXPLAIN_PLAN or EXPLAIN_ANALYZE
  *
- * @par Algorithm 
- *     
- * 
- * @exception None
+ * @param [in] int outputFormat - format of the session, see ResultWriter.h
  *
- * @param [in] 
- *
- * @return 
+ * @return None
  *
  * @note None
  */
-void Table::outerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr )
+void Table::tableJoin( string currentWorkingDirectory, string currentDatabase, vector< JoinTable > &joinTables, string whereType, string queryType,
+	QueryLimit qLimit, int explainMode, int outputFormat )
 {
-	vector < Attribute > attributes1;
-	vector < string * > table1Tuples;
-	vector < Attribute > attributes2;
-	vector < string * > table2Tuples;
-	string filePath = "/" + currentDatabase + "/";
-	string temp;
-
-
-	//open table 1 file and read contents and attributes
-	ifstream fin( (currentWorkingDirectory + filePath + table1Name ).c_str() );
-
-	//get table 1 attributes
-	getline( fin, temp );
-
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes1.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl1Attr = attributes1.size();
-	//go till end of file
-	while( !fin.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes1.size() ];
-		//get line
-		getline( fin, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl1Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table1Tuples.push_back( tuple );
-	}
-	fin.close();
-
-	//open table 3 file and read contents and attributes
-	ifstream fread( (currentWorkingDirectory + filePath + table2Name ).c_str() );
+	Row tuple;
+	JoinPlanner planner;
+	string errorMessage;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/";
 
-	getline( fread, temp );
-
-	//get attributes for table 2
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes2.push_back( tempAttribute );
-	}
+	planner.profile = ( explainMode == EXPLAIN_ANALYZE );
 
-	//get tuples
-	int numTbl2Attr = attributes2.size();
-	//go till end of file
-	while( !fread.eof() )
+	StatementClock::enter( PHASE_PLAN );
+	if( !planner.plan( filePath, joinTables, whereType, queryType, qLimit, errorMessage ) )
 	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes2.size() ];
-		//get line
-		getline( fread, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl2Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table2Tuples.push_back( tuple );
-	}
-	fread.close();
-
-	int tbl1Size = table1Tuples.size();
-	int tbl2Size = table2Tuples.size();
-	int tbl1AttrOccur = findAttrOccur( attributes1, table1Attr );
-	int tbl2AttrOccur = findAttrOccur( attributes2, table2Attr );
-
-	//output attributes
-	int attrSize1 = attributes1.size();
-	int attrSize2 = attributes2.size();
-
-	cout << "-- ";
-	for( int index = 0; index < attrSize1; index++ )
-	{
-		cout << attributes1[ index ].attributeName << " ";
-		cout << attributes1[ index ].attributeType << "|";
-	}
-
-
-	for( int index = 0; index < attrSize2; index++ )
-	{
-		cout << attributes2[ index ].attributeName << " ";
-		cout << attributes2[ index ].attributeType; 
-		if( index != attrSize2 - 1 )
-		{
-			cout << "|";
-		}
-	}
-	cout << endl;
-
-	for( int tuple1Count = 0; tuple1Count < tbl1Size; tuple1Count++ )
-	{
-		bool joinFound = false;
-		vector <int> tbl2JoinIndexes;
-
-		for( int tuple2Count = 0; tuple2Count < tbl2Size; tuple2Count++ )
+		int tableSize = joinTables.size();
+		cout << "-- !Failed to query tables ";
+		for( int index = 0; index < tableSize; index++ )
 		{
-		
-			if( table1Tuples[ tuple1Count ][ tbl1AttrOccur ] == 
-				table2Tuples[ tuple2Count ][ tbl2AttrOccur ] )
+			if( index == tableSize - 1 )
 			{
-				joinFound = true;
-				tbl2JoinIndexes.push_back( tuple2Count );
-				//cout << "TUPLE count " << tuple2Count << endl;
+				cout << " and ";
 			}
-		}
-		if( joinFound )
-		{
-			int joinCount = tbl2JoinIndexes.size();
-			
-			for( int joins = 0; joins < joinCount; joins++ )
+			else if( index > 0 )
 			{
-				cout << "-- ";
-				for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-				{
-					string content = table1Tuples[ tuple1Count ][ attr1 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
-
-				for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
-				{
-					string content = table2Tuples[ tbl2JoinIndexes[ joins ] ][ attr2 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content; 
-					if( attr2 != numTbl2Attr - 1 )
-					{
-						cout << "|";
-					}
-				}
-				cout << endl;
+				cout << ", ";
 			}
+			cout << joinTables[ index ].tableName;
 		}
-		else
-		{
-			cout << "-- ";
-			for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-			{
-				string content = table1Tuples[ tuple1Count ][ attr1 ];
-				if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-				{
-					content.erase( 0, content.find( "'" ) + 1 );
-					content.erase( content.find_last_of( "'" ), content.length()-1 );
-				}
-				cout << content << "|";
-			}
+		cout << " because " << errorMessage << "." << endl;
+		return;
+	}
+	Operator * root = planner.root;
 
-			for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
+	StatementClock::enter( PHASE_EXECUTE );
+	if( explainMode != EXPLAIN_NONE )
+	{
+		if( planner.profile )
+		{
+			root->open();
+			while( root->next( tuple ) )
 			{
-				if( attr2 != numTbl2Attr - 1 )
-				{
-					cout << "|";
-				}
 			}
-			cout << endl;
+			root->close();
 		}
+		explainOperator( root, 0, planner.profile );
+		notePlanIfSlow( root );
+		return;
 	}
 
-	for( int i = 0; i < numTbl1Attr; i++ )
-	{
-		delete [] table1Tuples[ i ];
-	}
-
-	for( int i = 0; i < numTbl2Attr; i++ )
+	//output the attributes then each tuple as it is produced
+	ResultWriter writer( outputFormat );
+	writer.writeHeader( root->attributes );
+	root->open();
+	while( root->next( tuple ) )
 	{
-		delete [] table2Tuples[ i ];
+		writer.writeRow( tuple );
 	}
+	root->close();
+	writer.finish();
+	notePlanIfSlow( root );
 }
 
-
 // Terminating precompiler directives  ////////////////////////////////////////
 #endif
@@ -12,15 +12,26 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "Statistics.h"
 using namespace std;
 
 // Precompiler directives /////////////////////////////////////////////////////
 #ifndef TABLE_H
 #define TABLE_H
 
+class Dictionary;
+
 struct Attribute{
 	string attributeName;
 	string attributeType;
+	//dictionary of an encoded attribute, owned by the scan of its table,
+	//NULL if the attribute is not encoded
+	const Dictionary * dictionary;
+
+	Attribute()
+	{
+		dictionary = NULL;
+	}
 };
 
 struct SetCondition
@@ -40,22 +51,62 @@ struct WhereCondition{
 	string comparisonValue;
 };
 
+const int NO_LIMIT = -1;
+
+struct QueryLimit{
+	int rowLimit;
+	int rowOffset;
+};
+
+const int JOIN_INNER = 0;
+const int JOIN_LEFT_OUTER = 1;
+
+//a table of a from clause and how it is joined to the tables before it
+struct JoinTable{
+	string tableName;
+	string tableVariable;
+	int joinType;
+	string onCondition;
+	//statistics of the table in the catalog, NULL if unknown
+	TableStatistics * statistics;
+	//file read instead of the table's, such as the records a statement
+	//changed when a materialized view is brought up to date. Empty for the
+	//table's file
+	string filePath;
+};
+
+//records a statement inserted into and deleted from a table, as text with
+//encoded values decoded, for the materialized views over the table. An
+//update deletes the old record and inserts the new one
+struct TableDelta{
+	vector< string > inserted;
+	vector< string > deleted;
+};
+
 
 class Table{
 	public: 
 		string tableName;
+		TableStatistics statistics;
+		//select the table holds the result of if it is a materialized view,
+		//empty otherwise
+		string viewQuery;
 
 		Table();
 		~Table();
 		void tableCreate( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode );
 		void tableDrop( string currentWorkingDirectory, string dbName );
 		void tableAlter( string currentWorkingDirectory, string currentDatabase, string input, bool &errorCode );
-		void tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType );
-		void tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode );
-		void tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType );
-		void tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType);
-		void innerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr );
-		void outerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr );
+		void tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType, QueryLimit qLimit,
+			int explainMode, int outputFormat );
+		void tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode,
+			TableDelta * delta );
+		void tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType,
+			TableDelta * delta );
+		void tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType, TableDelta * delta );
+		void tableAnalyze( string currentWorkingDirectory, string currentDatabase );
+		void tableJoin( string currentWorkingDirectory, string currentDatabase, vector< JoinTable > &joinTables, string whereType, string queryType, 
+			QueryLimit qLimit, int explainMode, int outputFormat );
 };
 
 // Terminating precompiler directives  ////////////////////////////////////////
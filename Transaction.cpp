@@ -0,0 +1,547 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Transaction.cpp
+ *
+ * @brief Implementation file for the Transaction class
+ *
+ * @details Implements the transaction of a session, its commit through the
+ *          transaction log and the recovery of a commit cut short
+ *
+ *          The log holds the commit being published: an "append" line with
+ *          the table file, its size before the commit and the count of
+ *          records, followed by the records, or a "replace" line with the
+ *          table file and the private version replacing it. It ends with a
+ *          "commit" line once all of it is on disk
+ *
+ * @Note Requires Transaction.h
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "Transaction.h"
+#include "Storage.h"
+#include "Io.h"
+#include "ResultCache.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TRANSACTION_CPP
+#define TRANSACTION_CPP
+
+//declaration of the helper functions
+string getTempPath( string tableFilePath );
+bool appendTableText( string filePath, const string &text );
+void compactTable( string filePath );
+extern ReadWriteLock commitLock;
+extern ResultCache resultCache;
+
+//one commit at a time writes the transaction log and publishes its changes
+mutex transactionLogMutex;
+
+//numbers the private versions of every transaction
+atomic< long long > transactionVersions( 0 );
+
+thread_local Transaction * Transaction::current = NULL;
+
+/**
+ * @brief writeDurable
+ *
+ * @details appends text to each file and waits until all of them are on
+ *          disk. A file given no text, such as a directory, is only synced
+ *
+ * @par Algorithm the writes are submitted to the thread's IoQueue together,
+ *      then the syncs, so the device works on all of them at once
+ *
+ * @param [in] const vector< string > &filePaths
+ *
+ * @param [in] const vector< string > &texts - the text of each file
+ *
+ * @param [in] bool append - appends to the files, otherwise replaces them
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool writeDurable( const vector< string > &filePaths, const vector< string > &texts, bool append )
+{
+	IoQueue &queue = IoQueue::forThread();
+	int fileSize = filePaths.size();
+	vector< int > fds( fileSize, -1 );
+	vector< IoRequest > writes( fileSize );
+	vector< IoRequest > syncs( fileSize );
+	bool durable = true;
+
+	for( int index = 0; index < fileSize; index++ )
+	{
+		struct stat fileInfo;
+		if( texts[ index ].empty() )
+		{
+			fds[ index ] = ::open( filePaths[ index ].c_str(), O_RDONLY );
+		}
+		else
+		{
+			fds[ index ] = ::open( filePaths[ index ].c_str(), O_WRONLY | O_CREAT | ( append ? 0 : O_TRUNC ), 0644 );
+		}
+		if( fds[ index ] < 0 || fstat( fds[ index ], &fileInfo ) != 0 )
+		{
+			durable = false;
+			continue;
+		}
+		if( !texts[ index ].empty() )
+		{
+			writes[ index ].operation = IO_WRITE;
+			writes[ index ].fd = fds[ index ];
+			writes[ index ].data = (char *) texts[ index ].data();
+			writes[ index ].size = texts[ index ].size();
+			writes[ index ].offset = append ? (long long) fileInfo.st_size : 0;
+			queue.submit( writes[ index ] );
+		}
+	}
+	for( int index = 0; index < fileSize; index++ )
+	{
+		if( fds[ index ] >= 0 && !texts[ index ].empty() )
+		{
+			queue.wait( writes[ index ] );
+			durable = durable && writes[ index ].result == (long long) texts[ index ].size();
+		}
+	}
+
+	for( int index = 0; index < fileSize; index++ )
+	{
+		if( fds[ index ] >= 0 )
+		{
+			syncs[ index ].operation = IO_FSYNC;
+			syncs[ index ].fd = fds[ index ];
+			queue.submit( syncs[ index ] );
+		}
+	}
+	for( int index = 0; index < fileSize; index++ )
+	{
+		if( fds[ index ] >= 0 )
+		{
+			queue.wait( syncs[ index ] );
+			durable = durable && syncs[ index ].result == 0;
+			::close( fds[ index ] );
+		}
+	}
+	return durable;
+}
+
+/**
+ * @brief getLinesText
+ *
+ * @details returns records as they are appended to a table file, each
+ *          after a newline
+ *
+ * @param [in] const vector< string > &lines
+ *
+ * @return string
+ *
+ * @note None
+ */
+string getLinesText( const vector< string > &lines )
+{
+	string text;
+	int lineSize = lines.size();
+	for( int index = 0; index < lineSize; index++ )
+	{
+		text += "\n";
+		text += lines[ index ];
+	}
+	return text;
+}
+
+/**
+ * @brief recoverTransactions
+ *
+ * @details finishes the commit left in the transaction log by a database
+ *          system that stopped while publishing it, or drops the commit if
+ *          its log was not complete
+ *
+ * @par Algorithm redoing a commit is safe however much of it was published:
+ *      a table appended to is cut back to its size before the commit then
+ *      appended to again, a private version that is gone already replaced
+ *      its table
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @return None
+ *
+ * @note runs before any session, private versions of transactions that
+ *       did not commit are removed when the tables are loaded
+ */
+void recoverTransactions( string databaseSystemPath )
+{
+	string logPath = databaseSystemPath + "/" + TRANSACTION_LOG_NAME;
+	ifstream fin( logPath.c_str() );
+	if( !fin.is_open() )
+	{
+		return;
+	}
+
+	vector< string > entries;
+	string line;
+	bool complete = false;
+	while( getline( fin, line ) )
+	{
+		complete = line == "commit";
+		entries.push_back( line );
+	}
+	fin.close();
+
+	int entrySize = entries.size();
+	for( int index = 0; index < entrySize; index++ )
+	{
+		istringstream entry( entries[ index ] );
+		string action;
+		string filePath;
+		getline( entry, action, '\t' );
+		getline( entry, filePath, '\t' );
+
+		if( action == "replace" )
+		{
+			string versionPath;
+			getline( entry, versionPath, '\t' );
+			if( complete )
+			{
+				rename( versionPath.c_str(), filePath.c_str() );
+			}
+			else
+			{
+				remove( versionPath.c_str() );
+			}
+		}
+		else if( action == "append" )
+		{
+			long long fileSize = 0;
+			int lineCount = 0;
+			entry >> fileSize >> lineCount;
+			vector< string > lines( entries.begin() + min( index + 1, entrySize ),
+				entries.begin() + min( index + 1 + lineCount, entrySize ) );
+			index += lineCount;
+			if( complete && truncate( filePath.c_str(), fileSize ) == 0 )
+			{
+				writeDurable( vector< string >( 1, filePath ), vector< string >( 1, getLinesText( lines ) ), true );
+			}
+		}
+	}
+
+	if( complete )
+	{
+		cout << "-- Recovered the last commit from " << TRANSACTION_LOG_NAME << "." << endl;
+	}
+	remove( logPath.c_str() );
+}
+
+/**
+ * @brief Transaction constructor
+ *
+ * @details the transaction is the thread's until it is destroyed
+ *
+ * @param [in] string transactionLogPath
+ *
+ * @note None
+ */
+Transaction::Transaction( string transactionLogPath )
+{
+	opened = false;
+	logPath = transactionLogPath;
+	previous = current;
+	current = this;
+}
+
+Transaction::~Transaction()
+{
+	rollback();
+	current = previous;
+}
+
+bool Transaction::isOpen()
+{
+	return opened;
+}
+
+void Transaction::begin()
+{
+	opened = true;
+}
+
+/**
+ * @brief Transaction active
+ *
+ * @details returns the open transaction of the thread
+ *
+ * @return Transaction * NULL if the thread has none
+ *
+ * @note None
+ */
+Transaction * Transaction::active()
+{
+	return current != NULL && current->opened ? current : NULL;
+}
+
+/**
+ * @brief Transaction lockTable
+ *
+ * @details locks a table for a statement. A write lock is the
+ *          transaction's, held until it ends, others are the statement's
+ *
+ * @param [in] StatementLocks &statementLocks
+ *
+ * @param [in] string databaseName
+ *
+ * @param [in] string tableName
+ *
+ * @param [in] int mode
+ *
+ * @return bool false if the table is locked by another session
+ *
+ * @note None
+ */
+bool Transaction::lockTable( StatementLocks &statementLocks, string databaseName, string tableName, int mode )
+{
+	StatementLocks &held = opened && mode != LOCK_INTENT_SHARED ? locks : statementLocks;
+	return held.lockTable( databaseName, tableName, mode );
+}
+
+/**
+ * @brief Transaction appendLine
+ *
+ * @details buffers a record inserted into a table
+ *
+ * @param [in] const string &filePath - full path to the table file
+ *
+ * @param [in] const string &line
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Transaction::appendLine( const string &filePath, const string &line )
+{
+	changes[ filePath ].lines.push_back( line );
+}
+
+/**
+ * @brief Transaction publish
+ *
+ * @details makes a rewritten table file the private version of the table
+ *
+ * @par Algorithm the new version was read from the previous one and the
+ *      records buffered for it, so they are in it now
+ *
+ * @param [in] const string &tempFilePath
+ *
+ * @param [in] const string &filePath - full path to the table file
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool Transaction::publish( const string &tempFilePath, const string &filePath )
+{
+	TableChange &change = changes[ filePath ];
+	if( change.versionPath.empty() )
+	{
+		ostringstream versionPath;
+		versionPath << getTempPath( filePath ) << ".txn" << transactionVersions++;
+		change.versionPath = versionPath.str();
+	}
+	if( rename( tempFilePath.c_str(), change.versionPath.c_str() ) != 0 )
+	{
+		return false;
+	}
+	change.lines.clear();
+	return true;
+}
+
+/**
+ * @brief Transaction versionOf
+ *
+ * @details returns the private version of a table file
+ *
+ * @param [in] const string &filePath
+ *
+ * @return string empty if the table was not rewritten by the transaction
+ *
+ * @note None
+ */
+string Transaction::versionOf( const string &filePath )
+{
+	map< string, TableChange >::iterator found = changes.find( filePath );
+	return found == changes.end() ? "" : found->second.versionPath;
+}
+
+/**
+ * @brief Transaction pendingLines
+ *
+ * @details returns the records buffered for a table, read after its file
+ *
+ * @param [in] const string &filePath
+ *
+ * @return const vector< string > * NULL if there are none
+ *
+ * @note None
+ */
+const vector< string > * Transaction::pendingLines( const string &filePath )
+{
+	map< string, TableChange >::iterator found = changes.find( filePath );
+	return found == changes.end() || found->second.lines.empty() ? NULL : &found->second.lines;
+}
+
+/**
+ * @brief Transaction commit
+ *
+ * @details makes the changes of the transaction durable and visible to
+ *          every session, then ends it
+ *
+ * @par Algorithm buffered records are added to the private versions, which
+ *      are synced together, and the whole commit is written to the
+ *      transaction log with one write and one sync. Its changes are then published while
+ *      holding commitLock, so a snapshot sees all of them or none. Once the
+ *      tables are synced the log is removed, and tables appended to are
+ *      compacted as after an insert
+ *
+ * @return bool false if the commit could not be logged, the transaction is
+ *         then rolled back
+ *
+ * @note None
+ */
+bool Transaction::commit()
+{
+	bool committed = false;
+	vector< string > appended;
+	opened = false;
+	{
+		lock_guard< mutex > logging( transactionLogMutex );
+		bool durable = true;
+		string log;
+		vector< string > versionPaths;
+		vector< string > versionTexts;
+		map< string, TableChange >::iterator change;
+		for( change = changes.begin(); change != changes.end(); ++change )
+		{
+			string text = getLinesText( change->second.lines );
+			if( !change->second.versionPath.empty() )
+			{
+				versionPaths.push_back( change->second.versionPath );
+				versionTexts.push_back( text );
+				log += "replace\t" + change->first + "\t" + change->second.versionPath + "\n";
+			}
+			else if( !text.empty() )
+			{
+				struct stat fileInfo;
+				durable = durable && stat( change->first.c_str(), &fileInfo ) == 0;
+				ostringstream entry;
+				entry << "append\t" << change->first << "\t" << ( durable ? (long long) fileInfo.st_size : 0 )
+					<< "\t" << change->second.lines.size();
+				log += entry.str() + text + "\n";
+			}
+		}
+		log += "commit\n";
+
+		durable = durable && writeDurable( versionPaths, versionTexts, true );
+		if( durable && writeDurable( vector< string >( 1, logPath ), vector< string >( 1, log ), false ) )
+		{
+#ifndef NDEBUG
+			//the regression tests stop the debug build here, as a crash
+			//between logging the commit and publishing it would
+			if( getenv( "SIM_CRASH_AFTER_COMMIT_LOG" ) != NULL )
+			{
+				_exit( 1 );
+			}
+#endif
+			{
+				ReadWriteGuard commits( commitLock, true );
+				for( change = changes.begin(); change != changes.end(); ++change )
+				{
+					if( !change->second.versionPath.empty() )
+					{
+						rename( change->second.versionPath.c_str(), change->first.c_str() );
+						change->second.versionPath.clear();
+					}
+					else if( !change->second.lines.empty() )
+					{
+						appendTableText( change->first, getLinesText( change->second.lines ) );
+						appended.push_back( change->first );
+					}
+					resultCache.changed( change->first );
+				}
+			}
+
+			//the tables, and the directories of those replaced, are synced
+			//before the log is removed
+			vector< string > syncedPaths;
+			for( change = changes.begin(); change != changes.end(); ++change )
+			{
+				syncedPaths.push_back( change->first );
+				syncedPaths.push_back( change->first.substr( 0, change->first.rfind( '/' ) + 1 ) );
+			}
+			writeDurable( syncedPaths, vector< string >( syncedPaths.size() ), true );
+			committed = true;
+		}
+		remove( logPath.c_str() );
+	}
+
+	int appendedSize = appended.size();
+	for( int index = 0; index < appendedSize; index++ )
+	{
+		compactTable( appended[ index ] );
+	}
+	discard();
+	return committed;
+}
+
+/**
+ * @brief Transaction rollback
+ *
+ * @details discards the changes of the transaction and ends it
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Transaction::rollback()
+{
+	opened = false;
+	discard();
+}
+
+/**
+ * @brief Transaction discard
+ *
+ * @details removes the private versions left and releases the locks
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Transaction::discard()
+{
+	map< string, TableChange >::iterator change;
+	for( change = changes.begin(); change != changes.end(); ++change )
+	{
+		if( !change->second.versionPath.empty() )
+		{
+			remove( change->second.versionPath.c_str() );
+		}
+	}
+	changes.clear();
+	locks.releaseAll();
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,72 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file Transaction.h
+ *
+ * @brief Definition file for the Transaction class
+ *
+ * @details Specifies the transaction of a session. Between BEGIN and COMMIT
+ *          the changes of a session are kept to itself: inserted records
+ *          are buffered, and a table rewritten by an update or delete gets a
+ *          private version. The session reads its own changes, others do
+ *          not see them until COMMIT writes them to the transaction log in
+ *          one batch and then publishes them all at once. ROLLBACK discards
+ *          them. The tables written are locked until the transaction ends
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include "Lock.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+//file in the database system directory holding the commit being published
+const string TRANSACTION_LOG_NAME = ".transaction.log";
+
+class Transaction{
+	public:
+		Transaction( string transactionLogPath );
+		~Transaction();
+		bool isOpen();
+		void begin();
+		bool commit();
+		void rollback();
+		bool lockTable( StatementLocks &statementLocks, string databaseName, string tableName, int mode );
+
+		//used by the storage layer for the tables of the thread's transaction
+		static Transaction * active();
+		void appendLine( const string &filePath, const string &line );
+		bool publish( const string &tempFilePath, const string &filePath );
+		string versionOf( const string &filePath );
+		const vector< string > * pendingLines( const string &filePath );
+
+	private:
+		//changes to one table: a private version replacing the table file
+		//if it was rewritten, and records appended after that
+		struct TableChange{
+			string versionPath;
+			vector< string > lines;
+		};
+
+		bool opened;
+		string logPath;
+		map< string, TableChange > changes;
+		//locks of the tables written, held until the transaction ends
+		StatementLocks locks;
+		Transaction * previous;
+		static thread_local Transaction * current;
+
+		Transaction( const Transaction &other );
+		Transaction &operator=( const Transaction &other );
+		void discard();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
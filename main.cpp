@@ -13,7 +13,26 @@
  *		  Eugene Nelson (March 27 2018)
  *          Original code
  *
- * @Note Requires sim.cpp
+ * @Note Linked with sim.o, Server.o and the objects of the modules
+ *
+ *       ./main                              statements from the terminal
+ *       ./main --server <socket> [--port n] serve sessions to clients
+ *       ./main --port n                     serve sessions on localhost:n
+ *       ./main --connect <socket>           run a session on a server
+ *       --io threads                        table files are read and written by
+ *                                           a thread pool instead of io_uring
+ *       --read-ahead n                      reads a scan keeps outstanding
+ *       --page-cache n                      pages of table files cached, 0 for
+ *                                           none
+ *       --result-cache n                    megabytes of query results cached, 0
+ *                                           (the default) for none
+ *       --metrics-interval n                seconds between writes of
+ *                                           DatabaseSystem/.metrics.prom, 0 for
+ *                                           none
+ *       --slow-query-ms n                   statements taking n ms or more are
+ *                                           logged to
+ *                                           DatabaseSystem/.slow_query.log, -1
+ *                                           for none
  */
 #include <iostream>
 #include <string>
@@ -22,17 +41,88 @@
 #include <fstream>
 #include <stdlib.h>
 #include <unistd.h>
-#include "sim.cpp"
+#include "Io.h"
+#include "Storage.h"
+#include "PageCache.h"
+#include "Metrics.h"
+#include "SlowQueryLog.h"
+#include "ResultCache.h"
 
 using namespace std;
 
-int main()
+//declaration of the helper functions
+void startSimulation( string currentWorkingDirectory );
+int startServer( string currentWorkingDirectory, string socketPath, int port );
+int startClient( string socketPath );
+extern PageCache pageCache;
+extern ResultCache resultCache;
+
+int main( int argc, char * argv[] )
 {
 	//get current working directory
 	char buffer[200];
 	getcwd( buffer, sizeof( buffer ) );
 	string currentWorkingDirectory( buffer );
 
+	string socketPath;
+	string connectPath;
+	int port = 0;
+	int metricsInterval = METRICS_INTERVAL_SECONDS;
+	int slowQueryMilliseconds = SLOW_QUERY_MILLISECONDS;
+	for( int index = 1; index + 1 < argc; index += 2 )
+	{
+		string option = argv[ index ];
+		if( option == "--server" )
+		{
+			socketPath = argv[ index + 1 ];
+		}
+		else if( option == "--port" )
+		{
+			port = atoi( argv[ index + 1 ] );
+		}
+		else if( option == "--connect" )
+		{
+			connectPath = argv[ index + 1 ];
+		}
+		else if( option == "--io" )
+		{
+			IoQueue::setBackend( string( argv[ index + 1 ] ) == "threads" ? IO_BACKEND_THREADS : IO_BACKEND_URING );
+		}
+		else if( option == "--read-ahead" )
+		{
+			TableReader::setReadAhead( atoi( argv[ index + 1 ] ) );
+		}
+		else if( option == "--page-cache" )
+		{
+			pageCache.resize( max( 0, atoi( argv[ index + 1 ] ) ) );
+		}
+		else if( option == "--result-cache" )
+		{
+			resultCache.resize( (size_t) max( 0, atoi( argv[ index + 1 ] ) ) << 20 );
+		}
+		else if( option == "--metrics-interval" )
+		{
+			metricsInterval = atoi( argv[ index + 1 ] );
+		}
+		else if( option == "--slow-query-ms" )
+		{
+			slowQueryMilliseconds = atoi( argv[ index + 1 ] );
+		}
+	}
+
+	if( !connectPath.empty() )
+	{
+		return startClient( connectPath );
+	}
+
+	//the metrics of the sessions run here are written for a scraper
+	MetricsWriter metricsWriter( currentWorkingDirectory + "/DatabaseSystem/" + METRICS_FILE_NAME, metricsInterval );
+	SlowQueryLog::configure( currentWorkingDirectory + "/DatabaseSystem/" + SLOW_QUERY_LOG_NAME, slowQueryMilliseconds );
+	if( !socketPath.empty() || port > 0 )
+	{
+		return startServer( currentWorkingDirectory, socketPath, port );
+	}
+
 	startSimulation( currentWorkingDirectory );
 
 	return 0;
@@ -0,0 +1,240 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file predicateBench.cpp
+ *
+ * @brief Microbenchmark for where condition evaluation
+ * 
+ * @details Times the compiled predicate kernels against the operator ladder
+ *          that compared every tuple by looking up the operator string and
+ *          float flag of the where condition
+ *
+ * @Note Build with make predicateBench, run ./predicateBench [tuples]
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <sys/time.h>
+#include "Predicate.h"
+#include "Row.h"
+
+using namespace std;
+
+//declaration of the helper functions
+int getValueType( string attributeType );
+
+const int DEFAULT_TUPLE_COUNT = 1000000;
+const int REPEAT_COUNT = 5;
+
+/**
+*@brief ladderConditionMet method
+*
+*@details the per tuple operator ladder conditions were checked with before
+*			predicates were compiled, kept here as the baseline
+*
+*@par Algorithm compares the value at the condition's attribute index using
+*			the condition's operator, as doubles if the attribute is a float,
+*			otherwise as strings
+*
+*@param [in] WhereCondition &wCond
+*
+*@param [in] vector< string > &tuple
+*
+*@return bool true if the tuple meets the condition
+*/
+bool ladderConditionMet( WhereCondition &wCond, vector< string > &tuple )
+{
+	if( wCond.attributeIndex < 0 || wCond.attributeIndex >= (int) tuple.size() )
+	{
+		return false;
+	}
+
+	string &value = tuple[ wCond.attributeIndex ];
+	if( wCond.floatValue )
+	{
+		double tempDouble = atof( value.c_str() );
+		if( wCond.operatorValue == "=" )
+		{
+			return tempDouble == wCond.comparisonValueFloat;
+		}
+		else if( wCond.operatorValue == "!=" )
+		{
+			return tempDouble != wCond.comparisonValueFloat;
+		}
+		else if( wCond.operatorValue == "<" )
+		{
+			return tempDouble < wCond.comparisonValueFloat;
+		}
+		else if( wCond.operatorValue == "<=" )
+		{
+			return tempDouble <= wCond.comparisonValueFloat;
+		}
+		else if( wCond.operatorValue == ">" )
+		{
+			return tempDouble > wCond.comparisonValueFloat;
+		}
+		else if( wCond.operatorValue == ">=" )
+		{
+			return tempDouble >= wCond.comparisonValueFloat;
+		}
+	}
+	else
+	{
+		if( wCond.operatorValue == "=" )
+		{
+			return value == wCond.comparisonValue;
+		}
+		else if( wCond.operatorValue == "!=" )
+		{
+			return value != wCond.comparisonValue;
+		}
+		else if( wCond.operatorValue == "<" )
+		{
+			return value < wCond.comparisonValue;
+		}
+		else if( wCond.operatorValue == "<=" )
+		{
+			return value <= wCond.comparisonValue;
+		}
+		else if( wCond.operatorValue == ">" )
+		{
+			return value > wCond.comparisonValue;
+		}
+		else if( wCond.operatorValue == ">=" )
+		{
+			return value >= wCond.comparisonValue;
+		}
+	}
+	return false;
+}
+
+/**
+*@brief getTime method
+*
+*@details returns the wall clock time in seconds
+*
+*@return double
+*/
+double getTime()
+{
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+/**
+*@brief runCase method
+*
+*@details times one where condition with both evaluators and outputs
+*			nanoseconds per tuple
+*
+*@param [in] string condition - e.g. "pid = 500"
+*
+*@param [in] vector< Attribute > &attributes
+*
+*@param [in] vector< vector< string > > &tuples - the string tuples the ladder read
+*
+*@param [in] vector< Row > &rows - the same tuples as the rows the kernels read
+*
+*@return none (void)
+*/
+void runCase( string condition, vector< Attribute > &attributes, vector< vector< string > > &tuples, vector< Row > &rows )
+{
+	Predicate predicate;
+	predicate.parse( condition );
+	predicate.compile( attributes );
+
+	//the ladder took the single condition parsed word by word
+	WhereCondition wCond = predicate.root->wCond;
+	wCond.comparisonValueFloat = atof( wCond.comparisonValue.c_str() );
+
+	int tupleSize = tuples.size();
+	int ladderMatches = 0;
+	int compiledMatches = 0;
+	double ladderTime = 0;
+	double compiledTime = 0;
+
+	for( int repeat = 0; repeat < REPEAT_COUNT; repeat++ )
+	{
+		ladderMatches = 0;
+		double start = getTime();
+		for( int index = 0; index < tupleSize; index++ )
+		{
+			if( ladderConditionMet( wCond, tuples[ index ] ) )
+			{
+				ladderMatches++;
+			}
+		}
+		ladderTime += getTime() - start;
+
+		compiledMatches = 0;
+		start = getTime();
+		for( int index = 0; index < tupleSize; index++ )
+		{
+			if( predicate.evaluate( rows[ index ] ) )
+			{
+				compiledMatches++;
+			}
+		}
+		compiledTime += getTime() - start;
+	}
+
+	double ladderNs = ladderTime * 1000000000.0 / ( (double) tupleSize * REPEAT_COUNT );
+	double compiledNs = compiledTime * 1000000000.0 / ( (double) tupleSize * REPEAT_COUNT );
+	printf( "%-28s ladder %7.2f ns/tuple (%d)   compiled %7.2f ns/tuple (%d)   speedup %.2fx\n",
+		condition.c_str(), ladderNs, ladderMatches, compiledNs, compiledMatches, ladderNs / compiledNs );
+}
+
+int main( int argc, char ** argv )
+{
+	int tupleCount = DEFAULT_TUPLE_COUNT;
+	if( argc > 1 )
+	{
+		tupleCount = atoi( argv[ 1 ] );
+	}
+
+	vector< Attribute > attributes( 3 );
+	attributes[ 0 ].attributeName = "pid";
+	attributes[ 0 ].attributeType = "int";
+	attributes[ 1 ].attributeName = "name";
+	attributes[ 1 ].attributeType = "varchar(20)";
+	attributes[ 2 ].attributeName = "price";
+	attributes[ 2 ].attributeType = "float";
+
+	//tuples as strings, the way a table scan produced them for the ladder,
+	//and as the rows a table scan produces now
+	vector< vector< string > > tuples( tupleCount, vector< string >( 3 ) );
+	vector< Row > rows( tupleCount );
+	vector< int > columnTypes;
+	for( int index = 0; index < 3; index++ )
+	{
+		columnTypes.push_back( getValueType( attributes[ index ].attributeType ) );
+	}
+	char buffer[ 64 ];
+	srand( 457 );
+	for( int index = 0; index < tupleCount; index++ )
+	{
+		sprintf( buffer, "%d", index );
+		tuples[ index ][ 0 ] = buffer;
+		sprintf( buffer, "'Gizmo%d'", rand() % 100 );
+		tuples[ index ][ 1 ] = buffer;
+		sprintf( buffer, "%.2f", ( rand() % 20000 ) / 100.0 );
+		tuples[ index ][ 2 ] = buffer;
+		rows[ index ].reset( columnTypes );
+		for( int column = 0; column < 3; column++ )
+		{
+			rows[ index ].setValue( column, tuples[ index ][ column ] );
+		}
+	}
+
+	cout << "-- " << tupleCount << " tuples, averaged over " << REPEAT_COUNT << " passes" << endl;
+	runCase( "pid = 500", attributes, tuples, rows );
+	runCase( "pid != 500", attributes, tuples, rows );
+	runCase( "name = 'Gizmo42'", attributes, tuples, rows );
+	runCase( "name >= 'Gizmo50'", attributes, tuples, rows );
+	runCase( "price > 100", attributes, tuples, rows );
+	runCase( "price <= 19.99", attributes, tuples, rows );
+
+	return 0;
+}
@@ -0,0 +1,624 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file queryBench.cpp
+ *
+ * @brief Benchmark of every statement type on generated tables
+ *
+ * @details Generates a table of ints, floats and varchars of the size, width
+ *          and key skew asked for, and a table of its keys, then times
+ *          CREATE, bulk INSERT, point and range SELECT, UPDATE, DELETE, inner
+ *          and left outer join statements run through the same code as a
+ *          session. Every phase reports its throughput, latency percentiles
+ *          and the peak resident memory so far. The results can be saved and
+ *          compared with a later run
+ *
+ * @Note Build with make queryBench, run with make benchmark or
+ *       ./queryBench [options]
+ *
+ *       --rows n        records of the generated table (20000)
+ *       --width n       columns of the generated table, at least 4 (6)
+ *       --keys n        distinct join keys, the records of the key table (1000)
+ *       --skew s        zipf exponent of the keys, 0 for uniform (1.0)
+ *       --queries n     point and range selects, a tenth as many updates and
+ *                       deletes, a fortieth as many joins (200)
+ *       --batch n       inserts per transaction, 0 for one per insert (1000)
+ *       --dir path      where the database system is made and removed
+ *       --save file     writes the results to file
+ *       --compare file  compares the results with a saved run
+ *       --io, --read-ahead, --page-cache as for main
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "Database.h"
+#include "Io.h"
+#include "Storage.h"
+#include "Transaction.h"
+#include "PageCache.h"
+#include "ResultWriter.h"
+
+using namespace std;
+
+//declaration of the helper functions
+string loadDatabaseSystem( string currentWorkingDirectory, vector< Database > &dbms );
+bool removeSemiColon( string &input );
+bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase,
+	int &outputFormat, Transaction &transaction );
+extern PageCache pageCache;
+
+const int DEFAULT_ROW_COUNT = 20000;
+const int DEFAULT_COLUMN_COUNT = 6;
+const int DEFAULT_KEY_COUNT = 1000;
+const double DEFAULT_SKEW = 1.0;
+const int DEFAULT_QUERY_COUNT = 200;
+const int DEFAULT_BATCH_SIZE = 1000;
+//floats are generated below this, a range select takes about a hundredth
+const double FLOAT_RANGE = 1000.0;
+
+//output of the statements, counted and dropped. A line starting with the
+//failure marker of handleError is counted as a failure
+class DiscardBuffer : public streambuf{
+	public:
+		long long bytes;
+		int failures;
+
+		DiscardBuffer()
+		{
+			bytes = 0;
+			failures = 0;
+			matched = 0;
+		}
+
+	protected:
+		int overflow( int character )
+		{
+			if( character != EOF )
+			{
+				note( (char) character );
+			}
+			return character;
+		}
+
+		streamsize xsputn( const char * data, streamsize size )
+		{
+			for( streamsize index = 0; index < size; index++ )
+			{
+				note( data[ index ] );
+			}
+			return size;
+		}
+
+	private:
+		//characters of "\n-- !" matched so far, a new stream starts at a line
+		int matched;
+
+		void note( char character )
+		{
+			static const char marker[] = "\n-- !";
+			bytes++;
+			if( bytes == 1 )
+			{
+				matched = 1;
+			}
+			if( character == marker[ matched ] )
+			{
+				matched++;
+				if( marker[ matched ] == '\0' )
+				{
+					failures++;
+					matched = 0;
+				}
+			}
+			else
+			{
+				matched = character == '\n' ? 1 : 0;
+			}
+		}
+};
+
+//the state a session keeps between statements
+struct BenchSession{
+	vector< Database > dbms;
+	string systemPath;
+	string currentDatabase;
+	int outputFormat;
+	Transaction * transaction;
+};
+
+struct PhaseResult{
+	string name;
+	int statements;
+	int failures;
+	double seconds;
+	double percentiles[ 4 ];
+	long peakRss;
+};
+
+//percentiles reported, the last is the slowest statement
+const double PERCENTILES[ 4 ] = { 0.50, 0.95, 0.99, 1.0 };
+
+/**
+*@brief getTime method
+*
+*@details returns the wall clock time in seconds
+*
+*@return double
+*/
+double getTime()
+{
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+/**
+*@brief getPeakRss method
+*
+*@details returns the most memory the process has had resident, in kB
+*
+*@return long
+*/
+long getPeakRss()
+{
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return usage.ru_maxrss;
+}
+
+/**
+*@brief randomFraction method
+*
+*@details returns a number from 0 up to but not including 1
+*
+*@return double
+*/
+double randomFraction()
+{
+	return rand() / ( RAND_MAX + 1.0 );
+}
+
+/**
+*@brief getKeyWeights method
+*
+*@details returns the cumulative zipf weights of the keys, key i is drawn
+*			in proportion to 1 / ( i + 1 ) ^ skew
+*
+*@param [in] int keyCount
+*
+*@param [in] double skew
+*
+*@return vector< double > ending in 1
+*/
+vector< double > getKeyWeights( int keyCount, double skew )
+{
+	vector< double > weights( keyCount );
+	double total = 0;
+	for( int index = 0; index < keyCount; index++ )
+	{
+		total += 1.0 / pow( index + 1.0, skew );
+		weights[ index ] = total;
+	}
+	for( int index = 0; index < keyCount; index++ )
+	{
+		weights[ index ] /= total;
+	}
+	return weights;
+}
+
+int drawKey( const vector< double > &keyWeights )
+{
+	int key = upper_bound( keyWeights.begin(), keyWeights.end(), randomFraction() ) - keyWeights.begin();
+	return min( key, (int) keyWeights.size() - 1 );
+}
+
+/**
+*@brief getColumnType method
+*
+*@details returns the type of a column of the generated table: id and the
+*			join key are ints, then a float and a varchar, and the columns
+*			after them take turns
+*
+*@param [in] int column
+*
+*@return string
+*/
+string getColumnType( int column )
+{
+	const char * types[ 3 ] = { "int", "float", "varchar(20)" };
+	if( column < 2 )
+	{
+		return types[ 0 ];
+	}
+	return types[ ( column - 1 ) % 3 ];
+}
+
+string getColumnName( int column )
+{
+	const char * names[ 4 ] = { "id", "k", "f", "s" };
+	if( column < 4 )
+	{
+		return names[ column ];
+	}
+	char buffer[ 16 ];
+	sprintf( buffer, "c%d", column );
+	return buffer;
+}
+
+/**
+*@brief getInsert method
+*
+*@details returns the insert of one generated record
+*
+*@param [in] int id
+*
+*@param [in] int columnCount
+*
+*@param [in] const vector< double > &keyWeights
+*
+*@return string
+*/
+string getInsert( int id, int columnCount, const vector< double > &keyWeights )
+{
+	char buffer[ 64 ];
+	sprintf( buffer, "insert into t values(%d,%d", id, drawKey( keyWeights ) );
+	string statement = buffer;
+	for( int column = 2; column < columnCount; column++ )
+	{
+		string type = getColumnType( column );
+		if( type == "float" )
+		{
+			sprintf( buffer, ",%.2f", randomFraction() * FLOAT_RANGE );
+		}
+		else if( type == "int" )
+		{
+			sprintf( buffer, ",%d", rand() % 100000 );
+		}
+		else
+		{
+			sprintf( buffer, ",'Name%d'", rand() % 10000 );
+		}
+		statement += buffer;
+	}
+	return statement + ");";
+}
+
+/**
+*@brief runPhase method
+*
+*@details runs statements the way runSession does, timing each of them
+*
+*@param [in] string name
+*
+*@param [in] vector< string > &statements - each ending in a semicolon
+*
+*@param [in] BenchSession &session
+*
+*@return PhaseResult
+*/
+PhaseResult runPhase( string name, vector< string > &statements, BenchSession &session )
+{
+	PhaseResult result;
+	result.name = name;
+	result.statements = statements.size();
+
+	DiscardBuffer output;
+	streambuf * console = cout.rdbuf( &output );
+	vector< double > latencies;
+	double phaseStart = getTime();
+	for( int index = 0; index < result.statements; index++ )
+	{
+		string input = statements[ index ];
+		double start = getTime();
+		removeSemiColon( input );
+		startEvent( input, session.dbms, session.systemPath, session.currentDatabase, session.outputFormat,
+			*session.transaction );
+		latencies.push_back( getTime() - start );
+	}
+	result.seconds = getTime() - phaseStart;
+	cout.flush();
+	cout.rdbuf( console );
+
+	result.failures = output.failures;
+	sort( latencies.begin(), latencies.end() );
+	for( int index = 0; index < 4; index++ )
+	{
+		int rank = (int) ( PERCENTILES[ index ] * latencies.size() + 0.999999 ) - 1;
+		result.percentiles[ index ] = latencies.empty() ? 0 : latencies[ max( 0, rank ) ];
+	}
+	result.peakRss = getPeakRss();
+	return result;
+}
+
+void printResult( const PhaseResult &result )
+{
+	printf( "%-18s %7d %5d %9.3f %10.1f %9.3f %9.3f %9.3f %9.3f %10ld\n", result.name.c_str(),
+		result.statements, result.failures, result.seconds,
+		result.seconds > 0 ? result.statements / result.seconds : 0.0,
+		result.percentiles[ 0 ] * 1000, result.percentiles[ 1 ] * 1000, result.percentiles[ 2 ] * 1000,
+		result.percentiles[ 3 ] * 1000, result.peakRss );
+}
+
+/**
+*@brief saveResults method
+*
+*@details writes a line for each phase: its name, statements, seconds,
+*			percentiles and peak resident memory, separated by tabs
+*
+*@param [in] string filePath
+*
+*@param [in] vector< PhaseResult > &results
+*
+*@return none (void)
+*/
+void saveResults( string filePath, vector< PhaseResult > &results )
+{
+	ofstream fout( filePath.c_str() );
+	for( unsigned int index = 0; index < results.size(); index++ )
+	{
+		fout << results[ index ].name << "\t" << results[ index ].statements << "\t" << results[ index ].seconds;
+		for( int percentile = 0; percentile < 4; percentile++ )
+		{
+			fout << "\t" << results[ index ].percentiles[ percentile ];
+		}
+		fout << "\t" << results[ index ].peakRss << endl;
+	}
+	if( !fout )
+	{
+		cout << "-- !Failed to save the results to " << filePath << endl;
+	}
+}
+
+/**
+*@brief compareResults method
+*
+*@details outputs how the throughput and p95 latency of every phase changed
+*			since a saved run, above 1x is faster
+*
+*@param [in] string filePath
+*
+*@param [in] vector< PhaseResult > &results
+*
+*@return none (void)
+*/
+void compareResults( string filePath, vector< PhaseResult > &results )
+{
+	ifstream fin( filePath.c_str() );
+	if( !fin )
+	{
+		cout << "-- !Failed to compare with " << filePath << " because it could not be opened." << endl;
+		return;
+	}
+
+	cout << "-- compared with " << filePath << endl;
+	string line;
+	while( getline( fin, line ) )
+	{
+		vector< string > fields;
+		size_t start = 0;
+		size_t end;
+		while( ( end = line.find( '\t', start ) ) != string::npos )
+		{
+			fields.push_back( line.substr( start, end - start ) );
+			start = end + 1;
+		}
+		fields.push_back( line.substr( start ) );
+		if( fields.size() < 8 )
+		{
+			continue;
+		}
+
+		for( unsigned int index = 0; index < results.size(); index++ )
+		{
+			PhaseResult &result = results[ index ];
+			if( result.name != fields[ 0 ] || result.seconds <= 0 || result.percentiles[ 1 ] <= 0 )
+			{
+				continue;
+			}
+			double savedThroughput = atof( fields[ 1 ].c_str() ) / atof( fields[ 2 ].c_str() );
+			printf( "%-18s throughput %6.2fx   p95 latency %6.2fx   peak RSS %+ld kB\n", result.name.c_str(),
+				( result.statements / result.seconds ) / savedThroughput,
+				atof( fields[ 4 ].c_str() ) / result.percentiles[ 1 ],
+				result.peakRss - atol( fields[ 7 ].c_str() ) );
+		}
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	int rowCount = DEFAULT_ROW_COUNT;
+	int columnCount = DEFAULT_COLUMN_COUNT;
+	int keyCount = DEFAULT_KEY_COUNT;
+	double skew = DEFAULT_SKEW;
+	int queryCount = DEFAULT_QUERY_COUNT;
+	int batchSize = DEFAULT_BATCH_SIZE;
+	string savePath;
+	string comparePath;
+
+	char buffer[ 512 ];
+	getcwd( buffer, sizeof( buffer ) );
+	string benchDirectory = string( buffer ) + "/benchData";
+
+	for( int index = 1; index + 1 < argc; index += 2 )
+	{
+		string option = argv[ index ];
+		string value = argv[ index + 1 ];
+		if( option == "--rows" )
+		{
+			rowCount = max( 1, atoi( value.c_str() ) );
+		}
+		else if( option == "--width" )
+		{
+			columnCount = max( 4, atoi( value.c_str() ) );
+		}
+		else if( option == "--keys" )
+		{
+			keyCount = max( 1, atoi( value.c_str() ) );
+		}
+		else if( option == "--skew" )
+		{
+			skew = max( 0.0, atof( value.c_str() ) );
+		}
+		else if( option == "--queries" )
+		{
+			queryCount = max( 1, atoi( value.c_str() ) );
+		}
+		else if( option == "--batch" )
+		{
+			batchSize = max( 0, atoi( value.c_str() ) );
+		}
+		else if( option == "--dir" )
+		{
+			benchDirectory = value[ 0 ] == '/' ? value : string( buffer ) + "/" + value;
+		}
+		else if( option == "--save" )
+		{
+			savePath = value;
+		}
+		else if( option == "--compare" )
+		{
+			comparePath = value;
+		}
+		else if( option == "--io" )
+		{
+			IoQueue::setBackend( value == "threads" ? IO_BACKEND_THREADS : IO_BACKEND_URING );
+		}
+		else if( option == "--read-ahead" )
+		{
+			TableReader::setReadAhead( atoi( value.c_str() ) );
+		}
+		else if( option == "--page-cache" )
+		{
+			pageCache.resize( max( 0, atoi( value.c_str() ) ) );
+		}
+	}
+
+	//databases are made in the DatabaseSystem of the working directory
+	system( ( "rm -rf '" + benchDirectory + "' && mkdir -p '" + benchDirectory + "'" ).c_str() );
+	if( chdir( benchDirectory.c_str() ) != 0 )
+	{
+		cout << "-- !Failed to benchmark because " << benchDirectory << " could not be made." << endl;
+		return 1;
+	}
+	BenchSession session;
+	session.systemPath = loadDatabaseSystem( benchDirectory, session.dbms );
+	session.outputFormat = OUTPUT_PIPE;
+	Transaction transaction( session.systemPath + "/" + TRANSACTION_LOG_NAME );
+	session.transaction = &transaction;
+
+	srand( 457 );
+	vector< double > keyWeights = getKeyWeights( keyCount, skew );
+	vector< PhaseResult > results;
+	vector< string > statements;
+	char statement[ 256 ];
+
+	string columns;
+	for( int column = 0; column < columnCount; column++ )
+	{
+		columns += ( column > 0 ? ", " : "" ) + getColumnName( column ) + " " + getColumnType( column );
+	}
+	statements.push_back( "CREATE DATABASE bench;" );
+	statements.push_back( "USE bench;" );
+	statements.push_back( "create table t(" + columns + ");" );
+	statements.push_back( "create table d(k int, label varchar(20));" );
+	results.push_back( runPhase( "CREATE", statements, session ) );
+
+	//the key table holds every key, the keys the skew leaves out of the
+	//generated table have no match in a left outer join
+	statements.clear();
+	for( int index = 0; index < keyCount + rowCount; index++ )
+	{
+		if( batchSize > 0 && index % batchSize == 0 )
+		{
+			statements.push_back( "BEGIN TRANSACTION;" );
+		}
+		if( index < keyCount )
+		{
+			sprintf( statement, "insert into d values(%d,'Key%d');", index, index );
+			statements.push_back( statement );
+		}
+		else
+		{
+			statements.push_back( getInsert( index - keyCount, columnCount, keyWeights ) );
+		}
+		if( batchSize > 0 && ( index % batchSize == batchSize - 1 || index == keyCount + rowCount - 1 ) )
+		{
+			statements.push_back( "COMMIT;" );
+		}
+	}
+	results.push_back( runPhase( "INSERT", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < queryCount; index++ )
+	{
+		sprintf( statement, "select * from t where id = %d;", rand() % rowCount );
+		statements.push_back( statement );
+	}
+	results.push_back( runPhase( "SELECT point", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < queryCount; index++ )
+	{
+		sprintf( statement, "select id, f from t where f < %.2f;", randomFraction() * FLOAT_RANGE / 50 );
+		statements.push_back( statement );
+	}
+	results.push_back( runPhase( "SELECT range", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < max( 1, queryCount / 10 ); index++ )
+	{
+		sprintf( statement, "update t set f = %.2f where id = %d;", randomFraction() * FLOAT_RANGE, rand() % rowCount );
+		statements.push_back( statement );
+	}
+	results.push_back( runPhase( "UPDATE", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < max( 1, queryCount / 10 ); index++ )
+	{
+		sprintf( statement, "delete from t where id = %d;", rand() % rowCount );
+		statements.push_back( statement );
+	}
+	results.push_back( runPhase( "DELETE", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < max( 1, queryCount / 40 ); index++ )
+	{
+		statements.push_back( "select * from t T inner join d D on T.k = D.k;" );
+	}
+	results.push_back( runPhase( "INNER JOIN", statements, session ) );
+
+	statements.clear();
+	for( int index = 0; index < max( 1, queryCount / 40 ); index++ )
+	{
+		statements.push_back( "select * from d D left outer join t T on D.k = T.k;" );
+	}
+	results.push_back( runPhase( "LEFT OUTER JOIN", statements, session ) );
+
+	cout << "-- " << rowCount << " rows of " << columnCount << " columns, " << keyCount << " keys, skew " << skew
+		<< ", inserts per transaction " << batchSize << endl;
+	printf( "%-18s %7s %5s %9s %10s %9s %9s %9s %9s %10s\n", "phase", "stmts", "fails", "seconds", "stmts/s",
+		"p50 ms", "p95 ms", "p99 ms", "max ms", "peak kB" );
+	for( unsigned int index = 0; index < results.size(); index++ )
+	{
+		printResult( results[ index ] );
+	}
+
+	if( !comparePath.empty() )
+	{
+		compareResults( comparePath, results );
+	}
+	if( !savePath.empty() )
+	{
+		saveResults( savePath, results );
+	}
+	system( ( "rm -rf '" + benchDirectory + "'" ).c_str() );
+
+	return 0;
+}
@@ -28,7 +28,20 @@
 #include <fstream>
 #include <stdlib.h>
 #include <unistd.h>
-#include "Database.cpp"
+#include <chrono>
+#include "Database.h"
+#include "Lock.h"
+#include "Arena.h"
+#include "Storage.h"
+#include "Transaction.h"
+#include "Operator.h"
+#include "ResultWriter.h"
+#include "Metrics.h"
+#include "SlowQueryLog.h"
+#include "ResultCache.h"
+#include "MaterializedView.h"
+#include "Catalog.h"
+#include "NameIndex.h"
 
 #include <stdio.h>
 
@@ -36,6 +49,8 @@ using namespace std;
 
 const string DATABASE_TYPE = "DATABASE";
 const string TABLE_TYPE = "TABLE";
+const string MATERIALIZED_TYPE = "MATERIALIZED";
+const string VIEW_TYPE = "VIEW";
 
 const string DROP = "DROP";
 const string CREATE = "CREATE";
@@ -45,6 +60,17 @@ const string ALTER = "ALTER";
 const string INSERT = "INSERT";
 const string UPDATE = "UPDATE";
 const string DELETE = "DELETE";
+const string ANALYZE = "ANALYZE";
+const string EXPLAIN = "EXPLAIN";
+const string SET = "SET";
+const string OUTPUT = "OUTPUT";
+const string BEGIN = "BEGIN";
+const string TRANSACTION = "TRANSACTION";
+const string COMMIT = "COMMIT";
+const string ROLLBACK = "ROLLBACK";
+const string SHOW = "SHOW";
+const string STATS = "STATS";
+const string REFRESH = "REFRESH";
 const string EXIT = ".EXIT";
 
 const int ERROR_DB_EXISTS = -1;
@@ -52,9 +78,29 @@ const int ERROR_DB_NOT_EXISTS = -2;
 const int ERROR_TBL_EXISTS = -3;
 const int ERROR_TBL_NOT_EXISTS = -4;
 const int ERROR_INCORRECT_COMMAND = -5;
+const int ERROR_TBL_LOCKED = -6;
+const int ERROR_TBL_IS_VIEW = -7;
+const int ERROR_TBL_HAS_VIEWS = -8;
+const int ERROR_DB_NOT_USED = -9;
+
+//the sessions of a server share the databases: a statement holds this
+//shared while it runs, or exclusive if it adds or removes a database or table
+ReadWriteLock catalogLock;
+//held while the tables of a database are read on its first use, which
+//only needs the catalog shared
+mutex databaseLoadMutex;
+//positions of the databases in dbms by name, dbms is loaded once and only
+//changed holding catalogLock exclusively
+NameIndex databaseIndex;
 
 //main implementation
 void startSimulation( string currentWorkingDirectory );
+//reads the databases and tables on disk
+string loadDatabaseSystem( string currentWorkingDirectory, vector< Database > &dbms );
+//reads the tables of a database on its first use
+void loadDatabase( string databaseSystemPath, Database &database );
+//runs the statements of one session
+void runSession( istream &in, vector< Database > &dbms, string currentWorkingDirectory );
 //checks if exit command has been called
 bool exitCheck( string str );
 //checks that input string is command not garbage
@@ -62,11 +108,17 @@ bool stringValid( string str );
 //removes semicolon for easier parsing
 bool removeSemiColon( string &input );
 //starts specific action (aka create)
-bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase );
+bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase,
+	int &outputFormat, Transaction &transaction );
+//finishes or drops a commit cut short
+void recoverTransactions( string databaseSystemPath );
 //helper function to get next word for parsing
 string getNextWord( string &input );
 //helper function to check that db exists
-bool databaseExists( vector<Database> dbms, Database dbInput, int &dbReturn );
+bool databaseExists( vector<Database> &dbms, Database &dbInput, int &dbReturn );
+//finds the database in use, or the error of a statement that needs one
+bool findCurrentDatabase( vector< Database > &dbms, string currentDatabase, int &dbReturn, int &errorType,
+	string &errorContainerName );
 //removes database from vector and deletes from disk
 void removeDatabase( vector< Database > &dbms, int index );
 //removes table from disk and vector
@@ -83,25 +135,36 @@ string getQueryType( string &input );
 string getWhereCondition( string &input );
 //returns set condition for update table
 string getSetCondition( string &input );
+//removes limit and offset clauses from the end of a query
+void getLimitCondition( string &input, QueryLimit &qLimit );
+//checks that a string holds only a number
+bool isNumber( string input );
 //removes new line chars from strings for easier parsing
 void removeNewLine( string &input );
 //returns next word without deleting word from input string
 string returnNextWord( string input );
-//checks for inner join (a comma b/w table names)
-bool checkJoin( string & input, string &LHS );
-//checks for inner join
-bool checkInnerJoin( string & input, string &LHS  );
-//checks for left outer join
-bool checkOuterJoin( string & input, string &LHS  );
-//helper function, gets the table variable
-string getTableVariable( string &input );
-//helper function, gets LHS and stores RHS of = join into input
-string returnLHSJoinComparison( string &input );
-//helper parse function, gets LHS 
-string getOnCondition( string &input );
+//checks if a word is part of a join clause
+bool isJoinKeyword( string word );
+//parses the tables of a from clause and how they are joined
+bool getJoinTables( string input, vector< JoinTable > &joinTables );
+//finds an output format by name
+int getOutputFormat( string formatName );
+//arena of the running statement
+Arena &statementArena();
+string getStatisticsPath( string currentWorkingDirectory, string currentDatabase, string tblName );
+void removeLeadingWS( string &input );
+bool caseInsCompare( string s1, string s2 );
+vector< string > tokenizeCondition( string input );
 
 void removeCarriageReturn( string &input );
 
+bool lockViews( StatementLocks &locks, Transaction &transaction, string currentWorkingDirectory, string currentDatabase,
+	Database &database, string tblName, bool &hasViews, string &lockedName );
+void lockCatalogChange( ReadWriteGuard &catalog, StatementLocks &locks, vector< Database > &dbms, string currentDatabase,
+	string actionType, string input );
+
+string getViewPath( string currentWorkingDirectory, string currentDatabase, string viewName );
+
 /**
  * @brief read_Directory method
  *
@@ -141,8 +204,7 @@ bool read_directory(const std::string& name, vector< string >& v)
  * @post Program ends when .EXIT is inputted
  *
  * @par Algorithm 
- *      Loop until .EXIT is inputted from terminal
- *		Otherwise parse string to find out what action to take
+ *      Loads the databases then runs one session reading from the terminal
  *      
  * @exception None
  *
@@ -155,6 +217,34 @@ bool read_directory(const std::string& name, vector< string >& v)
  * @note None
  */
 void startSimulation( string currentWorkingDirectory )
+{
+	vector< Database > dbms;
+
+	currentWorkingDirectory = loadDatabaseSystem( currentWorkingDirectory, dbms );
+	runSession( cin, dbms, currentWorkingDirectory );
+}
+
+/**
+ * @brief loadDatabaseSystem
+ *
+ * @details reads the databases on disk into dbms, the tables of each are
+ *          read when it is first used
+ *
+ * @par Algorithm creates the database system directory if it does not exist,
+ *      and finishes a commit cut short, then reads the catalog of the
+ *      database system. If there is none, every directory in the database
+ *      system directory is a database, and the catalog is written from them.
+ *      The databases are then indexed by name
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [out] vector< Database > &dbms
+ *
+ * @return string path of the database system directory
+ *
+ * @note None
+ */
+string loadDatabaseSystem( string currentWorkingDirectory, vector< Database > &dbms )
 {
 	currentWorkingDirectory += "/DatabaseSystem";
 
@@ -165,58 +255,139 @@ void startSimulation( string currentWorkingDirectory )
 		// if not, create it.
 		system( ( "mkdir " + currentWorkingDirectory ).c_str() );
 	}
+	recoverTransactions( currentWorkingDirectory );
 
-	string input;
-	string temp;
-	string currentDatabase;
-	vector< Database > dbms;
-
-	// Retrieve all of the information about existing directories
-	vector< string > directoryItems;
-	if( read_directory( currentWorkingDirectory, directoryItems ) )
+	if( !Catalog::loadDatabases( currentWorkingDirectory, dbms ) )
 	{
-		for( unsigned int i = 0; i < directoryItems.size(); i++ )
+		// Retrieve all of the information about existing directories
+		vector< string > directoryItems;
+		if( read_directory( currentWorkingDirectory, directoryItems ) )
 		{
-			if(directoryItems[i] == "." || directoryItems[i] == "..")
+			for( unsigned int i = 0; i < directoryItems.size(); i++ )
 			{
-				directoryItems.erase(directoryItems.begin() + i);
-				i--;
+				//skip . and .. as well as hidden files such as the transaction log
+				if( directoryItems[i][0] != '.' )
+				{
+					Database tempDatabase;
+					tempDatabase.databaseName = directoryItems[i];
+					dbms.push_back(tempDatabase);
+				}
 			}
-			else
-			{
-				Database tempDatabase;
-				tempDatabase.databaseName = directoryItems[i];
+		}
+		Catalog::saveDatabases( currentWorkingDirectory, dbms );
+	}
+
+	databaseIndex.clear();
+	int dbSize = dbms.size();
+	for( int db = 0; db < dbSize; db++ )
+	{
+		databaseIndex.add( dbms[ db ].databaseName, db );
+	}
+	return currentWorkingDirectory;
+}
+
+/**
+ * @brief loadDatabase
+ *
+ * @details reads the tables of a database on disk, if they were not read
+ *          yet
+ *
+ * @par Algorithm reads the catalog of the database. If there is none, every
+ *      file in the database directory that is not hidden is one of its
+ *      tables, and the catalog is written from them. The directory is read
+ *      either way, private versions of transactions that never committed
+ *      are removed from it, until then they are never read
+ *
+ * @param [in] string databaseSystemPath
+ *
+ * @param [in/out] Database &database
+ *
+ * @return None
+ *
+ * @note sessions using a database for the first time at once read it once
+ */
+void loadDatabase( string databaseSystemPath, Database &database )
+{
+	lock_guard< mutex > guard( databaseLoadMutex );
+	if( database.tablesLoaded )
+	{
+		return;
+	}
 
-				vector< string > tableItems;
-				Table tempTable;
+	bool catalogLoaded = Catalog::loadTables( databaseSystemPath, database );
+	vector< string > tableItems;
+	Table tempTable;
 
-				if( read_directory( currentWorkingDirectory + "/" + tempDatabase.databaseName, tableItems ) )
+	if( read_directory( databaseSystemPath + "/" + database.databaseName, tableItems ) )
+	{
+		for( unsigned int j = 0; j < tableItems.size(); j++ )
+		{
+			//skip . and .. as well as hidden working files such as .tbl.tmp,
+			//private versions of transactions that never committed are removed
+			if( tableItems[j][0] == '.' )
+			{
+				if( tableItems[j].find( ".txn" ) != string::npos )
 				{
-					for( unsigned int j = 0; j < tableItems.size(); j++ )
-					{
-						if(tableItems[j] == "." || tableItems[j] == "..")
-						{
-							tableItems.erase(tableItems.begin() + j);
-							j--;
-						}
-						else
-						{
-							tempTable.tableName = tableItems[j];
-
-							tempDatabase.databaseTable.push_back(tempTable);
-						}
-					}
+					remove( ( databaseSystemPath + "/" + database.databaseName + "/" + tableItems[j] ).c_str() );
 				}
+			}
+			else if( !catalogLoaded )
+			{
+				tempTable.tableName = tableItems[j];
+				tempTable.statistics.load( getStatisticsPath( databaseSystemPath,
+					database.databaseName, tempTable.tableName ) );
+				tempTable.viewQuery = MaterializedView::load( getViewPath( databaseSystemPath,
+					database.databaseName, tempTable.tableName ) );
 
-				dbms.push_back(tempDatabase);
+				database.tableAdd(tempTable);
 			}
 		}
 	}
+	if( !catalogLoaded )
+	{
+		Catalog::saveTables( databaseSystemPath, database );
+	}
+	database.tablesLoaded = true;
+}
+
+/**
+ * @brief runSession
+ *
+ * @details runs the statements of one session until .EXIT is inputted or
+ *          the input ends
+ *
+ * @par Algorithm 
+ *      Loop until .EXIT is inputted
+ *		Otherwise parse string to find out what action to take. The session
+ *		has its own current database, output format and transaction, the
+ *		databases are shared with the other sessions of a server. A
+ *		transaction still open when the session ends is rolled back
+ *
+ * @param [in] istream &in - the statements
+ *
+ * @param [in] vector< Database > &dbms
+ *
+ * @param [in] string currentWorkingDirectory - the database system directory
+ *
+ * @return None
+ *
+ * @note None
+ */
+void runSession( istream &in, vector< Database > &dbms, string currentWorkingDirectory )
+{
+	string input;
+	string temp;
+	string currentDatabase;
+	int outputFormat = OUTPUT_PIPE;
+	Transaction transaction( currentWorkingDirectory + "/" + TRANSACTION_LOG_NAME );
 
 	bool simulationEnd = false;
 	do{
 		
-		getline( cin, input );
+		if( !getline( in, input ) )
+		{
+			break;
+		}
 
 		//converts dos to unix file by removing file \r
 		removeCarriageReturn( input );
@@ -229,7 +400,7 @@ void startSimulation( string currentWorkingDirectory )
 		
 		if( !simulationEnd && stringValid( input )  && !removeSemiColon( input ) )
 		{
-			getline( cin, temp, ';' );
+			getline( in, temp, ';' );
 			input = input + temp;
 			removeCarriageReturn( input );
 			removeNewLine( input );
@@ -241,7 +412,7 @@ void startSimulation( string currentWorkingDirectory )
 		if(  !simulationEnd && stringValid( input ) ) 
 		{ 
 			//call helper function to check if modifying db or tbl
-			simulationEnd = startEvent( input, dbms, currentWorkingDirectory, currentDatabase );
+			simulationEnd = startEvent( input, dbms, currentWorkingDirectory, currentDatabase, outputFormat, transaction );
 		}
 	}while( simulationEnd == false );
 
@@ -364,15 +535,25 @@ bool removeSemiColon( string &input )
  *
  * @param [out] dbms provides system of database to add databases and tables
  *
+ * @param [out] outputFormat provides output format of the session, changed
+ *              by SET OUTPUT
+ *
+ * @param [out] transaction provides transaction of the session, started by
+ *              BEGIN and ended by COMMIT or ROLLBACK
+ *
  * @return None
  *
  * @note None
  */
-bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase )
+bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase,
+	int &outputFormat, Transaction &transaction )
 {
 	bool exitProgram = false;
 	bool errorExists = false;
 	bool attrError = false;
+	//whether materialized views read the table a statement writes
+	bool hasViews = false;
+	TableDelta delta;
 
 	//bool tblExists;
 	int dbReturn;
@@ -388,150 +569,167 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 
 	string containerType;
 
-	if( caseInsCompare( actionType, SELECT ) )
+	//EXPLAIN [ANALYZE] outputs the plan of the select that follows it
+	int explainMode = EXPLAIN_NONE;
+	if( actionType.compare( EXPLAIN ) == 0 )
 	{
+		explainMode = EXPLAIN_PLAN;
+		temp = getNextWord( input );
+		convertToUC( temp );
+		if( temp.compare( ANALYZE ) == 0 )
+		{
+			explainMode = EXPLAIN_ANALYZE;
+			temp = getNextWord( input );
+			convertToUC( temp );
+		}
 
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
+		//only a select can be explained, anything else is an incorrect command
+		if( temp.compare( SELECT ) == 0 )
+		{
+			actionType = temp;
+		}
+	}
+
+	//times the statement and counts it by type, an explained select counts
+	//as an explain
+	StatementClock clock( Metrics::findStatementType( explainMode != EXPLAIN_NONE ? EXPLAIN : actionType ) );
+
+	//adding or removing a database or table, or analyzing a table, changes
+	//dbms and the catalog file, any other statement only looks in it.
+	//Tables are locked as they are found, a select reads snapshots of its
+	//tables. The tables a transaction writes stay locked until it ends.
+	//A statement changing the catalog never waits for a table holding it,
+	//every other session would wait too, a commit included
+	bool changesCatalog = !transaction.isOpen() && ( caseInsCompare( actionType, CREATE ) ||
+		caseInsCompare( actionType, DROP ) || caseInsCompare( actionType, ANALYZE ) );
+	ReadWriteGuard catalog( catalogLock, changesCatalog );
+	StatementLocks locks;
+	if( changesCatalog )
+	{
+		lockCatalogChange( catalog, locks, dbms, currentDatabase, actionType, input );
+	}
+	StatementSnapshots snapshots;
+	if( changesCatalog )
+	{
+		Catalog::invalidate( currentWorkingDirectory, currentDatabase );
+	}
+
+	//changes to databases and tables are not part of a transaction
+	if( transaction.isOpen() && ( caseInsCompare( actionType, CREATE ) || caseInsCompare( actionType, DROP ) ||
+		caseInsCompare( actionType, ALTER ) || caseInsCompare( actionType, ANALYZE ) ) )
+	{
+		temp = actionType;
+		convertToLC( temp );
+		cout << "-- !Failed to " << temp << " because a transaction is open." << endl;
+	}
+	else if( caseInsCompare( actionType, SELECT ) )
+	{
+		//get limit and offset before the rest of the query is parsed
+		QueryLimit qLimit;
+		getLimitCondition( input, qLimit );
 
 		//get all words before from
 		string qType = getQueryType( input );
 
-		//get table name
-		string tName = getNextWord( input );
+		//get the where condition, leaving the tables in input
+		string cType = getWhereCondition( input );
 
+		vector< JoinTable > joinTables;
 		Table tblTemp;
-		tblTemp.tableName = tName;
 
-		//join parsing
-		if( returnNextWord( input ) != "where" && !returnNextWord( input ).empty() )
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( !getJoinTables( input, joinTables ) )
+		{
+			errorExists = true;
+			errorType = ERROR_INCORRECT_COMMAND;
+			errorContainerName = originalInput;
+		}
+		//normal query parsing and output
+		else if( joinTables.size() == 1 )
 		{
-			string table1Var; 
-			string table2Var;
-			string table1Attr;
-			string table2Attr;
-			string joinCondition;
-			Table tblTemp2;
+			tblTemp.tableName = joinTables[ 0 ].tableName;
 
-			if( checkJoin( input, table1Var ) )
+			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getWhereCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
-
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
-				{
-					errorExists = true;
-					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
-				}
-				else
-				{
-					tblTemp.innerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
-				}
+				errorExists = true;
+				errorType = ERROR_TBL_NOT_EXISTS;
+				errorContainerName = tblTemp.tableName;		
 			}
-			else if( checkInnerJoin( input, table1Var ) )
+			else
 			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getOnCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
-
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
+				tblTemp.tableName = dbms[ dbReturn ].databaseTable[ tblReturn ].tableName;
+				if( !locks.lockTable( currentDatabase, tblTemp.tableName, LOCK_INTENT_SHARED ) )
 				{
 					errorExists = true;
-					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
+					errorType = ERROR_TBL_LOCKED;
+					errorContainerName = tblTemp.tableName;
 				}
 				else
 				{
-					tblTemp.innerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
+					//a result cached while the table was as it is now is
+					//output without running the query
+					vector< string > filePaths( 1, currentWorkingDirectory + "/" + currentDatabase + "/" + tblTemp.tableName );
+					CachedQuery cached( currentDatabase, outputFormat, originalInput, filePaths,
+						explainMode == EXPLAIN_NONE && !transaction.isOpen() );
+					if( !cached.output() )
+					{
+						snapshots.take( filePaths );
+						dbms[ dbReturn ].databaseTable[ tblReturn ].tableSelect( currentWorkingDirectory, currentDatabase, cType, qType, qLimit, explainMode, outputFormat );
+					}
 				}
 			}
-			else if( checkOuterJoin( input, table1Var ) )
+		}
+		//join of two or more tables
+		else
+		{
+			int tableSize = joinTables.size();
+			//the table files as they are named when written
+			vector< string > cachePaths;
+			for( int index = 0; index < tableSize && !errorExists; index++ )
 			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getOnCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
-
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
+				if( !dbms[ dbReturn ].tableExists( joinTables[ index ].tableName, tblReturn ) )
 				{
 					errorExists = true;
 					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
+					errorContainerName = joinTables[ index ].tableName;
 				}
 				else
 				{
-					tblTemp.outerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
+					joinTables[ index ].statistics = &dbms[ dbReturn ].databaseTable[ tblReturn ].statistics;
+					cachePaths.push_back( currentWorkingDirectory + "/" + currentDatabase + "/" +
+						dbms[ dbReturn ].databaseTable[ tblReturn ].tableName );
 				}
 			}
 
-		}
-		//normal query parsing and output
-		else
-		{
-			string cType = getWhereCondition( input );
-
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+			vector< string > filePaths;
+			if( !errorExists )
 			{
-				errorExists = true;
-				errorType = ERROR_TBL_NOT_EXISTS;
-				errorContainerName = tblTemp.tableName;		
+				for( int index = 0; index < tableSize && !errorExists; index++ )
+				{
+					if( !locks.lockTable( currentDatabase, joinTables[ index ].tableName, LOCK_INTENT_SHARED ) )
+					{
+						errorExists = true;
+						errorType = ERROR_TBL_LOCKED;
+						errorContainerName = joinTables[ index ].tableName;
+					}
+					filePaths.push_back( currentWorkingDirectory + "/" + currentDatabase + "/" + joinTables[ index ].tableName );
+				}
 			}
-			else
+
+			if( !errorExists )
 			{
-				tblTemp.tableSelect( currentWorkingDirectory, currentDatabase, cType, qType );
+				CachedQuery cached( currentDatabase, outputFormat, originalInput, cachePaths,
+					explainMode == EXPLAIN_NONE && !transaction.isOpen() );
+				if( !cached.output() )
+				{
+					snapshots.take( filePaths );
+
+					tblTemp.tableName = joinTables[ 0 ].tableName;
+					tblTemp.tableJoin( currentWorkingDirectory, currentDatabase, joinTables, cType, qType, qLimit, explainMode, outputFormat );
+				}
 			}
 		}
 
@@ -548,6 +746,7 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		{
 			//if it does then set current database as string
 			currentDatabase = dbTemp.databaseName;
+			loadDatabase( currentWorkingDirectory, dbms[ dbReturn ] );
 			dbTemp.databaseUse();
 		}
 		else
@@ -584,6 +783,8 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			else
 			{
 				//if it does not, return success message and push onto vector
+				dbTemp.tablesLoaded = true;
+				databaseIndex.add( dbTemp.databaseName, dbms.size() );
 				dbms.push_back( dbTemp );
 
 				//create directory
@@ -594,11 +795,6 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		else if( caseInsCompare( containerType, TABLE_TYPE ) )
 		{
 			//call create tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			//get dbReturn of database
-			databaseExists( dbms, dbTemp, dbReturn );
-			
 			// make sure the input does not specify multiple tables 
 			size_t pos = input.find("(");
 			string temp = input.substr(0, pos);
@@ -609,14 +805,18 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			tblTemp.tableName = getNextWord( temp );
 
 			//check that table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+			if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+			{
+				errorExists = true;
+			}
+			else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 			{
 				//check that table attributes are not the same
 				tblTemp.tableCreate( currentWorkingDirectory, currentDatabase, tblTemp.tableName, input, attrError );
 				if( !attrError  )
 				{
 					//if it doesnt then push table onto database	
-					dbms[ dbReturn ].databaseTable.push_back( tblTemp );
+					dbms[ dbReturn ].tableAdd( tblTemp );
 				}
 			}
 			else
@@ -627,6 +827,66 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			 	errorContainerName = tblTemp.tableName;	
 			}
 		}
+		//materialized view create, CREATE MATERIALIZED VIEW name AS select
+		else if( containerType == MATERIALIZED_TYPE )
+		{
+			temp = getNextWord( input );
+			convertToUC( temp );
+			string viewName = getNextWord( input );
+			string asWord = getNextWord( input );
+			removeLeadingWS( input );
+
+			if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+			{
+				errorExists = true;
+			}
+			else if( temp != VIEW_TYPE || viewName.empty() || !caseInsCompare( asWord, "as" ) )
+			{
+				errorExists = true;
+				errorType = ERROR_INCORRECT_COMMAND;
+				errorContainerName = originalInput;
+			}
+			else if( dbms[ dbReturn ].tableExists( viewName, tblReturn ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_EXISTS;
+				errorContainerName = viewName;
+			}
+			else
+			{
+				//the tables read are locked exclusively, so none has changes
+				//of an open transaction the view would never be told of
+				QueryLimit qLimit;
+				string query = input;
+				getLimitCondition( query, qLimit );
+				getQueryType( query );
+				getWhereCondition( query );
+				vector< JoinTable > joinTables;
+				getJoinTables( query, joinTables );
+				int tableSize = joinTables.size();
+				for( int index = 0; index < tableSize && !errorExists; index++ )
+				{
+					if( dbms[ dbReturn ].tableExists( joinTables[ index ].tableName, tblReturn ) &&
+						!locks.lockTable( currentDatabase, dbms[ dbReturn ].databaseTable[ tblReturn ].tableName, LOCK_EXCLUSIVE ) )
+					{
+						errorExists = true;
+						errorType = ERROR_TBL_LOCKED;
+						errorContainerName = joinTables[ index ].tableName;
+					}
+				}
+
+				string errorMessage;
+				if( !errorExists && MaterializedView::create( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+					viewName, input, errorMessage ) )
+				{
+					cout << "-- Materialized view " << viewName << " created." << endl;
+				}
+				else if( !errorExists )
+				{
+					cout << "-- !Failed to create materialized view " << viewName << " because " << errorMessage << "." << endl;
+				}
+			}
+		}
 		else
 		{
 			errorExists = true;
@@ -655,6 +915,10 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 				errorContainerName = dbTemp.databaseName;
 				errorType = ERROR_DB_NOT_EXISTS; 
 			}
+			else if( !locks.lockDatabase( dbTemp.databaseName, LOCK_EXCLUSIVE ) )
+			{
+				cout << "-- !Failed to drop database " << dbTemp.databaseName << " because it is locked." << endl;
+			}
 			else
 			{
 				//if it does, return success message and remove from dbReturn element
@@ -666,27 +930,68 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 
 
 		}
-		else if( containerType == TABLE_TYPE )
+		else if( containerType == TABLE_TYPE || containerType == MATERIALIZED_TYPE )
 		{
 			//call drop tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			databaseExists( dbms, dbTemp, dbReturn );
+			//DROP MATERIALIZED VIEW name drops a view, DROP TABLE any other table
+			bool dropView = ( containerType == MATERIALIZED_TYPE );
+			if( dropView )
+			{
+				temp = getNextWord( input );
+				convertToUC( temp );
+			}
 
 			Table tblTemp;
 			tblTemp.tableName = getNextWord( input );
 
+			if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+			{
+				errorExists = true;
+			}
+			else if( dropView && temp != VIEW_TYPE )
+			{
+				errorExists = true;
+				errorType = ERROR_INCORRECT_COMMAND;
+				errorContainerName = originalInput;
+			}
 			//check if table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+			else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 			{
 				//if it doesnt exist then return error
 				errorExists = true;
 				errorType = ERROR_TBL_NOT_EXISTS;
 				errorContainerName = tblTemp.tableName;
 			}
+			else if( dropView != !dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
+			{
+				if( dropView )
+				{
+					cout << "-- !Failed to drop materialized view " << tblTemp.tableName << " because it is not one." << endl;
+				}
+				else
+				{
+					errorExists = true;
+					errorType = ERROR_TBL_IS_VIEW;
+					errorContainerName = tblTemp.tableName;
+				}
+			}
+			else if( MaterializedView::hasDependents( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+				tblTemp.tableName ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_HAS_VIEWS;
+				errorContainerName = tblTemp.tableName;
+			}
+			else if( !locks.lockTable( currentDatabase, tblTemp.tableName, LOCK_EXCLUSIVE ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_LOCKED;
+				errorContainerName = tblTemp.tableName;
+			}
 			else
 			{
 				//table exists and remove from database
+				tblTemp.viewQuery = dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery;
 				removeTable( dbms, dbReturn, tblReturn );
 
 				//remove table/file
@@ -706,25 +1011,49 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		if( containerType == TABLE_TYPE )
 		{
 			//call alter tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			databaseExists( dbms, dbTemp, dbReturn );
-
 			Table tblTemp;
 			tblTemp.tableName = getNextWord( input );
 
 			//check if table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+			if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+			{
+				errorExists = true;
+			}
+			else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 			{
 				//if it doesnt exist then return error
 				errorExists = true;
 				errorType = ERROR_TBL_NOT_EXISTS;
 				errorContainerName = tblTemp.tableName;
 			}
+			else if( !dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_IS_VIEW;
+				errorContainerName = tblTemp.tableName;
+			}
+			else if( !locks.lockTable( currentDatabase, tblTemp.tableName, LOCK_EXCLUSIVE ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_LOCKED;
+				errorContainerName = tblTemp.tableName;
+			}
+			else if( !lockViews( locks, transaction, currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+				tblTemp.tableName, hasViews, errorContainerName ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_LOCKED;
+			}
 			else
 			{
 				//remove table/file
 				tblTemp.tableAlter( currentWorkingDirectory, currentDatabase, input, attrError );	
+
+				//the views over the table are run again with its attributes
+				if( !attrError && hasViews )
+				{
+					MaterializedView::update( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], tblTemp.tableName, NULL );
+				}
 			}
 		}
 	}
@@ -739,41 +1068,58 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			errorContainerName = originalInput;	
 		}
 
-		//check that current db exists
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
-
 		//get table 
 		Table tblTemp;
 		tblTemp.tableName = getNextWord( input );
 
 
-		//check if table exists
-		if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+		//check that current db and table exist
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 		{
 			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
 			errorContainerName = tblTemp.tableName;
 		}
-		else if( !errorExists )
+		else if( !errorExists && !dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
 		{
-			//table exists and we can modify it
-			//return only stuff between parentheses
-			input.erase( 0, input.find( "(" ) + 1 );
-			input.erase( input.find_last_of( ")" ), input.length()-1 );
+			errorExists = true;
+			errorType = ERROR_TBL_IS_VIEW;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !errorExists && !transaction.lockTable( locks, currentDatabase, tblTemp.tableName, LOCK_INTENT_EXCLUSIVE ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !errorExists && !lockViews( locks, transaction, currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+			tblTemp.tableName, hasViews, errorContainerName ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+		}
+		else if( !errorExists )
+		{
+			//table exists and we can modify it
+			//return only stuff between parentheses
+			input.erase( 0, input.find( "(" ) + 1 );
+			input.erase( input.find_last_of( ")" ), input.length()-1 );
 
-			tblTemp.tableInsert( currentWorkingDirectory, currentDatabase, tblTemp.tableName, input, attrError );
+			tblTemp.tableInsert( currentWorkingDirectory, currentDatabase, tblTemp.tableName, input, attrError,
+				hasViews ? &delta : NULL );
+			if( hasViews )
+			{
+				MaterializedView::update( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], tblTemp.tableName, &delta );
+			}
 		}	
 	}
 	else if( actionType.compare( UPDATE ) == 0 )
 	{
-		//get index of curr DB
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
-
 		//get table name
 		Table tblTemp;
 		tblTemp.tableName = getNextWord( input );
@@ -785,26 +1131,47 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		string sCond = getSetCondition( input );
 	
 		//check if table exists
-		if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 		{
 			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
 			errorContainerName = tblTemp.tableName;
 		}
+		else if( !dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_IS_VIEW;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !transaction.lockTable( locks, currentDatabase, tblTemp.tableName, LOCK_INTENT_EXCLUSIVE ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !lockViews( locks, transaction, currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+			tblTemp.tableName, hasViews, errorContainerName ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+		}
 		else
 		{
 			//update values
-			tblTemp.tableUpdate( currentWorkingDirectory, currentDatabase, wCond, sCond );
+			tblTemp.tableUpdate( currentWorkingDirectory, currentDatabase, wCond, sCond, hasViews ? &delta : NULL );
+			if( hasViews )
+			{
+				MaterializedView::update( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], tblTemp.tableName, &delta );
+			}
 		}
 	}
 	else if( actionType.compare( DELETE ) == 0 )
 	{
-		//get index of curr DB
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
-
 		string temp = getQueryType( input );
 		//get table name
 		Table tblTemp;
@@ -814,17 +1181,270 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		string wCond = getWhereCondition( input );
 	
 		//check if table exists
-		if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
 		{
 			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
 			errorContainerName = tblTemp.tableName;
 		}
+		else if( !dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_IS_VIEW;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !transaction.lockTable( locks, currentDatabase, tblTemp.tableName, LOCK_INTENT_EXCLUSIVE ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( !lockViews( locks, transaction, currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+			tblTemp.tableName, hasViews, errorContainerName ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+		}
 		else
 		{
 			//update values
-			tblTemp.tableDelete( currentWorkingDirectory, currentDatabase, wCond );
+			tblTemp.tableDelete( currentWorkingDirectory, currentDatabase, wCond, hasViews ? &delta : NULL );
+			if( hasViews )
+			{
+				MaterializedView::update( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], tblTemp.tableName, &delta );
+			}
+		}
+	}
+	else if( actionType.compare( ANALYZE ) == 0 )
+	{
+		string tName = getNextWord( input );
+
+		//analyze every table of the database if none is named
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( tName.empty() )
+		{
+			int tblSize = dbms[ dbReturn ].databaseTable.size();
+			for( int index = 0; index < tblSize && !errorExists; index++ )
+			{
+				if( !locks.lockTable( currentDatabase, dbms[ dbReturn ].databaseTable[ index ].tableName, LOCK_EXCLUSIVE ) )
+				{
+					errorExists = true;
+					errorType = ERROR_TBL_LOCKED;
+					errorContainerName = dbms[ dbReturn ].databaseTable[ index ].tableName;
+				}
+				else
+				{
+					dbms[ dbReturn ].databaseTable[ index ].tableAnalyze( currentWorkingDirectory, currentDatabase );
+				}
+			}
+		}
+		else if( !(dbms[ dbReturn ].tableExists( tName, tblReturn )) )
+		{
+			//if it doesnt exist then return error
+			errorExists = true;
+			errorType = ERROR_TBL_NOT_EXISTS;
+			errorContainerName = tName;
+		}
+		else if( !locks.lockTable( currentDatabase, dbms[ dbReturn ].databaseTable[ tblReturn ].tableName, LOCK_EXCLUSIVE ) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_LOCKED;
+			errorContainerName = tName;
+		}
+		else
+		{
+			dbms[ dbReturn ].databaseTable[ tblReturn ].tableAnalyze( currentWorkingDirectory, currentDatabase );
+		}
+	}
+	else if( actionType.compare( REFRESH ) == 0 )
+	{
+		//REFRESH MATERIALIZED VIEW name runs the select of a view again
+		temp = getNextWord( input );
+		convertToUC( temp );
+		containerType = getNextWord( input );
+		convertToUC( containerType );
+		Table tblTemp;
+		tblTemp.tableName = getNextWord( input );
+
+		if( !findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			errorExists = true;
+		}
+		else if( temp != MATERIALIZED_TYPE || containerType != VIEW_TYPE )
+		{
+			errorExists = true;
+			errorType = ERROR_INCORRECT_COMMAND;
+			errorContainerName = originalInput;
+		}
+		else if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_NOT_EXISTS;
+			errorContainerName = tblTemp.tableName;
+		}
+		else if( dbms[ dbReturn ].databaseTable[ tblReturn ].viewQuery.empty() )
+		{
+			cout << "-- !Failed to refresh materialized view " << tblTemp.tableName << " because it is not one." << endl;
+		}
+		else
+		{
+			Table &view = dbms[ dbReturn ].databaseTable[ tblReturn ];
+			MaterializedView materialized( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], view );
+			string errorMessage;
+			vector< string > tblNames;
+			bool parsed = materialized.parse( errorMessage );
+			if( parsed )
+			{
+				materialized.getTables( tblNames );
+			}
+
+			if( !transaction.lockTable( locks, currentDatabase, view.tableName, LOCK_INTENT_EXCLUSIVE ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_LOCKED;
+				errorContainerName = view.tableName;
+			}
+			int tblSize = tblNames.size();
+			for( int index = 0; index < tblSize && !errorExists; index++ )
+			{
+				if( !locks.lockTable( currentDatabase, tblNames[ index ], LOCK_INTENT_SHARED ) )
+				{
+					errorExists = true;
+					errorType = ERROR_TBL_LOCKED;
+					errorContainerName = tblNames[ index ];
+				}
+			}
+			if( !errorExists && !lockViews( locks, transaction, currentWorkingDirectory, currentDatabase, dbms[ dbReturn ],
+				view.tableName, hasViews, errorContainerName ) )
+			{
+				errorExists = true;
+				errorType = ERROR_TBL_LOCKED;
+			}
+
+			if( !errorExists && parsed && materialized.refresh( errorMessage ) )
+			{
+				MaterializedView::update( currentWorkingDirectory, currentDatabase, dbms[ dbReturn ], view.tableName, NULL );
+				cout << "-- Materialized view " << view.tableName << " refreshed." << endl;
+			}
+			else if( !errorExists )
+			{
+				cout << "-- !Failed to refresh materialized view " << view.tableName << " because " << errorMessage << "." << endl;
+			}
+		}
+	}
+	else if( actionType.compare( SET ) == 0 )
+	{
+		//SET OUTPUT selects the format query results are outputted in
+		temp = getNextWord( input );
+		convertToUC( temp );
+		string formatName = getNextWord( input );
+		int format = getOutputFormat( formatName );
+
+		if( temp.compare( OUTPUT ) != 0 || format < 0 )
+		{
+			errorExists = true;
+			errorType = ERROR_INCORRECT_COMMAND;
+			errorContainerName = originalInput;
+		}
+		else
+		{
+			outputFormat = format;
+			convertToUC( formatName );
+			cout << "-- Output format set to " << formatName << "." << endl;
+		}
+	}
+	else if( actionType.compare( BEGIN ) == 0 )
+	{
+		//BEGIN [TRANSACTION] buffers the changes of the session until COMMIT
+		temp = getNextWord( input );
+		convertToUC( temp );
+		if( !temp.empty() && temp.compare( TRANSACTION ) != 0 )
+		{
+			errorExists = true;
+			errorType = ERROR_INCORRECT_COMMAND;
+			errorContainerName = originalInput;
+		}
+		else if( transaction.isOpen() )
+		{
+			cout << "-- !Failed to begin transaction because one is open." << endl;
+		}
+		else
+		{
+			transaction.begin();
+			cout << "-- Transaction starts." << endl;
+		}
+	}
+	else if( actionType.compare( COMMIT ) == 0 )
+	{
+		if( !transaction.isOpen() )
+		{
+			cout << "-- !Failed to commit because no transaction is open." << endl;
+		}
+		else if( transaction.commit() )
+		{
+			cout << "-- Transaction committed." << endl;
+		}
+		else
+		{
+			cout << "-- Transaction abort." << endl;
+		}
+	}
+	else if( actionType.compare( ROLLBACK ) == 0 )
+	{
+		if( !transaction.isOpen() )
+		{
+			cout << "-- !Failed to rollback because no transaction is open." << endl;
+		}
+		else
+		{
+			transaction.rollback();
+			cout << "-- Transaction rolled back." << endl;
+		}
+	}
+	else if( actionType.compare( SHOW ) == 0 )
+	{
+		//SHOW STATS outputs the metrics summed over every session
+		temp = getNextWord( input );
+		convertToUC( temp );
+		if( temp.compare( STATS ) != 0 || !input.empty() )
+		{
+			errorExists = true;
+			errorType = ERROR_INCORRECT_COMMAND;
+			errorContainerName = originalInput;
+		}
+		else
+		{
+			vector< string > names;
+			vector< string > values;
+			Metrics::getStatLines( names, values );
+
+			vector< Attribute > attributes( 2 );
+			attributes[ 0 ].attributeName = "metric";
+			attributes[ 0 ].attributeType = "varchar(64)";
+			attributes[ 1 ].attributeName = "value";
+			attributes[ 1 ].attributeType = "varchar(32)";
+			vector< int > columnTypes( 2, VALUE_STRING );
+
+			ResultWriter writer( outputFormat );
+			writer.writeHeader( attributes );
+			Row tuple;
+			int nameSize = names.size();
+			for( int index = 0; index < nameSize; index++ )
+			{
+				tuple.reset( columnTypes );
+				tuple.setValue( 0, names[ index ] );
+				tuple.setValue( 1, values[ index ] );
+				writer.writeRow( tuple );
+			}
+			writer.finish();
 		}
 	}
 	else if( actionType.compare( EXIT ) == 0 )
@@ -843,6 +1463,31 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 		handleError( errorType, actionType, errorContainerName );
 	}
 
+	//a catalog that could not be saved is rebuilt from the directories the
+	//next time the database system starts, or the database is used
+	if( changesCatalog )
+	{
+		Catalog::saveDatabases( currentWorkingDirectory, dbms );
+
+		Database dbTemp;
+		dbTemp.databaseName = currentDatabase;
+		if( databaseExists( dbms, dbTemp, dbReturn ) && dbms[ dbReturn ].tablesLoaded )
+		{
+			Catalog::saveTables( currentWorkingDirectory, dbms[ dbReturn ] );
+		}
+	}
+
+	//a statement that took longer than the threshold is logged with the
+	//records it read, to find the tables worth an index
+	double seconds = clock.elapsed();
+	if( SlowQueryLog::isSlow( seconds ) )
+	{
+		SlowQueryLog::write( originalInput, seconds, clock.getPlan(), clock.rowsScanned(), clock.rowsReturned() );
+	}
+
+	//everything the statement placed in its arena is given back at once
+	statementArena().release();
+
 	return exitProgram;
 }
 
@@ -856,42 +1501,84 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
  * @post returns true if dbExists, false otherwise
  *
  * @par Algorithm 
- *      loop through dbms return true if match is found
+ *      finds the name of dbInput in the index of dbms, in any case
  *      
  * @exception None
  *
  * @param [in] dbms provides vector of dbs
  *
- * @param [in] dbInput provides db to be created
+ * @param [in/out] dbInput provides db to be created, its name is set to
+ *                 the name the database was created with if it exists
+ *
+ * @param [out] dbReturn position of the database in dbms, the size of
+ *              dbms if it does not exist
  *
  * @return bool
  *
  * @note None
  */
-bool databaseExists( vector<Database> dbms, Database dbInput, int &dbReturn )
+bool databaseExists( vector<Database> &dbms, Database &dbInput, int &dbReturn )
 {
-	int size = dbms.size();
-	for( dbReturn = 0; dbReturn < size; dbReturn++ )
+	dbReturn = databaseIndex.find( dbInput.databaseName );
+	if( dbReturn < 0 )
 	{
-		if( caseInsCompare( dbInput.databaseName, dbms[ dbReturn ].databaseName ) )
-		{
-			return true;
-		}
+		dbReturn = dbms.size();
+		return false;
 	}
-	return false;
+	dbInput.databaseName = dbms[ dbReturn ].databaseName;
+	return true;
 }
 
 
 
+/**
+ * @brief findCurrentDatabase
+ *
+ * @details finds the database in use by a statement on its tables
+ *
+ * @param [in] vector< Database > &dbms
+ *
+ * @param [in] string currentDatabase - empty if none was used
+ *
+ * @param [out] int &dbReturn - position of the database in dbms
+ *
+ * @param [out] int &errorType - set if there is no database in use, or it
+ *              was dropped by another session
+ *
+ * @param [out] string &errorContainerName
+ *
+ * @return bool true if found, else false
+ *
+ * @note None
+ */
+bool findCurrentDatabase( vector< Database > &dbms, string currentDatabase, int &dbReturn, int &errorType,
+	string &errorContainerName )
+{
+	Database dbTemp;
+	dbTemp.databaseName = currentDatabase;
+	if( currentDatabase.empty() )
+	{
+		errorType = ERROR_DB_NOT_USED;
+		return false;
+	}
+	if( !databaseExists( dbms, dbTemp, dbReturn ) )
+	{
+		errorType = ERROR_DB_NOT_EXISTS;
+		errorContainerName = currentDatabase;
+		return false;
+	}
+	return true;
+}
 void removeDatabase( vector< Database > &dbms, int index )
 {
+	databaseIndex.remove( dbms[ index ].databaseName );
 	dbms.erase( dbms.begin() + index );
 }
 
 
 void removeTable( vector< Database > &dbms, int dbReturn, int tblReturn )
 {
-	dbms[ dbReturn ].databaseTable.erase( dbms[ dbReturn ].databaseTable.begin() + tblReturn );
+	dbms[ dbReturn ].tableRemove( tblReturn );
 }
 
 /**
@@ -950,6 +1637,30 @@ void handleError( int errorType, string commandError, string errorContainerName
 		cout << "-- !Failed to " << commandError << " table " << errorContainerName;
 		cout << " because it does not exist." << endl;
 	}
+	//if problem is that another session holds a lock on the table
+	else if( errorType == ERROR_TBL_LOCKED )
+	{
+		cout << "-- !Failed to " << commandError << " table " << errorContainerName;
+		cout << " because it is locked." << endl;
+	}
+	//if problem is that the table is a materialized view ( used for insert,
+	//update, delete, alter, drop )
+	else if( errorType == ERROR_TBL_IS_VIEW )
+	{
+		cout << "-- !Failed to " << commandError << " table " << errorContainerName;
+		cout << " because it is a materialized view." << endl;
+	}
+	//if problem is that a materialized view reads the table ( used for drop )
+	else if( errorType == ERROR_TBL_HAS_VIEWS )
+	{
+		cout << "-- !Failed to " << commandError << " table " << errorContainerName;
+		cout << " because a materialized view reads it." << endl;
+	}
+	//if problem is that no database is in use ( used for statements on tables )
+	else if( errorType == ERROR_DB_NOT_USED )
+	{
+		cout << "-- !Failed to " << commandError << " because no database is in use." << endl;
+	}
 	//if problem is that an unrecognized error occurs
 	else if( errorType == ERROR_INCORRECT_COMMAND )
 	{
@@ -1137,6 +1848,81 @@ string getSetCondition( string &input )
 	}
 }
 
+/**
+*@brief void getLimitCondition method
+*
+*@details checks for limit and offset clauses at the end of the query, stores
+*			them in qLimit and removes them from input
+*
+*@par Algorithm repeatedly looks for the last " limit " or " offset " that is
+*			followed only by a number, so the clauses may appear in either order
+*			and words inside a where condition are left alone
+*
+*@param [in] string &input
+*
+*@param [out] QueryLimit &qLimit
+*
+*@return none (void)
+*/
+void getLimitCondition( string &input, QueryLimit &qLimit )
+{
+	string lowerInput = input;
+	convertToLC( lowerInput );
+	bool clauseFound = true;
+
+	qLimit.rowLimit = NO_LIMIT;
+	qLimit.rowOffset = 0;
+
+	while( clauseFound )
+	{
+		clauseFound = false;
+
+		size_t limitOccurance = lowerInput.rfind( " limit " );
+		size_t offsetOccurance = lowerInput.rfind( " offset " );
+		if( limitOccurance != input.npos && isNumber( input.substr( limitOccurance + 7 ) ) )
+		{
+			qLimit.rowLimit = atoi( input.substr( limitOccurance + 7 ).c_str() );
+			input.erase( limitOccurance );
+			lowerInput.erase( limitOccurance );
+			clauseFound = true;
+		}
+		else if( offsetOccurance != input.npos && isNumber( input.substr( offsetOccurance + 8 ) ) )
+		{
+			qLimit.rowOffset = atoi( input.substr( offsetOccurance + 8 ).c_str() );
+			input.erase( offsetOccurance );
+			lowerInput.erase( offsetOccurance );
+			clauseFound = true;
+		}
+	}
+}
+
+/**
+*@brief bool isNumber method
+*
+*@details checks that a string is a non negative integer, ignoring whitespace
+*
+*@param [in] string input
+*
+*@return bool true if input holds only digits
+*/
+bool isNumber( string input )
+{
+	bool digitFound = false;
+	int inputSize = input.size();
+	for( int index = 0; index < inputSize; index++ )
+	{
+		if( isdigit( input[ index ] ) )
+		{
+			digitFound = true;
+		}
+		else if( !isspace( input[ index ] ) )
+		{
+			return false;
+		}
+	}
+	return digitFound;
+}
+
 /**
 *@brief void removeNewLine method
 *
@@ -1190,289 +1976,318 @@ string returnNextWord( string input )
 }
 
 /**
- * @brief checkJoin
- *
- * @details checks for inner join without using inner join keyword
- *          
- * @pre nothing
- *
- * @post returns true if default join
+ * @brief isJoinKeyword
  *
- * @par Algorithm 
- *      parse through the string and find , and return LHS and RHS
- * 
- * @exception None
+ * @details checks if a word is part of a join clause
  *
- * @param [in] string &input
+ * @param [in] string word
  *
- * @return bool
+ * @return bool true for inner, left, outer, join and on
  *
  * @note None
  */
-bool checkJoin( string & input, string &LHS )
+bool isJoinKeyword( string word )
 {
-	//check input for comma
-	size_t found = input.find( ',' );
-	if( found != input.npos )
-	{
-		LHS = input.substr(0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-		return true;
-	}
-	return false;
+	return caseInsCompare( word, "inner" ) || caseInsCompare( word, "left" ) ||
+		caseInsCompare( word, "outer" ) || caseInsCompare( word, "join" ) ||
+		caseInsCompare( word, "on" );
 }
 
-
 /**
- * @brief checkInnerJoin
+ * @brief getJoinTables
  *
- * @details checks that query is inner join
+ * @details parses the tables of a from clause
  *          
- * @pre 
+ * @pre the where condition has been removed from input
  *
- * @post 
+ * @post None
  *
  * @par Algorithm 
- *      parse through the string and look for occurance of inner join and return lhs and rhs
+ *      the tables are separated by commas or by join clauses ( [inner] join,
+ *      left [outer] join ). Each table may be followed by its table variable
+ *      and, after a join clause, by an on condition that runs until the next
+ *      comma or join clause outside of parentheses
  * 
  * @exception None
  *
- * @param [in] string &input
+ * @param [in] string input - everything between from and where
  *
- * @return bool, true if inner join, false otherwise
+ * @param [out] vector< JoinTable > &joinTables - tables in from order
+ *
+ * @return bool false if the from clause is malformed
  *
  * @note None
  */
-bool checkInnerJoin( string & input, string &LHS  )
+bool getJoinTables( string input, vector< JoinTable > &joinTables )
 {
-	bool innerOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
+	vector< string > tokens = tokenizeCondition( input );
+	int tokenSize = tokens.size();
+	int position = 0;
+	int joinType = JOIN_INNER;
+	bool joinClause = false;
+
+	joinTables.clear();
+	while( true )
 	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'i' || input[ index ] == 'I' ) &&
-			( input[ index + 1 ] == 'n' || input[ index + 1 ] == 'N' ) && 
-			( input[ index + 2 ] == 'n' || input[ index + 2 ] == 'N' ) &&
-			( input[ index + 3 ] == 'e' || input[ index + 3] == 'E' ) && 
-			( input[ index + 4 ] == 'r' || input[ index + 4] == 'R' ) &&
-			  input[ index + 5 ] == ' ' &&
-			( input[ index + 6 ] == 'j' || input[ index + 6 ] == 'J' ) && 
-			( input[ index + 7 ] == 'o' || input[ index + 7 ] == 'O' ) &&
-			( input[ index + 8 ] == 'i' || input[ index + 8 ] == 'I' ) && 
-			( input[ index + 9 ] == 'n' || input[ index + 9 ] == 'N' ))
+		if( position >= tokenSize || tokens[ position ] == "," || isJoinKeyword( tokens[ position ] ) )
 		{
-			innerOccurs = true;
-			found = index;
+			return false;
 		}
-	}
 
-	if( innerOccurs )
-	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
+		JoinTable joinTable;
+		joinTable.tableName = tokens[ position ];
+		joinTable.joinType = joinType;
+		joinTable.statistics = NULL;
+		position++;
+		if( position < tokenSize && tokens[ position ] != "," && !isJoinKeyword( tokens[ position ] ) )
+		{
+			joinTable.tableVariable = tokens[ position ];
+			position++;
+		}
 
-		input.erase( 0, found + 10 );
-		removeLeadingWS( input );
-		return true;
+		//on condition of a join clause
+		if( position < tokenSize && caseInsCompare( tokens[ position ], "on" ) )
+		{
+			if( !joinClause )
+			{
+				return false;
+			}
+			position++;
+			int depth = 0;
+			while( position < tokenSize && ( depth > 0 ||
+				( tokens[ position ] != "," && !isJoinKeyword( tokens[ position ] ) ) ) )
+			{
+				if( tokens[ position ] == "(" )
+				{
+					depth++;
+				}
+				else if( tokens[ position ] == ")" )
+				{
+					depth--;
+				}
+				joinTable.onCondition += tokens[ position ] + " ";
+				position++;
+			}
+			if( joinTable.onCondition.empty() )
+			{
+				return false;
+			}
+		}
+		joinTables.push_back( joinTable );
+
+		if( position >= tokenSize )
+		{
+			return true;
+		}
+
+		//separator before the next table
+		joinType = JOIN_INNER;
+		joinClause = false;
+		if( tokens[ position ] == "," )
+		{
+			position++;
+			continue;
+		}
+		if( caseInsCompare( tokens[ position ], "left" ) )
+		{
+			joinType = JOIN_LEFT_OUTER;
+			position++;
+			if( position < tokenSize && caseInsCompare( tokens[ position ], "outer" ) )
+			{
+				position++;
+			}
+		}
+		else if( caseInsCompare( tokens[ position ], "inner" ) )
+		{
+			position++;
+		}
+		if( position >= tokenSize || !caseInsCompare( tokens[ position ], "join" ) )
+		{
+			return false;
+		}
+		joinClause = true;
+		position++;
 	}
-	return false;
 }
 
+
 /**
- * @brief 
+ * @brief lockCatalogChange
  *
- * @details 
- *          
- * @pre 
+ * @details locks the databases and tables a statement changing the catalog
+ *          locks exclusively, without waiting for them holding the catalog
  *
- * @post 
+ * @par Algorithm the names are found as the statement finds them: the
+ *      database of DROP DATABASE, the table of DROP TABLE, DROP
+ *      MATERIALIZED VIEW and ANALYZE, every table of the current database
+ *      for ANALYZE alone, and the tables read by CREATE MATERIALIZED VIEW.
+ *      Each is locked without waiting. If one is held by another session,
+ *      the locks and the catalog are released, its release is waited for,
+ *      and they are taken again, for at most LOCK_WAIT_SECONDS. The
+ *      statement then asks for the same locks and is refused any it does
+ *      not have at once
  *
- * @par Algorithm 
- *     
- * 
- * @exception None
+ * @param [in] ReadWriteGuard &catalog - holding the catalog exclusively,
+ *             and again when this returns
  *
- * @param [in] 
+ * @param [in] StatementLocks &locks
  *
- * @return 
+ * @param [in] vector< Database > &dbms
  *
- * @note None
+ * @param [in] string currentDatabase
+ *
+ * @param [in] string actionType
+ *
+ * @param [in] string input - the statement after its action
+ *
+ * @return None
+ *
+ * @note a name that does not exist is locked all the same
  */
-bool checkOuterJoin( string & input, string &LHS  )
+void lockCatalogChange( ReadWriteGuard &catalog, StatementLocks &locks, vector< Database > &dbms, string currentDatabase,
+	string actionType, string input )
 {
-	bool outerOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
+	string containerType = getNextWord( input );
+	convertToUC( containerType );
+	string dbName;
+	vector< string > tblNames;
 
-	for( int index = 0; index < inputSize; index++ )
+	if( caseInsCompare( actionType, DROP ) && containerType == DATABASE_TYPE )
 	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'l' || input[ index ] == 'L' ) &&
-			( input[ index + 1 ] == 'e' || input[ index + 1 ] == 'E' ) && 
-			( input[ index + 2 ] == 'f' || input[ index + 2 ] == 'F' ) &&
-			( input[ index + 3 ] == 't' || input[ index + 3 ] == 'T' ) && 
-
-			  input[ index + 4 ] == ' ' &&
-
-			( input[ index + 5 ] == 'o' || input[ index + 5 ] == 'O' ) &&
-			( input[ index + 6 ] == 'u' || input[ index + 6 ] == 'U' ) && 
-			( input[ index + 7 ] == 't' || input[ index + 7 ] == 'T' ) &&
-			( input[ index + 8 ] == 'e' || input[ index + 8 ] == 'E' ) && 
-			( input[ index + 9 ] == 'r' || input[ index + 9 ] == 'R' ) &&
-
-			  input[ index + 10 ] == ' ' && 
+		dbName = input;
+	}
+	else if( caseInsCompare( actionType, DROP ) && containerType == TABLE_TYPE )
+	{
+		tblNames.push_back( getNextWord( input ) );
+	}
+	else if( caseInsCompare( actionType, DROP ) && containerType == MATERIALIZED_TYPE )
+	{
+		getNextWord( input );
+		tblNames.push_back( getNextWord( input ) );
+	}
+	else if( caseInsCompare( actionType, ANALYZE ) && !containerType.empty() )
+	{
+		tblNames.push_back( containerType );
+	}
+	else if( caseInsCompare( actionType, CREATE ) && containerType == MATERIALIZED_TYPE )
+	{
+		getNextWord( input );
+		getNextWord( input );
+		getNextWord( input );
+		removeLeadingWS( input );
 
-			( input[ index + 11 ] == 'j' || input[ index + 11 ] == 'J' ) &&
-			( input[ index + 12 ] == 'o' || input[ index + 12 ] == 'O' ) && 
-			( input[ index + 13 ] == 'i' || input[ index + 13 ] == 'I' ) &&
-			( input[ index + 14 ] == 'n' || input[ index + 14 ] == 'N' ))
+		QueryLimit qLimit;
+		getLimitCondition( input, qLimit );
+		getQueryType( input );
+		getWhereCondition( input );
+		vector< JoinTable > joinTables;
+		getJoinTables( input, joinTables );
+		int tableSize = joinTables.size();
+		for( int index = 0; index < tableSize; index++ )
 		{
-			outerOccurs = true;
-			found = index;
+			tblNames.push_back( joinTables[ index ].tableName );
 		}
 	}
-
-	if( outerOccurs )
+	else if( !caseInsCompare( actionType, ANALYZE ) )
 	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 15 );
-		removeLeadingWS( input );
-		return true;
+		return;
 	}
-	return false;
-}
-
 
-/**
- * @brief 
- *
- * @details 
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *     
- * 
- * @exception None
- *
- * @param [in] 
- *
- * @return 
- *
- * @note None
- */
-string getTableVariable( string &input )
-{
-	string tblVar;
-	size_t found = input.find( '.' );
-	if( found != input.npos )
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds( LOCK_WAIT_SECONDS );
+	locks.setWaiting( false );
+	while( true )
 	{
-		tblVar = input.substr( 0, found );
-		removeLeadingWS( tblVar );
+		//every table is analyzed if none is named, as the catalog has them now
+		vector< string > lockNames = tblNames;
+		int dbReturn;
+		int errorType;
+		string errorContainerName;
+		if( caseInsCompare( actionType, ANALYZE ) && containerType.empty() &&
+			findCurrentDatabase( dbms, currentDatabase, dbReturn, errorType, errorContainerName ) )
+		{
+			int tblSize = dbms[ dbReturn ].databaseTable.size();
+			for( int index = 0; index < tblSize; index++ )
+			{
+				lockNames.push_back( dbms[ dbReturn ].databaseTable[ index ].tableName );
+			}
+		}
 
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-	}
+		bool granted = dbName.empty() || locks.lockDatabase( dbName, LOCK_EXCLUSIVE );
+		int nameSize = lockNames.size();
+		for( int index = 0; index < nameSize && granted && !currentDatabase.empty(); index++ )
+		{
+			granted = lockNames[ index ].empty() || locks.lockTable( currentDatabase, lockNames[ index ], LOCK_EXCLUSIVE );
+		}
+		if( granted )
+		{
+			return;
+		}
 
-	return tblVar;
+		locks.releaseAll();
+		catalog.unlock();
+		int waitSeconds = chrono::duration_cast< chrono::seconds >( deadline - chrono::steady_clock::now() ).count();
+		bool released = locks.waitForRefused( waitSeconds );
+		catalog.lock();
+		if( !released )
+		{
+			return;
+		}
+	}
 }
 
-
 /**
- * @brief 
+ * @brief lockViews
  *
- * @details 
- *          
- * @pre 
+ * @details locks the materialized views a change of a table reaches, to
+ *          write them, and the other tables they read
  *
- * @post 
+ * @param [in] StatementLocks &locks
  *
- * @par Algorithm 
- *     
- * 
- * @exception None
+ * @param [in] Transaction &transaction - the views are written in it
  *
- * @param [in] 
+ * @param [in] string currentWorkingDirectory, string currentDatabase
  *
- * @return 
+ * @param [in] Database &database
  *
- * @note None
- */
-string returnLHSJoinComparison( string &input )
-{
-	string LHS;
-	size_t found = input.find( '=' );
-	if ( found != input.npos )
-	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-	}
-	return LHS;
-}
-
-
-/**
- * @brief 
+ * @param [in] string tblName - the table changed, already locked
  *
- * @details 
- *          
- * @pre 
+ * @param [out] bool &hasViews - whether any view reads the table
  *
- * @post 
+ * @param [out] string &lockedName - the table that could not be locked
  *
- * @par Algorithm 
- *     
- * 
- * @exception None
- *
- * @param [in] 
- *
- * @return 
+ * @return bool false if a view or table is locked by another session
  *
  * @note None
  */
-string getOnCondition( string &input )
+bool lockViews( StatementLocks &locks, Transaction &transaction, string currentWorkingDirectory, string currentDatabase,
+	Database &database, string tblName, bool &hasViews, string &lockedName )
 {
-	bool onOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
-	string LHS;
+	vector< string > viewNames;
+	vector< string > readTables;
+	MaterializedView::findDependents( currentWorkingDirectory, currentDatabase, database, tblName, viewNames, readTables );
+	hasViews = !viewNames.empty();
 
-	for( int index = 0; index < inputSize; index++ )
+	int viewSize = viewNames.size();
+	for( int index = 0; index < viewSize; index++ )
 	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'o' || input[ index ] == 'O' ) &&
-			( input[ index + 1 ] == 'n' || input[ index + 1 ] == 'N' ) )
+		if( !transaction.lockTable( locks, currentDatabase, viewNames[ index ], LOCK_INTENT_EXCLUSIVE ) )
 		{
-			onOccurs = true;
-			found = index;
+			lockedName = viewNames[ index ];
+			return false;
 		}
 	}
-
-	if( onOccurs )
+	int readSize = readTables.size();
+	for( int index = 0; index < readSize; index++ )
 	{
-		LHS = input.substr( found + 2, input.size() - 1 );
-		removeLeadingWS( LHS );
-
-		input.erase( found, input.size() - 1 );
-		removeLeadingWS( input );
+		if( !locks.lockTable( currentDatabase, readTables[ index ], LOCK_INTENT_SHARED ) )
+		{
+			lockedName = readTables[ index ];
+			return false;
+		}
 	}
-	return LHS;
+	return true;
 }
 
-
 void removeCarriageReturn( string &input )
 {
 	int strLen = input.length();
@@ -0,0 +1,120 @@
+#!/bin/bash
+# Regression test for the locks between sessions of the server mode. While a
+# transaction writes a table, a write of the same table waits for it until
+# the lock wait times out, a write of another table goes on, and a read sees
+# the table as it was before the transaction. A drop waiting for the table
+# does not stop the other sessions from reading, nor the transaction from
+# committing.
+#
+# Usage: tests/lockConcurrency.sh [path to main], run by make test
+
+MAIN=$( cd "$( dirname "${1:-./main}" )" && pwd )/$( basename "${1:-./main}" )
+WORK=$( mktemp -d )
+SOCKET=$WORK/server.sock
+trap 'kill $SERVER 2> /dev/null; wait $SERVER 2> /dev/null; rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+FAILED=0
+
+fail()
+{
+	echo "-- !lockConcurrency failed, $1"
+	[ -f "$2" ] && cat "$2"
+	FAILED=1
+}
+
+# milliseconds since the phase started
+now()
+{
+	echo $(( $( date +%s%N ) / 1000000 - START ))
+}
+
+# runs a client, its output goes to name.txt and the time it ended to name.end
+session()
+{
+	"$MAIN" --connect "$SOCKET" > "$1.txt"
+	now > "$1.end"
+}
+
+{
+	echo "CREATE DATABASE S;"
+	echo "USE S;"
+	echo "create table T(a int);"
+	echo "create table U(a int);"
+	echo "insert into T values(0);"
+	echo "insert into U values(7);"
+	echo ".EXIT"
+} | "$MAIN" > /dev/null
+
+"$MAIN" --server "$SOCKET" > server.log 2>&1 &
+SERVER=$!
+for wait in $( seq 1 50 ); do
+	[ -S "$SOCKET" ] && break
+	sleep 0.1
+done
+
+# the writer holds T for longer than the lock wait of 10 seconds
+START=$( date +%s%N )
+START=$(( START / 1000000 ))
+{
+	printf 'use S;\nbegin transaction;\ninsert into T values(1);\nselect * from T;\n'
+	sleep 11
+	printf 'commit;\n.exit\n'
+} | session writer &
+WRITER=$!
+sleep 0.5
+printf 'use S;\ninsert into T values(2);\n.exit\n' | session waiter &
+WAITER=$!
+sleep 0.5
+printf 'use S;\nselect * from T;\ninsert into U values(8);\nselect * from U;\n.exit\n' | session reader
+wait $WRITER $WAITER
+
+if [ "$( cat reader.end )" -gt 3000 ]; then
+	fail "reading T and writing U waited for the transaction writing T."
+fi
+if grep -qx -- "-- 1" reader.txt || ! grep -qx -- "-- 0" reader.txt || ! grep -qx -- "-- 8" reader.txt; then
+	fail "the reader did not see T before the transaction or its own write of U:" reader.txt
+fi
+if ! grep -q "because it is locked" waiter.txt || [ "$( cat waiter.end )" -lt 10000 ] \
+	|| [ "$( cat waiter.end )" -gt "$( cat writer.end )" ]; then
+	fail "the write of T did not wait for the transaction until the lock wait timed out:" waiter.txt
+fi
+if ! grep -qx -- "-- 1" writer.txt || ! grep -q "Transaction committed" writer.txt; then
+	fail "the transaction did not see its own write or did not commit:" writer.txt
+fi
+printf 'use S;\nselect * from T;\n.exit\n' | session committed
+if ! grep -qx -- "-- 1" committed.txt || grep -qx -- "-- 2" committed.txt; then
+	fail "the committed records of T are not the transaction's:" committed.txt
+fi
+
+# the drop waits for the transaction, holding the catalog meanwhile would
+# stop the reader and the commit
+START=$( date +%s%N )
+START=$(( START / 1000000 ))
+{
+	printf 'use S;\nbegin transaction;\ninsert into T values(3);\n'
+	sleep 3
+	printf 'commit;\n.exit\n'
+} | session writer &
+WRITER=$!
+sleep 0.5
+printf 'use S;\ndrop table T;\n.exit\n' | session dropper &
+DROPPER=$!
+sleep 0.5
+printf 'use S;\nselect * from U;\n.exit\n' | session reader
+wait $WRITER $DROPPER
+
+if [ "$( cat reader.end )" -gt 2500 ] || ! grep -qx -- "-- 7" reader.txt; then
+	fail "reading U waited for the drop waiting for T:" reader.txt
+fi
+if ! grep -q "Transaction committed" writer.txt || [ "$( cat writer.end )" -gt 5000 ]; then
+	fail "the transaction did not commit while the drop waited:" writer.txt
+fi
+if ! grep -q "Table T deleted" dropper.txt || [ "$( cat dropper.end )" -lt 3000 ]; then
+	fail "the drop did not wait for the transaction writing T:" dropper.txt
+fi
+
+if [ $FAILED -ne 0 ]; then
+	exit 1
+fi
+echo "-- lockConcurrency passed."
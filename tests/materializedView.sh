@@ -0,0 +1,115 @@
+#!/bin/bash
+# Regression test for materialized views: after each insert, update and
+# delete of a table a view reads, and after a transaction rolled back, the
+# view must hold the same records as running its select again. Covers a
+# view over a join brought up to date incrementally, a view over a left
+# outer join run again in full and a view reading another view.
+#
+# Usage: tests/materializedView.sh [path to main], run by make test
+
+MAIN=$( cd "$( dirname "${1:-./main}" )" && pwd )/$( basename "${1:-./main}" )
+WORK=$( mktemp -d )
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+JOINED="select * from Employee E inner join Sales S on E.id = S.employeeID"
+OUTER="select * from Employee E left outer join Sales S on E.id = S.employeeID"
+CASCADED="select name, productID from Employee E inner join Sales S on E.id = S.employeeID where productID > 350"
+FAILED=0
+
+# runs statements in database V of a new session
+run()
+{
+	{
+		echo "use V;"
+		printf '%s\n' "$@"
+		echo ".exit"
+	} | "$MAIN"
+}
+
+# compares a view with its select run again, both between the same
+# statements before and after them, records in any order
+check()
+{
+	local step=$1 view=$2 query=$3 before=$4 after=$5
+
+	run "$before" "select * from $view;" "$after" | sort > view.txt
+	run "$before" "$query;" "$after" | sort > query.txt
+	if ! diff view.txt query.txt > diff.txt; then
+		echo "-- !materializedView failed, $view differs from its select after $step:"
+		cat diff.txt
+		FAILED=1
+	fi
+}
+
+checkAll()
+{
+	check "$1" EmployeeSales "$JOINED" "$2" "$3"
+	check "$1" AllSales "$OUTER" "$2" "$3"
+	check "$1" BigSales "$CASCADED" "$2" "$3"
+}
+
+{
+	echo "CREATE DATABASE V;"
+	echo "USE V;"
+	echo "create table Employee(id int, name varchar(10));"
+	echo "create table Sales(employeeID int, productID int);"
+	echo "insert into Employee values(1,'Joe');"
+	echo "insert into Employee values(2,'Jack');"
+	echo "insert into Employee values(3,'Gill');"
+	echo "insert into Sales values(1,344);"
+	echo "insert into Sales values(1,355);"
+	echo "insert into Sales values(2,544);"
+	echo "create materialized view EmployeeSales as $JOINED;"
+	echo "create materialized view AllSales as $OUTER;"
+	echo "create materialized view BigSales as select name, productID from EmployeeSales where productID > 350;"
+	echo ".exit"
+} | "$MAIN" > /dev/null
+checkAll "creating the views"
+
+run "insert into Employee values(4,'Jill');" > /dev/null
+checkAll "inserting into Employee"
+
+# a second Joe selling the same product gives BigSales a duplicate record
+run "insert into Employee values(5,'Joe');" "insert into Sales values(5,355);" \
+	"insert into Sales values(4,700);" "insert into Sales values(4,700);" > /dev/null
+checkAll "inserting into Sales"
+
+run "update Sales set employeeID = 3 where productID = 544;" > /dev/null
+checkAll "updating Sales"
+
+run "update Employee set name = 'Joan' where id = 1;" > /dev/null
+checkAll "updating Employee"
+
+# removes one of the duplicate records of BigSales, the other one stays
+run "delete from Sales where employeeID = 5;" > /dev/null
+checkAll "deleting from Sales"
+
+run "delete from Employee where id = 3;" > /dev/null
+checkAll "deleting from Employee"
+
+# written inside a transaction the views change for its session only, and
+# rolled back they are as they were before it
+WRITES="begin transaction;
+insert into Employee values(6,'Jim');
+insert into Sales values(6,800);
+update Sales set employeeID = 6 where productID = 700;
+delete from Employee where id = 1;"
+checkAll "writing inside a transaction" "$WRITES" "rollback;"
+
+for view in EmployeeSales AllSales BigSales; do
+	run "select * from $view;" | sort > before.txt
+	run "$WRITES" "rollback;" > /dev/null
+	run "select * from $view;" | sort > after.txt
+	if ! diff before.txt after.txt > diff.txt; then
+		echo "-- !materializedView failed, $view changed by a transaction rolled back:"
+		cat diff.txt
+		FAILED=1
+	fi
+done
+checkAll "rolling back a transaction"
+
+if [ $FAILED -ne 0 ]; then
+	exit 1
+fi
+echo "-- materializedView passed."
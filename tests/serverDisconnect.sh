@@ -0,0 +1,48 @@
+#!/bin/bash
+# Regression test for the server mode: a client that disconnects while its
+# results are still being sent must not stop the output of other sessions.
+#
+# Usage: tests/serverDisconnect.sh [path to main], run by make test
+
+MAIN=$( cd "$( dirname "${1:-./main}" )" && pwd )/$( basename "${1:-./main}" )
+WORK=$( mktemp -d )
+SOCKET=$WORK/server.sock
+trap 'kill $SERVER 2> /dev/null; wait $SERVER 2> /dev/null; rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+# a table big enough that its rows fill the socket while the client is gone
+{
+	echo "CREATE DATABASE S;"
+	echo "USE S;"
+	echo "create table T(a int, b varchar(20));"
+	for row in $( seq 1 3000 ); do
+		echo "insert into T values($row,'value number $row');"
+	done
+	echo ".EXIT"
+} > load.sql
+"$MAIN" < load.sql > /dev/null
+
+"$MAIN" --server "$SOCKET" > server.log 2>&1 &
+SERVER=$!
+for wait in $( seq 1 50 ); do
+	[ -S "$SOCKET" ] && break
+	sleep 0.1
+done
+
+# the client stops reading after the first bytes and is closed mid-result
+{
+	echo "use S;"
+	for query in $( seq 1 200 ); do
+		echo "select * from T;"
+	done
+} > flood.sql
+"$MAIN" --connect "$SOCKET" < flood.sql | head -c 1 > /dev/null
+sleep 1
+
+printf 'use S;\nselect * from T limit 2;\n.exit\n' | "$MAIN" --connect "$SOCKET" > output.txt
+if ! grep -q "^-- 2|value number 2" output.txt; then
+	echo "-- !serverDisconnect failed, the second client got:"
+	cat output.txt
+	exit 1
+fi
+echo "-- serverDisconnect passed."
@@ -0,0 +1,101 @@
+#!/bin/bash
+# Regression test for transactions: a commit stopped between writing the
+# transaction log and publishing it is finished when the program starts
+# again, and a transaction rolled back leaves no trace in the database.
+# SIM_CRASH_AFTER_COMMIT_LOG stops the debug build at that point of a commit.
+#
+# Usage: tests/transactionRecovery.sh [path to main], run by make test
+
+MAIN=$( cd "$( dirname "${1:-./main}" )" && pwd )/$( basename "${1:-./main}" )
+WORK=$( mktemp -d )
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+LOG=DatabaseSystem/.transaction.log
+FAILED=0
+
+fail()
+{
+	echo "-- !transactionRecovery failed, $1"
+	[ -f "$2" ] && cat "$2"
+	FAILED=1
+}
+
+# runs statements in database R of a new session
+run()
+{
+	{
+		echo "use R;"
+		printf '%s\n' "$@"
+		echo ".exit"
+	} | "$MAIN"
+}
+
+# what the tables of database R and its catalog hold
+tables()
+{
+	( cd DatabaseSystem/R && cat * .catalog )
+}
+
+# the files of database R, hidden ones included, and what its tables hold
+snapshot()
+{
+	{ ls -a DatabaseSystem/R; tables; } > "$1"
+}
+
+{
+	echo "CREATE DATABASE R;"
+	echo "USE R;"
+	echo "create table T(a int, b varchar(20));"
+	echo "create table U(a int, b varchar(20));"
+	echo "insert into T values(1,'one');"
+	echo "insert into U values(1,'first');"
+	echo "insert into U values(2,'second');"
+	echo ".exit"
+} | "$MAIN" > /dev/null
+
+# T is appended to and U replaced by its private version, the process stops
+# once the commit is logged
+tables > before.txt
+SIM_CRASH_AFTER_COMMIT_LOG=1 run "begin transaction;" "insert into T values(2,'two');" \
+	"update U set b = 'changed' where a = 1;" "delete from U where a = 2;" "commit;" > /dev/null 2>&1
+tables > stopped.txt
+if [ ! -f "$LOG" ]; then
+	fail "the stopped commit left no transaction log."
+elif ! diff -q before.txt stopped.txt > /dev/null; then
+	fail "the stopped commit was published before it stopped:" stopped.txt
+fi
+
+run "select * from T;" "select * from U;" > recovered.txt
+if ! grep -q "^-- Recovered the last commit" recovered.txt \
+	|| ! grep -q "^-- 2|two" recovered.txt || ! grep -q "^-- 1|changed" recovered.txt \
+	|| grep -q "^-- 2|second" recovered.txt; then
+	fail "the committed records are not there after starting again:" recovered.txt
+fi
+if [ -f "$LOG" ] || ls -a DatabaseSystem/R | grep -q "\.txn"; then
+	fail "starting again left the transaction log or a private version."
+fi
+
+# inserts, updates and deletes rolled back change none of the files
+snapshot before.txt
+run "begin transaction;" "insert into T values(3,'three');" \
+	"update T set b = 'changed' where a = 1;" "delete from U where a = 1;" \
+	"select * from T;" "rollback;" > rolledBack.txt
+snapshot after.txt
+if ! grep -q "^-- 3|three" rolledBack.txt; then
+	fail "the transaction did not see its own records:" rolledBack.txt
+fi
+if ! diff before.txt after.txt > diff.txt || [ -f "$LOG" ]; then
+	fail "the transaction rolled back left a trace:" diff.txt
+fi
+
+run "select * from T;" "select * from U;" > afterRollback.txt
+if grep -q "^-- 3|three" afterRollback.txt || ! grep -q "^-- 1|one" afterRollback.txt \
+	|| ! grep -q "^-- 1|changed" afterRollback.txt; then
+	fail "the records rolled back are seen by the next session:" afterRollback.txt
+fi
+
+if [ $FAILED -ne 0 ]; then
+	exit 1
+fi
+echo "-- transactionRecovery passed."